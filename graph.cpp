@@ -258,6 +258,21 @@ QString Graph::GetCursorLabel(const GraphCursor& cursor) const {
   }
 }
 
+GraphStatistics Graph::GetCursorIntervalStatistics(
+    GraphLine& line,
+    const GraphCursor& cursor1,
+    const GraphCursor& cursor2) const {
+  assert(cursor1.axis_ == horizontal_axis_);
+  assert(cursor2.axis_ == horizontal_axis_);
+
+  if (!line.data_source()) {
+    return GraphStatistics{};
+  }
+
+  auto [x1, x2] = std::minmax(cursor1.position_, cursor2.position_);
+  return line.data_source()->CalculateStatistics(x1, x2);
+}
+
 QString Graph::GetXAxisLabel(double val) const {
   if (horizontal_axis_->range().kind() == GraphRange::TIME) {
     return GetTimeAxisLabel(val, horizontal_axis_->tick_step());
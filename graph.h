@@ -1,6 +1,7 @@
 #pragma once
 
 #include "graph_qt/model/graph_range.h"
+#include "graph_qt/model/graph_statistics.h"
 
 #include <QFrame>
 #include <QPen>
@@ -71,6 +72,13 @@ class Graph : public QFrame {
 
   virtual QString GetCursorLabel(const GraphCursor& cursor) const;
 
+  // Returns the statistics of the `line` points between two cursors of the
+  // horizontal axis. Takes O(log n) if the data source supports statistics
+  // queries.
+  GraphStatistics GetCursorIntervalStatistics(GraphLine& line,
+                                              const GraphCursor& cursor1,
+                                              const GraphCursor& cursor2) const;
+
   // Get horizontal label string. Shall be called only in scope of DrawYAxis().
   virtual QString GetXAxisLabel(double value) const;
 
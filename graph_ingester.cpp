@@ -0,0 +1,36 @@
+#include "graph_qt/graph_ingester.h"
+
+#include <algorithm>
+
+namespace views {
+
+GraphIngester::GraphIngester(size_t capacity, PointIngestionQueue::Sink sink)
+    : queue_{capacity, std::move(sink), [this] {
+               // Called on a producer thread.
+               QMetaObject::invokeMethod(
+                   &timer_, [this] { ScheduleDrain(); }, Qt::QueuedConnection);
+             }} {
+  timer_.setSingleShot(true);
+  QObject::connect(&timer_, &QTimer::timeout, [this] { Drain(); });
+}
+
+GraphIngester::~GraphIngester() = default;
+
+void GraphIngester::ScheduleDrain() {
+  if (timer_.isActive()) {
+    return;
+  }
+
+  auto delay = frame_interval_;
+  if (last_drain_time_.isValid()) {
+    delay -= std::chrono::milliseconds{last_drain_time_.elapsed()};
+  }
+  timer_.start(std::max(delay, std::chrono::milliseconds::zero()));
+}
+
+void GraphIngester::Drain() {
+  last_drain_time_.start();
+  queue_.Drain();
+}
+
+}  // namespace views
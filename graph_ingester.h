@@ -0,0 +1,46 @@
+#pragma once
+
+#include "graph_qt/model/point_ingestion_queue.h"
+
+#include <QElapsedTimer>
+#include <QTimer>
+#include <chrono>
+
+namespace views {
+
+// Ingestion front-end for data sources fed from acquisition threads. Points
+// are pushed from any thread into a lock-free queue, and drained into the
+// sink on the thread owning the ingester, at most once per frame. The sink
+// typically appends the whole batch to a data source, which then sends a
+// single notification instead of one per point.
+//
+// Producers must stop pushing before the ingester is destroyed.
+class GraphIngester {
+ public:
+  GraphIngester(size_t capacity, PointIngestionQueue::Sink sink);
+  ~GraphIngester();
+
+  // Thread-safe. Returns false if the queue is full and the point is dropped.
+  bool Push(const GraphPoint& point) { return queue_.Push(point); }
+
+  uint64_t dropped_count() const { return queue_.dropped_count(); }
+
+  std::chrono::milliseconds frame_interval() const { return frame_interval_; }
+  void set_frame_interval(std::chrono::milliseconds interval) {
+    frame_interval_ = interval;
+  }
+
+ private:
+  void ScheduleDrain();
+  void Drain();
+
+  // Drains no earlier than a frame interval after the previous drain.
+  QTimer timer_;
+  QElapsedTimer last_drain_time_;
+  std::chrono::milliseconds frame_interval_{16};
+
+  // Declared after the timer used by its wake-up callback.
+  PointIngestionQueue queue_;
+};
+
+}  // namespace views
@@ -0,0 +1,70 @@
+#include "graph_qt/graph_ingester.h"
+
+#include "graph_qt/model/pyramid_data_source.h"
+
+#include <gmock/gmock.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <thread>
+#include <vector>
+
+namespace views {
+
+namespace {
+
+class CountingObserver : public GraphDataSource::Observer {
+ public:
+  void OnDataSourcePointsAppended() override { ++points_appended_count; }
+
+  int points_appended_count = 0;
+};
+
+}  // namespace
+
+TEST(GraphIngesterTest, DrainsProducerThreadsInBatches) {
+  const int kProducerCount = 4;
+  const int kPointCount = 1000;
+
+  PyramidDataSource data_source;
+  CountingObserver observer;
+  data_source.SetObserver(&observer);
+
+  // Producers interleave on the time axis, so the sink sorts the batch.
+  std::vector<GraphPoint> sorted_batch;
+  GraphIngester ingester{
+      kProducerCount * kPointCount, [&](std::span<const GraphPoint> points) {
+        sorted_batch.assign(points.begin(), points.end());
+        std::ranges::sort(sorted_batch, {}, &GraphPoint::x);
+        data_source.AddPoints(sorted_batch);
+      }};
+
+  std::vector<std::thread> producers;
+  for (int producer = 0; producer < kProducerCount; ++producer) {
+    producers.emplace_back([&ingester, producer] {
+      for (int i = 0; i < kPointCount; ++i) {
+        ingester.Push({static_cast<double>(i * kProducerCount + producer), 0});
+      }
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+
+  QElapsedTimer timer;
+  timer.start();
+  while (data_source.size() < kProducerCount * kPointCount &&
+         timer.elapsed() < 5000) {
+    QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+  }
+
+  // The producers finished before the events were processed, so all points
+  // were drained in one batch with a single notification.
+  EXPECT_EQ(data_source.size(), kProducerCount * kPointCount);
+  EXPECT_EQ(ingester.dropped_count(), 0u);
+  EXPECT_EQ(observer.points_appended_count, 1);
+
+  data_source.SetObserver(nullptr);
+}
+
+}  // namespace views
@@ -2,11 +2,18 @@
 
 #include "graph_qt/graph.h"
 #include "graph_qt/graph_axis.h"
+#include "graph_qt/graph_line_painter.h"
 #include "graph_qt/graph_plot.h"
 #include "graph_qt/model/graph_data_source.h"
+#include "graph_qt/model/graph_downsampling.h"
+#include "graph_qt/model/point_enumerators.h"
 
 #include <QPainter>
+#include <algorithm>
 #include <cfloat>
+#include <cmath>
+#include <optional>
+#include <ranges>
 
 namespace views {
 
@@ -48,6 +55,9 @@ void GraphLine::SetDataSource(GraphDataSource* data_source) {
     data_source_->SetObserver(this);
   }
 
+  InvalidateDownsampledPoints();
+  live_range_.reset();
+
   SetCurrentValue(data_source_ ? data_source_->GetCurrentValue()
                                : kGraphUnknownValue);
 
@@ -83,54 +93,69 @@ void GraphLine::Draw(QPainter& painter, const QRect& rect) {
 
   QBrush brush(color_);
 
-  GraphPoint value;
-  auto point_enum = data_source_->EnumPoints(x1, x2, true, true);
-  if (point_enum && point_enum->EnumNext(value)) {
-    // select pen
-    QPen solid_pen(brush, line_weight_);
-    QPen dash_pen(brush, 1, Qt::DotLine);
+  // The value range covered by one pixel column.
+  double resolution = XToValue(rect.x() + 1) - x1;
+
+  std::unique_ptr<PointEnumerator> point_enum;
+  if (band_shown() && DrawQuantileBand(painter, rect, x1, x2, resolution)) {
+    // The band replaces the points.
+  } else if (downsampling_ == DOWNSAMPLING_LTTB) {
+    point_enum = std::make_unique<SpanPointEnumerator>(
+        GetDownsampledPoints(x1, x2, rect.width()));
+  } else if (stepped() &&
+             (!dots_shown() ||
+              data_source_->CountPoints(x1, x2, true, true).value_or(0) >
+                  static_cast<size_t>(rect.width()))) {
+    // Runs of equal values draw as one step. Dots need every point, unless
+    // there are more points than pixel columns and the dots overlap anyway.
+    point_enum = data_source_->EnumSteppedPoints(x1, x2, resolution);
+  } else {
+    point_enum = data_source_->EnumReducedPoints(x1, x2, resolution);
+  }
 
+  if (point_enum) {
     // Draw points.
 
-    QPoint last_point(ValueToX(value.x), ValueToY(value.y));
-    painter.setPen(value.good ? solid_pen : dash_pen);
-
-    while (point_enum->EnumNext(value)) {
-      // current point
-      QPoint point(ValueToX(value.x), ValueToY(value.y));
-      /*if (smooth()) {
-        PolyBezierTo(canvas->native_canvas(), &pt, 1);
-      } else*/
-      {
-        if (stepped()) {
-          QPoint corner_point(point.x(), last_point.y());
-          painter.drawLine(last_point, corner_point);
-          painter.drawLine(corner_point, point);
-        } else {
-          painter.drawLine(last_point, point);
+    GraphLinePainter line_painter{painter, color_, line_weight_};
+    std::optional<QPoint> last_point;
+
+    ForEachColumns(*point_enum, [&](const PointColumnSpans& columns) {
+      for (size_t i = 0; i < columns.size(); ++i) {
+        // current point
+        QPoint point(ValueToX(columns.x[i]), ValueToY(columns.y[i]));
+
+        if (last_point) {
+          /*if (smooth()) {
+            PolyBezierTo(canvas->native_canvas(), &pt, 1);
+          } else*/
+          {
+            if (stepped()) {
+              QPoint corner_point(point.x(), last_point->y());
+              line_painter.DrawLine(*last_point, corner_point);
+              line_painter.DrawLine(corner_point, point);
+            } else {
+              line_painter.DrawLine(*last_point, point);
+            }
+          }
+
+          // Draw dot on previous point (current draw on current as it will
+          // overlap line).
+          if (dots_shown()) {
+            line_painter.DrawDot(*last_point);
+          }
         }
-      }
 
-      // Draw dot on previous point (current draw on current as it will overlap
-      // line).
-      if (dots_shown()) {
-        QRect dot_rect(last_point.x() - line_weight_,
-                       last_point.y() - line_weight_, line_weight_ * 2 + 1,
-                       line_weight_ * 2 + 1);
-        painter.fillRect(dot_rect, color_);
+        line_painter.SetSolid(columns.good(i));
+        last_point = point;
       }
-
-      painter.setPen(value.good ? solid_pen : dash_pen);
-      last_point = point;
-    }
+    });
 
     // Draw last dot.
-    if (dots_shown()) {
-      QRect dot_rect(last_point.x() - line_weight_,
-                     last_point.y() - line_weight_, line_weight_ * 2 + 1,
-                     line_weight_ * 2 + 1);
-      painter.fillRect(dot_rect, color_);
+    if (last_point && dots_shown()) {
+      line_painter.DrawDot(*last_point);
     }
+
+    line_painter.Flush();
   }
 
   QPen limits_pen(brush, 1, Qt::DashLine);
@@ -191,9 +216,54 @@ GraphRange GraphLine::CalculateVerticalAutoRange() {
   double x1 = XToValue(0);
   double x2 = XToValue(plot().width());
 
+  if (auto range = data_source_->QueryVerticalRange(x1, x2)) {
+    return *range;
+  }
+
+  // Live following moves the range forward, so it's updated incrementally.
+  if (plot().graph().horizontal_axis().time_fit()) {
+    return CalculateLiveAutoRange(x1, x2);
+  }
+
+  live_range_.reset();
   return data_source_->CalculateAutoRange(x1, x2);
 }
 
+GraphRange GraphLine::CalculateLiveAutoRange(double x1, double x2) {
+  // Sources of fixed capacity evict points that may still be on screen.
+  if (auto range = data_source_->GetHorizontalRange(); !range.empty()) {
+    x1 = std::max(x1, range.low());
+  }
+
+  if (!live_range_ || x1 < live_range_->from() || x2 < live_range_->to()) {
+    live_range_.emplace(x1);
+  }
+
+  // The window's right bound lies past the newest point, so enumeration
+  // resumes right after the last pushed point rather than at `to()`. Points
+  // appended with the same x as the last pushed point follow the ones pushed
+  // before. Points before `x1` would be evicted right away.
+  auto last_x = live_range_->last_x();
+  bool resume = last_x && *last_x >= x1;
+  double from = resume ? *last_x : x1;
+  size_t skip_count = resume ? live_range_->last_x_count() : 0;
+  if (auto point_enum = data_source_->EnumPoints(from, x2, true, false)) {
+    ForEachPoint(*point_enum, [&](const GraphPoint& point) {
+      if (point.x < from || point.x >= x2) {
+        return;
+      }
+      if (skip_count != 0 && point.x == from) {
+        --skip_count;
+        return;
+      }
+      live_range_->Push(point);
+    });
+  }
+
+  live_range_->Slide(x1, x2);
+  return live_range_->GetRange();
+}
+
 bool GraphLine::GetNearestPoint(const QPoint& screen_point,
                                 GraphPoint& data_point,
                                 int max_distance) {
@@ -205,30 +275,31 @@ bool GraphLine::GetNearestPoint(const QPoint& screen_point,
   double x1 = XToValue(0);
   double x2 = XToValue(plot().width());
 
-  auto point_enum = data_source_->EnumPoints(x1, x2, true, false);
+  // Downsampled lines search among the drawn points.
+  auto point_enum =
+      downsampling_ != DOWNSAMPLING_NONE && downsampling_cache_.valid
+          ? std::make_unique<SpanPointEnumerator>(downsampling_cache_.points)
+          : data_source_->EnumPoints(x1, x2, true, false);
   if (!point_enum) {
     return false;
   }
 
-  GraphPoint point;
-  if (!point_enum->EnumNext(point)) {
-    return false;
-  }
-
-  QPoint p(ValueToX(point.x), ValueToY(point.y));
-  int min_distance = CalcPointDistance(p, screen_point);
-  data_point = point;
+  std::optional<int> min_distance;
 
-  while (point_enum->EnumNext(point)) {
+  ForEachPoint(*point_enum, [&](const GraphPoint& point) {
     QPoint p(ValueToX(point.x), ValueToY(point.y));
     int distance = CalcPointDistance(p, screen_point);
-    if (distance < min_distance) {
+    if (!min_distance || distance < *min_distance) {
       data_point = point;
       min_distance = distance;
     }
+  });
+
+  if (!min_distance) {
+    return false;
   }
 
-  return min_distance <= max_distance;
+  return *min_distance <= max_distance;
 }
 
 void GraphLine::SetVerticalRange(const GraphRange& range) {
@@ -237,6 +308,28 @@ void GraphLine::SetVerticalRange(const GraphRange& range) {
 }
 
 void GraphLine::AdjustHorizontalRange(GraphRange& range) const {
+  // The downsampled point count doesn't depend on the range.
+  if (downsampling_ != DOWNSAMPLING_NONE) {
+    return;
+  }
+
+  // Both bounds are excluded. `last` is the index after the last point before
+  // `high`.
+  auto first = data_source_->UpperBound(range.low());
+  auto last = data_source_->LowerBound(range.high());
+  if (first && last) {
+    if (*last <= *first || *last - *first <= kMaxPoints) {
+      return;
+    }
+
+    // The low bound is excluded, so it is set to the point preceding the last
+    // `kMaxPoints` points.
+    if (auto low = data_source_->GetPointX(*last - kMaxPoints - 1)) {
+      range.low_ = *low;
+      return;
+    }
+  }
+
   {
     auto points =
         data_source_->EnumPoints(range.low(), range.high(), false, false);
@@ -245,7 +338,8 @@ void GraphLine::AdjustHorizontalRange(GraphRange& range) const {
     }
   }
 
-  // Binary search for low bound to keep kMaxPoints points.
+  // The data source doesn't support index queries. Binary search for low
+  // bound to keep kMaxPoints points.
 
   double min = range.low_;
   double max = range.high_;
@@ -282,6 +376,8 @@ void GraphLine::SetVerticalRangeHelper(const GraphRange& range) {
 }
 
 void GraphLine::OnDataSourceItemChanged() {
+  InvalidateDownsampledPoints();
+  live_range_.reset();
   UpdateHorizontalRange();
   UpdateVerticalRange();
 
@@ -292,6 +388,12 @@ void GraphLine::OnDataSourceItemChanged() {
 }
 
 void GraphLine::OnDataSourceHistoryChanged() {
+  live_range_.reset();
+  OnDataSourcePointsAppended();
+}
+
+void GraphLine::OnDataSourcePointsAppended() {
+  InvalidateDownsampledPoints();
   UpdateHorizontalRange();
   UpdateVerticalRange();
 
@@ -333,6 +435,109 @@ void GraphLine::SetColor(const QColor& color) {
   }
 }
 
+void GraphLine::SetDownsampling(Downsampling downsampling, double density) {
+  assert(density > 0);
+
+  if (downsampling_ == downsampling && downsampling_density_ == density) {
+    return;
+  }
+
+  downsampling_ = downsampling;
+  downsampling_density_ = density;
+  InvalidateDownsampledPoints();
+
+  if (plot_) {
+    plot_->update();
+  }
+}
+
+bool GraphLine::DrawQuantileBand(QPainter& painter,
+                                 const QRect& rect,
+                                 double from,
+                                 double to,
+                                 double resolution) {
+  // Zoomed in, the points themselves are more informative.
+  auto count = data_source_->CountPoints(from, to, true, true);
+  if (count && *count <= static_cast<size_t>(rect.width())) {
+    return false;
+  }
+
+  auto bands =
+      data_source_->QueryQuantileBands(from, to, resolution, band_quantile_);
+  if (!bands) {
+    return false;
+  }
+
+  if (bands->empty()) {
+    return true;
+  }
+
+  // Ribbon along the high values forward and the low values backward.
+  std::vector<QPoint> ribbon;
+  ribbon.reserve(bands->size() * 2);
+  for (const auto& band : *bands) {
+    ribbon.emplace_back(ValueToX(band.x), ValueToY(band.high));
+  }
+  for (const auto& band : *bands | std::views::reverse) {
+    ribbon.emplace_back(ValueToX(band.x), ValueToY(band.low));
+  }
+
+  QColor ribbon_color = color_;
+  ribbon_color.setAlpha(ribbon_color.alpha() / 4);
+
+  painter.save();
+  painter.setPen(Qt::NoPen);
+  painter.setBrush(ribbon_color);
+  painter.drawPolygon(ribbon.data(), static_cast<int>(ribbon.size()));
+  painter.restore();
+
+  GraphLinePainter line_painter{painter, color_, line_weight_};
+  line_painter.SetSolid(true);
+  std::optional<QPoint> last_point;
+  for (const auto& band : *bands) {
+    QPoint point(ValueToX(band.x), ValueToY(band.median));
+    if (last_point) {
+      line_painter.DrawLine(*last_point, point);
+    }
+    last_point = point;
+  }
+  line_painter.Flush();
+
+  return true;
+}
+
+const std::vector<GraphPoint>& GraphLine::GetDownsampledPoints(double from,
+                                                               double to,
+                                                               int width) {
+  assert(data_source_);
+
+  size_t threshold = static_cast<size_t>(
+      std::max(3.0, std::ceil(width * downsampling_density_)));
+
+  auto& cache = downsampling_cache_;
+  if (cache.valid && cache.from == from && cache.to == to &&
+      cache.threshold == threshold) {
+    return cache.points;
+  }
+
+  cache.points.clear();
+  if (auto point_enum = data_source_->EnumPoints(from, to, true, true)) {
+    cache.points = DownsampleLttb(*point_enum, threshold);
+  }
+
+  cache.from = from;
+  cache.to = to;
+  cache.threshold = threshold;
+  cache.valid = true;
+
+  return cache.points;
+}
+
+void GraphLine::InvalidateDownsampledPoints() {
+  downsampling_cache_.valid = false;
+  downsampling_cache_.points.clear();
+}
+
 GraphRange GraphLine::GetHorizontalRange() const {
   return data_source_ ? data_source_->GetHorizontalRange() : GraphRange{};
 }
@@ -2,9 +2,12 @@
 
 #include "graph_qt/model/graph_data_source.h"
 #include "graph_qt/model/graph_range.h"
+#include "graph_qt/model/sliding_window_range.h"
 
 #include <QColor>
 #include <cassert>
+#include <optional>
+#include <vector>
 
 class QPainter;
 class QPen;
@@ -14,10 +17,17 @@ class QRect;
 namespace views {
 
 class GraphPlot;
-struct GraphPoint;
 
 class GraphLine : protected GraphDataSource::Observer {
  public:
+  enum Downsampling {
+    // Draws the points provided by the data source.
+    DOWNSAMPLING_NONE,
+    // Draws the points selected by the Largest-Triangle-Three-Buckets
+    // algorithm.
+    DOWNSAMPLING_LTTB,
+  };
+
   GraphLine();
   virtual ~GraphLine();
 
@@ -37,11 +47,27 @@ class GraphLine : protected GraphDataSource::Observer {
   bool auto_range() const { return (flags_ & AUTO_RANGE) != 0; }
   bool dots_shown() const { return (flags_ & SHOW_DOTS) != 0; }
   bool smooth() const { return (flags_ & SMOOTH) != 0; }
+  // Zoomed out lines are drawn as a quantile band with a median line if the
+  // data source supports quantile band queries.
+  bool band_shown() const { return (flags_ & SHOW_BAND) != 0; }
 
   void set_auto_range(bool auto_range) { set_flag(AUTO_RANGE, auto_range); }
   void set_dots_shown(bool shown) { set_flag(SHOW_DOTS, shown); }
   void set_stepped(bool stepped) { set_flag(STEPPED, stepped); }
   void set_smooth(bool smooth) { set_flag(SMOOTH, smooth); }
+  void set_band_shown(bool shown) { set_flag(SHOW_BAND, shown); }
+
+  // The band spans the values from `quantile` to `1 - quantile`.
+  double band_quantile() const { return band_quantile_; }
+  void set_band_quantile(double quantile) {
+    assert(quantile >= 0 && quantile <= 0.5);
+    band_quantile_ = quantile;
+  }
+
+  Downsampling downsampling() const { return downsampling_; }
+  double downsampling_density() const { return downsampling_density_; }
+  // The `density` is the number of points drawn per pixel of the line width.
+  void SetDownsampling(Downsampling downsampling, double density = 1.0);
 
   const GraphRange& vertical_range() const { return vertical_range_; }
   void SetVerticalRange(const GraphRange& range);
@@ -51,7 +77,9 @@ class GraphLine : protected GraphDataSource::Observer {
   double current_value() const { return current_value_; }
 
   // Shrinks the horizontal range by advancing the `low_` bound, so only the
-  // `kMaxPoints` amount of points is displayed.
+  // `kMaxPoints` amount of points is displayed. Uses the data source index
+  // queries when supported and falls back to a binary search otherwise.
+  // Downsampled lines show any range.
   void AdjustHorizontalRange(GraphRange& range) const;
 
   double XToValue(int x) const;
@@ -74,6 +102,7 @@ class GraphLine : protected GraphDataSource::Observer {
   // GraphDataSource::Observer
   void OnDataSourceItemChanged() override;
   void OnDataSourceHistoryChanged() override;
+  void OnDataSourcePointsAppended() override;
   void OnDataSourceCurrentValueChanged() override;
 
  private:
@@ -83,12 +112,37 @@ class GraphLine : protected GraphDataSource::Observer {
     AUTO_RANGE = 0x0002,
     SHOW_DOTS = 0x0004,
     SMOOTH = 0x0008,
+    SHOW_BAND = 0x0010,
   };
 
+  // Points selected for drawing in downsampling mode. Cached against the
+  // visible range, so repaints of the same range reuse them.
+  struct DownsamplingCache {
+    double from = 0.0;
+    double to = 0.0;
+    size_t threshold = 0;
+    bool valid = false;
+    std::vector<GraphPoint> points;
+  };
+
+  // Returns false if the band isn't drawn as there are few points or the data
+  // source doesn't support quantile bands.
+  bool DrawQuantileBand(QPainter& painter,
+                        const QRect& rect,
+                        double from,
+                        double to,
+                        double resolution);
+
+  const std::vector<GraphPoint>& GetDownsampledPoints(double from,
+                                                      double to,
+                                                      int width);
+  void InvalidateDownsampledPoints();
+
   void UpdateHorizontalRange();
 
   void UpdateVerticalRange();
   GraphRange CalculateVerticalAutoRange();
+  GraphRange CalculateLiveAutoRange(double x1, double x2);
   void SetVerticalRangeHelper(const GraphRange& range);
 
   void set_flag(int flag, bool set) {
@@ -114,6 +168,15 @@ class GraphLine : protected GraphDataSource::Observer {
   unsigned flags_ = STEPPED | AUTO_RANGE | SHOW_DOTS;
   int line_weight_ = 1;
 
+  Downsampling downsampling_ = DOWNSAMPLING_NONE;
+  double downsampling_density_ = 1.0;
+  double band_quantile_ = 0.05;
+  DownsamplingCache downsampling_cache_;
+
+  // Auto-range of the visible window while the horizontal axis follows live
+  // data. Kept across appends and reset on any other history change.
+  std::optional<SlidingWindowRange> live_range_;
+
   friend class Graph;
   friend class GraphPlot;
 };
@@ -0,0 +1,143 @@
+#include "graph_qt/graph_line_painter.h"
+
+#include <QPainter>
+#include <algorithm>
+
+namespace views {
+
+GraphLinePainter::GraphLinePainter(QPainter& painter,
+                                   const QColor& color,
+                                   int line_weight)
+    : painter_{painter},
+      color_{color},
+      line_weight_{line_weight},
+      solid_pen_{QBrush{color}, static_cast<qreal>(line_weight)},
+      dash_pen_{QBrush{color}, 1, Qt::DotLine},
+      merging_{color.alpha() == 255 &&
+               !painter.testRenderHint(QPainter::Antialiasing)} {}
+
+GraphLinePainter::~GraphLinePainter() {
+  Flush();
+}
+
+void GraphLinePainter::DrawLine(const QPoint& from, const QPoint& to) {
+  if (!merging_ || from.x() != to.x()) {
+    SetPen(solid_ ? solid_pen_ : dash_pen_);
+    painter_.drawLine(from, to);
+    return;
+  }
+
+  MoveToColumn(from.x());
+
+  if (!solid_) {
+    Span segment{from.y(), to.y()};
+    if (dotted_segments_.empty() || dotted_segments_.back() != segment) {
+      dotted_segments_.push_back(segment);
+    }
+    return;
+  }
+
+  Span span = std::minmax(from.y(), to.y());
+  if (!solid_spans_.empty() && span.first <= solid_spans_.back().second &&
+      span.second >= solid_spans_.back().first) {
+    auto& last_span = solid_spans_.back();
+    last_span.first = std::min(last_span.first, span.first);
+    last_span.second = std::max(last_span.second, span.second);
+  } else {
+    solid_spans_.push_back(span);
+  }
+}
+
+void GraphLinePainter::DrawDot(const QPoint& point) {
+  if (!merging_) {
+    FillDot(point.x(), point.y(), point.y());
+    return;
+  }
+
+  MoveToColumn(point.x());
+
+  if (dot_ys_.empty() || dot_ys_.back() != point.y()) {
+    dot_ys_.push_back(point.y());
+  }
+}
+
+void GraphLinePainter::MoveToColumn(int x) {
+  if (has_column_ && column_x_ == x) {
+    return;
+  }
+
+  Flush();
+
+  has_column_ = true;
+  column_x_ = x;
+}
+
+void GraphLinePainter::Flush() {
+  if (!has_column_) {
+    return;
+  }
+
+  has_column_ = false;
+
+  // Spans overlapping each other are merged. Touching spans are drawn
+  // separately, as a single-pixel span may be drawn differently than a part
+  // of a longer one.
+  if (!solid_spans_.empty()) {
+    SetPen(solid_pen_);
+    std::ranges::sort(solid_spans_);
+    Span span = solid_spans_.front();
+    for (const auto& next_span : solid_spans_) {
+      if (next_span.first <= span.second) {
+        span.second = std::max(span.second, next_span.second);
+      } else {
+        painter_.drawLine(column_x_, span.first, column_x_, span.second);
+        span = next_span;
+      }
+    }
+    painter_.drawLine(column_x_, span.first, column_x_, span.second);
+    solid_spans_.clear();
+  }
+
+  if (!dotted_segments_.empty()) {
+    SetPen(dash_pen_);
+    std::ranges::sort(dotted_segments_);
+    auto [first, last] = std::ranges::unique(dotted_segments_);
+    dotted_segments_.erase(first, last);
+    for (const auto& [from_y, to_y] : dotted_segments_) {
+      painter_.drawLine(column_x_, from_y, column_x_, to_y);
+    }
+    dotted_segments_.clear();
+  }
+
+  // Dots are filled rectangles, so the touching ones are merged as well.
+  if (!dot_ys_.empty()) {
+    std::ranges::sort(dot_ys_);
+    int top = dot_ys_.front();
+    int bottom = top;
+    for (int y : dot_ys_) {
+      if (y - bottom > line_weight_ * 2 + 1) {
+        FillDot(column_x_, top, bottom);
+        top = y;
+      }
+      bottom = y;
+    }
+    FillDot(column_x_, top, bottom);
+    dot_ys_.clear();
+  }
+}
+
+void GraphLinePainter::SetPen(const QPen& pen) {
+  if (current_pen_ != &pen) {
+    painter_.setPen(pen);
+    current_pen_ = &pen;
+  }
+}
+
+void GraphLinePainter::FillDot(int x, int top, int bottom) {
+  // Fills the dots centered at `x` and every y in `[top, bottom]`.
+  QRect rect(x - line_weight_, top - line_weight_, line_weight_ * 2 + 1,
+             bottom - top + line_weight_ * 2 + 1);
+  painter_.fillRect(rect, color_);
+}
+
+}  // namespace views
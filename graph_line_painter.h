@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QColor>
+#include <QPen>
+#include <utility>
+#include <vector>
+
+class QPainter;
+class QPoint;
+
+namespace views {
+
+// Draws the segments and dots of a graph line. When the result doesn't depend
+// on overdraw (opaque color, no antialiasing), the primitives falling into one
+// pixel column are collected and drawn once the line leaves the column:
+// overlapping vertical solid segments are merged into single spans, and
+// repeated dotted segments and dots are drawn once. The result is
+// pixel-identical to drawing every primitive, while the painter load is
+// bounded by the widget size instead of the point count.
+class GraphLinePainter {
+ public:
+  GraphLinePainter(QPainter& painter, const QColor& color, int line_weight);
+  ~GraphLinePainter();
+
+  GraphLinePainter(const GraphLinePainter&) = delete;
+  GraphLinePainter& operator=(const GraphLinePainter&) = delete;
+
+  // Selects the solid pen for the following segments, or the dotted one.
+  void SetSolid(bool solid) { solid_ = solid; }
+
+  void DrawLine(const QPoint& from, const QPoint& to);
+  void DrawDot(const QPoint& point);
+
+  // Draws the collected primitives.
+  void Flush();
+
+ private:
+  // Vertical extent in pixels, both bounds included.
+  using Span = std::pair<int, int>;
+
+  void MoveToColumn(int x);
+  void SetPen(const QPen& pen);
+  void FillDot(int x, int top, int bottom);
+
+  QPainter& painter_;
+  const QColor color_;
+  const int line_weight_;
+  const QPen solid_pen_;
+  const QPen dash_pen_;
+  const bool merging_;
+
+  bool solid_ = true;
+  const QPen* current_pen_ = nullptr;
+
+  // The column being collected.
+  bool has_column_ = false;
+  int column_x_ = 0;
+  std::vector<Span> solid_spans_;
+  // Dotted segments keep their direction, as the dot pattern starts at the
+  // first point.
+  std::vector<Span> dotted_segments_;
+  std::vector<int> dot_ys_;
+};
+
+}  // namespace views
@@ -0,0 +1,107 @@
+#include "graph_qt/graph_line_painter.h"
+
+#include <gtest/gtest.h>
+
+#include <QImage>
+#include <QPainter>
+#include <random>
+#include <vector>
+
+namespace views {
+namespace {
+
+const int kImageSize = 200;
+const int kLineWeight = 1;
+
+struct Segment {
+  QPoint from;
+  QPoint to;
+  bool solid = true;
+};
+
+// Generates a stepped or straight polyline having many points per column.
+std::vector<Segment> MakeSegments(bool stepped, unsigned seed) {
+  std::mt19937 generator{seed};
+  std::uniform_int_distribution<int> step_distribution{-20, 20};
+  std::bernoulli_distribution next_column_distribution{0.05};
+  std::bernoulli_distribution solid_distribution{0.7};
+
+  std::vector<Segment> segments;
+  QPoint last_point{5, kImageSize / 2};
+  bool solid = true;
+  while (last_point.x() < kImageSize - 5) {
+    int x = last_point.x() + (next_column_distribution(generator) ? 1 : 0);
+    int y = std::clamp(last_point.y() + step_distribution(generator), 0,
+                       kImageSize - 1);
+    QPoint point{x, y};
+    if (stepped) {
+      QPoint corner_point{point.x(), last_point.y()};
+      segments.push_back({last_point, corner_point, solid});
+      segments.push_back({corner_point, point, solid});
+    } else {
+      segments.push_back({last_point, point, solid});
+    }
+    solid = solid_distribution(generator);
+    last_point = point;
+  }
+  return segments;
+}
+
+QImage MakeImage() {
+  QImage image{kImageSize, kImageSize, QImage::Format_RGB32};
+  image.fill(Qt::white);
+  return image;
+}
+
+// Draws every primitive directly.
+QImage DrawDirectly(const std::vector<Segment>& segments, bool dots_shown) {
+  QImage image = MakeImage();
+  QPainter painter{&image};
+  QPen solid_pen{QBrush{Qt::blue}, kLineWeight};
+  QPen dash_pen{QBrush{Qt::blue}, 1, Qt::DotLine};
+  for (const auto& segment : segments) {
+    painter.setPen(segment.solid ? solid_pen : dash_pen);
+    painter.drawLine(segment.from, segment.to);
+    if (dots_shown) {
+      painter.fillRect(QRect(segment.to.x() - kLineWeight,
+                             segment.to.y() - kLineWeight, kLineWeight * 2 + 1,
+                             kLineWeight * 2 + 1),
+                       Qt::blue);
+    }
+  }
+  return image;
+}
+
+QImage DrawWithLinePainter(const std::vector<Segment>& segments,
+                           bool dots_shown) {
+  QImage image = MakeImage();
+  QPainter painter{&image};
+  GraphLinePainter line_painter{painter, Qt::blue, kLineWeight};
+  for (const auto& segment : segments) {
+    line_painter.SetSolid(segment.solid);
+    line_painter.DrawLine(segment.from, segment.to);
+    if (dots_shown) {
+      line_painter.DrawDot(segment.to);
+    }
+  }
+  line_painter.Flush();
+  return image;
+}
+
+}  // namespace
+
+TEST(GraphLinePainterTest, MergedDrawingIsPixelIdentical) {
+  for (bool stepped : {false, true}) {
+    for (bool dots_shown : {false, true}) {
+      for (unsigned seed = 0; seed < 5; ++seed) {
+        auto segments = MakeSegments(stepped, seed);
+        EXPECT_EQ(DrawWithLinePainter(segments, dots_shown),
+                  DrawDirectly(segments, dots_shown))
+            << "stepped=" << stepped << " dots_shown=" << dots_shown
+            << " seed=" << seed;
+      }
+    }
+  }
+}
+
+}  // namespace views
@@ -54,6 +54,20 @@ class TimeTestDataSource : public GraphDataSource {
   std::vector<GraphPoint> points_;
 };
 
+// Counts the stepped enumerations the lines request.
+class SteppedTestDataSource : public TestDataSource {
+ public:
+  std::unique_ptr<PointEnumerator> EnumSteppedPoints(
+      double from,
+      double to,
+      double resolution) override {
+    ++stepped_count;
+    return TestDataSource::EnumSteppedPoints(from, to, resolution);
+  }
+
+  int stepped_count = 0;
+};
+
 // Returns the path to the testdata directory.
 QString GetTestDataPath() {
   // Look for testdata relative to the source directory.
@@ -156,6 +170,29 @@ TEST_F(GraphRenderingTest, BasicGraph) {
   }
 }
 
+TEST_F(GraphRenderingTest, DenseSteppedLineWithDotsSkipsRepeatedValues) {
+  // More points than pixel columns.
+  SteppedTestDataSource data_source;
+  for (int i = 0; i < 1000; ++i) {
+    data_source.AddPoint();
+  }
+
+  Graph graph;
+  auto* pane = graph.AddPane();
+  auto* line = pane->plot().AddLine(data_source);
+  ASSERT_TRUE(line->stepped());
+  ASSERT_TRUE(line->dots_shown());
+
+  graph.horizontal_axis().SetTimeFit(false);
+  graph.horizontal_axis().SetRange(data_source.GetHorizontalRange());
+  RenderWidget(graph);
+
+  EXPECT_GT(data_source.stepped_count, 0);
+
+  // Clean up lines before local data_source is destroyed.
+  pane->plot().DeleteAllLines();
+}
+
 TEST_F(GraphRenderingTest, MultipleLines) {
   // Use different slopes to make lines visually distinct.
   TestDataSource data_source2(0.5, 20.0);  // slope=0.5, y_offset=20
@@ -4,6 +4,7 @@
 #include "graph_qt/graph_line.h"
 #include "graph_qt/graph_pane.h"
 #include "graph_qt/graph_plot.h"
+#include "graph_qt/model/merge_buffer_data_source.h"
 #include "test/test_data_source.h"
 
 #include <gmock/gmock.h>
@@ -253,6 +254,154 @@ TEST_F(GraphTest, HorizontalAxisRange) {
   EXPECT_EQ(graph_.horizontal_axis().range(), range);
 }
 
+TEST_F(GraphTest, AdjustHorizontalRangeLimitsPointCount) {
+  VirtualDataset dataset{.horizontal_min_ = 0,
+                         .step_ = 1,
+                         .count_ = 100000,
+                         .ramp_count_ = 100};
+  VirtualDataSource data_source{dataset};
+
+  auto* pane = graph_.AddPane();
+  pane->plot().AddLine(data_source);
+
+  GraphRange range{0, 100000};
+  graph_.horizontal_axis().SetTimeFit(false);
+  graph_.horizontal_axis().SetRange(range);
+
+  // Only the last 10000 points must remain in the range.
+  const auto& adjusted_range = graph_.horizontal_axis().range();
+  EXPECT_EQ(adjusted_range.high(), range.high());
+  EXPECT_EQ(data_source.CountPoints(adjusted_range.low(),
+                                    adjusted_range.high(), false, false),
+            10000u);
+
+  // Clean up lines before local data_source is destroyed.
+  pane->plot().DeleteAllLines();
+}
+
+TEST_F(GraphTest, DownsampledLineShowsWholeRange) {
+  VirtualDataset dataset{.horizontal_min_ = 0,
+                         .step_ = 1,
+                         .count_ = 100000,
+                         .ramp_count_ = 100};
+  VirtualDataSource data_source{dataset};
+
+  auto* pane = graph_.AddPane();
+  auto* line = pane->plot().AddLine(data_source);
+  line->SetDownsampling(GraphLine::DOWNSAMPLING_LTTB);
+
+  GraphRange range{0, 100000};
+  graph_.horizontal_axis().SetTimeFit(false);
+  graph_.horizontal_axis().SetRange(range);
+
+  EXPECT_EQ(graph_.horizontal_axis().range(), range);
+
+  // Clean up lines before local data_source is destroyed.
+  pane->plot().DeleteAllLines();
+}
+
+TEST_F(GraphTest, LiveAutoRangeFollowsAppendedPoints) {
+  VirtualDataset dataset{.horizontal_min_ = 0,
+                         .step_ = 1,
+                         .count_ = 1000,
+                         .ramp_count_ = 100};
+  VirtualDataSource data_source{dataset};
+
+  auto* pane = graph_.AddPane();
+  auto* line = pane->plot().AddLine(data_source);
+  ASSERT_TRUE(line->auto_range());
+
+  graph_.horizontal_axis().SetRange({800, 950});
+  graph_.horizontal_axis().SetTimeFit(true);
+
+  for (int i = 0; i < 150; ++i) {
+    data_source.AddPoint();
+
+    // The virtual data source enumerates both bounds, while the auto-range
+    // excludes the right one.
+    double x1 = line->XToValue(0);
+    double x2 = line->XToValue(pane->plot().width());
+    size_t first = dataset.lower_bound(x1);
+    size_t last = dataset.lower_bound(x2);
+    GraphRange expected;
+    if (first < last) {
+      double low = dataset.value_at(first);
+      double high = low;
+      for (size_t index = first + 1; index < last; ++index) {
+        low = std::min(low, dataset.value_at(index));
+        high = std::max(high, dataset.value_at(index));
+      }
+      expected = GraphRange(low, high);
+    }
+    EXPECT_EQ(line->vertical_range(), expected) << i;
+  }
+
+  // Clean up lines before local data_source is destroyed.
+  pane->plot().DeleteAllLines();
+}
+
+TEST_F(GraphTest, LiveAutoRangeIncludesNewestPoint) {
+  auto* pane = graph_.AddPane();
+  auto* line = pane->plot().AddLine(data_source_);
+  ASSERT_TRUE(line->auto_range());
+
+  graph_.horizontal_axis().SetTimeFit(true);
+
+  // Rising values put the maximum at the newest point, which lies before the
+  // right edge of the window.
+  for (int i = 0; i < 50; ++i) {
+    data_source_.AddPoint();
+    EXPECT_EQ(line->vertical_range().high(), data_source_.GetCurrentValue())
+        << i;
+  }
+}
+
+TEST_F(GraphTest, LiveAutoRangeIncludesPointsWithSameX) {
+  MergeBufferDataSource data_source;
+  for (int i = 0; i < 100; ++i) {
+    data_source.AddPoint(
+        {static_cast<double>(i), static_cast<double>(i % 2)});
+  }
+
+  auto* pane = graph_.AddPane();
+  auto* line = pane->plot().AddLine(data_source);
+  graph_.horizontal_axis().SetTimeFit(true);
+  EXPECT_EQ(line->vertical_range().high(), 1);
+
+  // A point at the x of the last pushed point is still pushed.
+  data_source.AddPoint({99, 50});
+  EXPECT_EQ(line->vertical_range().high(), 50);
+  data_source.AddPoint({99, 60});
+  EXPECT_EQ(line->vertical_range().high(), 60);
+
+  // Clean up lines before local data_source is destroyed.
+  pane->plot().DeleteAllLines();
+}
+
+TEST_F(GraphTest, CursorIntervalStatistics) {
+  VirtualDataset dataset{.horizontal_min_ = 0,
+                         .step_ = 1,
+                         .count_ = 100,
+                         .ramp_count_ = 100};
+  VirtualDataSource data_source{dataset};
+
+  auto* pane = graph_.AddPane();
+  auto* line = pane->plot().AddLine(data_source);
+
+  // Copies, as adding a cursor may move the existing ones.
+  GraphCursor cursor1 = graph_.horizontal_axis().AddCursor(50);
+  GraphCursor cursor2 = graph_.horizontal_axis().AddCursor(10);
+
+  auto statistics = graph_.GetCursorIntervalStatistics(*line, cursor1, cursor2);
+  EXPECT_EQ(statistics.count, 41u);
+  EXPECT_EQ(statistics.min, dataset.value_at(50));
+  EXPECT_EQ(statistics.max, dataset.value_at(10));
+  EXPECT_EQ(statistics, data_source.CalculateStatistics(10, 50));
+
+  // Clean up lines before local data_source is destroyed.
+  pane->plot().DeleteAllLines();
+}
+
 TEST_F(GraphTest, TimeFitDisabled) {
   auto* pane = graph_.AddPane();
   pane->plot().AddLine(data_source_);
@@ -268,4 +417,4 @@ TEST_F(GraphTest, TimeFitDisabled) {
   EXPECT_EQ(graph_.horizontal_axis().range(), view_range);
 }
 
-}  // namespace views
\ No newline at end of file
+}  // namespace views
\ No newline at end of file
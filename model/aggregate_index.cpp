@@ -0,0 +1,68 @@
+#include "graph_qt/model/aggregate_index.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace views {
+
+void AggregateIndex::Update(std::span<const GraphPoint> points) {
+  assert(points.size() >= size());
+
+  if (points.empty()) {
+    return;
+  }
+
+  if (sums_.empty()) {
+    offset_ = points.front().y;
+    sums_.emplace_back();
+  }
+
+  for (size_t i = size(); i < points.size(); ++i) {
+    const Sums& previous = sums_.back();
+    double value = points[i].y - offset_;
+    // The area grows by the previous value held until this point.
+    double area =
+        i == 0 ? 0.0
+               : (points[i - 1].y - offset_) * (points[i].x - points[i - 1].x);
+    sums_.push_back({previous.sum + value,
+                     previous.sum_squares + value * value,
+                     previous.area + area});
+  }
+}
+
+void AggregateIndex::Clear() {
+  offset_ = 0.0;
+  sums_.clear();
+}
+
+GraphStatistics AggregateIndex::Query(std::span<const GraphPoint> points,
+                                      size_t first,
+                                      size_t last,
+                                      double to) const {
+  assert(first < last);
+  assert(last <= size());
+
+  const Sums& begin = sums_[first];
+  const Sums& end = sums_[last];
+  size_t count = last - first;
+
+  double mean = (end.sum - begin.sum) / count;
+  double variance = (end.sum_squares - begin.sum_squares) / count - mean * mean;
+
+  const GraphPoint& first_point = points[first];
+  const GraphPoint& last_point = points[last - 1];
+  // Area between the first and the last point, then the held last value.
+  double area = sums_[last].area - sums_[first + 1].area +
+                (last_point.y - offset_) * (to - last_point.x) +
+                offset_ * (to - first_point.x);
+
+  GraphStatistics statistics;
+  statistics.count = count;
+  statistics.mean = offset_ + mean;
+  statistics.stddev = std::sqrt(std::max(0.0, variance));
+  statistics.integral = area;
+  return statistics;
+}
+
+}  // namespace views
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "graph_qt/model/graph_statistics.h"
+#include "graph_qt/model/graph_types.h"
+
+#include <span>
+#include <vector>
+
+namespace views {
+
+// Prefix sums of the values, squared values and held areas of an append-only
+// sequence of points, so the statistics of any index range are found in O(1)
+// and appending a point takes O(1).
+//
+// The sums are kept relative to the first value, which avoids the loss of
+// precision of large squared sums when the values have a big offset.
+//
+// The index doesn't own the points. The same sequence must be passed to all
+// calls.
+class AggregateIndex {
+ public:
+  // Summarizes the points appended since the last call.
+  void Update(std::span<const GraphPoint> points);
+
+  void Clear();
+
+  // Number of points summarized.
+  size_t size() const { return sums_.empty() ? 0 : sums_.size() - 1; }
+
+  // Returns the statistics of the points in `[first, last)`, holding the last
+  // value until `to`. The range must not be empty. The min and max are left
+  // zero; they are provided by `MinMaxPyramid`.
+  GraphStatistics Query(std::span<const GraphPoint> points,
+                        size_t first,
+                        size_t last,
+                        double to) const;
+
+ private:
+  // Sums of the points preceding an index.
+  struct Sums {
+    double sum = 0.0;
+    double sum_squares = 0.0;
+    // Area from the first point to the last point summed.
+    double area = 0.0;
+  };
+
+  double offset_ = 0.0;
+  std::vector<Sums> sums_;
+};
+
+}  // namespace views
@@ -0,0 +1,89 @@
+#include "graph_qt/model/aggregate_index.h"
+
+#include "graph_qt/model/point_enumerators.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace views {
+
+namespace {
+
+// Values with a large offset and irregular timestamps.
+std::vector<GraphPoint> MakePoints(size_t count) {
+  std::mt19937 generator{42};
+  std::uniform_real_distribution<double> step_distribution{0.5, 2.0};
+
+  std::vector<GraphPoint> points;
+  double x = 1000;
+  for (size_t i = 0; i < count; ++i) {
+    points.emplace_back(x, 1e6 + std::sin(i / 10.0) * 10);
+    x += step_distribution(generator);
+  }
+  return points;
+}
+
+void ExpectNear(const GraphStatistics& actual,
+                const GraphStatistics& expected) {
+  EXPECT_EQ(actual.count, expected.count);
+  EXPECT_NEAR(actual.mean, expected.mean, 1e-6);
+  EXPECT_NEAR(actual.stddev, expected.stddev, 1e-4);
+  EXPECT_NEAR(actual.integral, expected.integral,
+              std::abs(expected.integral) * 1e-12);
+}
+
+GraphStatistics BruteForce(std::span<const GraphPoint> points,
+                           size_t first,
+                           size_t last,
+                           double to) {
+  SpanPointEnumerator point_enum{points.subspan(first, last - first)};
+  return CalculateStatistics(point_enum, to);
+}
+
+}  // namespace
+
+TEST(AggregateIndexTest, QueryMatchesBruteForce) {
+  auto points = MakePoints(3000);
+
+  AggregateIndex index;
+  index.Update(points);
+  ASSERT_EQ(index.size(), points.size());
+
+  std::mt19937 generator{7};
+  std::uniform_int_distribution<size_t> distribution{0, points.size()};
+  for (int i = 0; i < 500; ++i) {
+    size_t first = distribution(generator);
+    size_t last = distribution(generator);
+    if (first > last) {
+      std::swap(first, last);
+    }
+    if (first == last) {
+      continue;
+    }
+    double to = points[last - 1].x + 0.25;
+    ExpectNear(index.Query(points, first, last, to),
+               BruteForce(points, first, last, to));
+  }
+}
+
+TEST(AggregateIndexTest, IncrementalUpdate) {
+  auto all_points = MakePoints(500);
+
+  std::vector<GraphPoint> points;
+  AggregateIndex index;
+  for (const auto& point : all_points) {
+    points.push_back(point);
+    index.Update(points);
+
+    double to = points.back().x;
+    ExpectNear(index.Query(points, 0, points.size(), to),
+               BruteForce(points, 0, points.size(), to));
+    ExpectNear(index.Query(points, points.size() / 2, points.size(), to),
+               BruteForce(points, points.size() / 2, points.size(), to));
+  }
+}
+
+}  // namespace views
@@ -0,0 +1,213 @@
+#include "graph_qt/model/buffer_data_source.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <limits>
+#include <ranges>
+#include <utility>
+
+namespace views {
+
+namespace {
+
+// Quality bitmap of contiguous column spans, which are given in runs of at
+// most `kMaxColumnRun` points.
+constexpr size_t kMaxColumnRun = 4096;
+constexpr auto kAllGood = [] {
+  std::array<uint64_t, kMaxColumnRun / 64> quality{};
+  quality.fill(~uint64_t{0});
+  return quality;
+}();
+
+// Enumerates points of attached arrays in place.
+class BufferPointEnumerator : public PointEnumerator {
+ public:
+  BufferPointEnumerator(const StridedValues& x,
+                        const StridedValues& y,
+                        size_t first,
+                        size_t last)
+      : x_{x}, y_{y}, index_{first}, last_{last} {}
+
+  size_t GetCount() const override { return last_ - index_; }
+
+  bool EnumNext(GraphPoint& value) override {
+    return EnumNextBatch(std::span{&value, 1}) == 1;
+  }
+
+  size_t EnumNextBatch(std::span<GraphPoint> points) override {
+    size_t count = std::min(points.size(), last_ - index_);
+    for (size_t i = 0; i < count; ++i, ++index_) {
+      points[i] = GraphPoint{x_[index_], y_[index_]};
+      points[i].good = true;
+    }
+    return count;
+  }
+
+  bool SupportsColumns() const override {
+    return x_.contiguous() && y_.contiguous();
+  }
+
+  bool EnumNextColumns(PointColumnSpans& columns) override {
+    assert(SupportsColumns());
+    size_t count = std::min(kMaxColumnRun, last_ - index_);
+    if (count == 0) {
+      return false;
+    }
+    columns = {std::span{x_.data + index_, count},
+               std::span{y_.data + index_, count}, kAllGood, 0};
+    index_ += count;
+    return true;
+  }
+
+ private:
+  const StridedValues x_;
+  const StridedValues y_;
+  size_t index_;
+  const size_t last_;
+};
+
+}  // namespace
+
+BufferDataSource::BufferDataSource(GraphRange::Kind horizontal_kind)
+    : horizontal_kind_{horizontal_kind} {}
+
+BufferDataSource::~BufferDataSource() {
+  Release();
+}
+
+void BufferDataSource::Attach(std::span<const GraphValue> x,
+                              std::span<const GraphValue> y,
+                              ReleaseCallback release) {
+  assert(x.size() == y.size());
+  Attach(StridedValues{x.data(), x.size()}, StridedValues{y.data(), y.size()},
+         std::move(release));
+}
+
+void BufferDataSource::AttachInterleaved(std::span<const GraphValue> samples,
+                                         size_t stride,
+                                         ReleaseCallback release) {
+  assert(stride >= 2);
+  size_t count = samples.size() / stride;
+  Attach(StridedValues{samples.data(), count, stride},
+         StridedValues{samples.data() + 1, count, stride}, std::move(release));
+}
+
+void BufferDataSource::Attach(const StridedValues& x,
+                              const StridedValues& y,
+                              ReleaseCallback release) {
+  assert(x.size() == y.size());
+  Release();
+  x_ = x;
+  y_ = y;
+  release_ = std::move(release);
+  NotifyHistoryChanged();
+}
+
+void BufferDataSource::Detach() {
+  Release();
+  NotifyHistoryChanged();
+}
+
+void BufferDataSource::NotifyDataChanged() {
+  NotifyHistoryChanged();
+}
+
+void BufferDataSource::Release() {
+  x_ = y_ = StridedValues{};
+  if (auto release = std::exchange(release_, nullptr)) {
+    release();
+  }
+}
+
+void BufferDataSource::NotifyHistoryChanged() {
+  vertical_range_.reset();
+
+  if (observer_) {
+    observer_->OnDataSourceCurrentValueChanged();
+    observer_->OnDataSourceHistoryChanged();
+  }
+}
+
+double BufferDataSource::GetCurrentValue() const {
+  return size() == 0 ? kGraphUnknownValue : y_[size() - 1];
+}
+
+std::unique_ptr<PointEnumerator> BufferDataSource::EnumPoints(
+    double from,
+    double to,
+    bool include_left_bound,
+    bool include_right_bound) {
+  size_t first =
+      include_left_bound ? FindLowerBound(from) : FindUpperBound(from);
+  size_t last = include_right_bound ? FindUpperBound(to) : FindLowerBound(to);
+  if (first >= last) {
+    return nullptr;
+  }
+
+  return std::make_unique<BufferPointEnumerator>(x_, y_, first, last);
+}
+
+GraphRange BufferDataSource::GetHorizontalRange() const {
+  if (size() == 0) {
+    return GraphRange{};
+  }
+  return GraphRange{x_[0], x_[size() - 1], horizontal_kind_};
+}
+
+GraphRange BufferDataSource::GetVerticalRange() const {
+  if (!vertical_range_) {
+    vertical_range_ = CalculateVerticalRange(0, size());
+  }
+  return *vertical_range_;
+}
+
+GraphRange BufferDataSource::CalculateVerticalRange(size_t first,
+                                                    size_t last) const {
+  if (first >= last) {
+    return GraphRange{};
+  }
+
+  double low = std::numeric_limits<double>::max();
+  double high = std::numeric_limits<double>::lowest();
+  if (y_.contiguous()) {
+    auto [min, max] = std::ranges::minmax(
+        std::span{y_.data + first, y_.data + last});
+    low = min;
+    high = max;
+  } else {
+    for (size_t i = first; i < last; ++i) {
+      low = std::min(low, y_[i]);
+      high = std::max(high, y_[i]);
+    }
+  }
+  return GraphRange{low, high};
+}
+
+std::optional<size_t> BufferDataSource::LowerBound(double value) const {
+  return FindLowerBound(value);
+}
+
+std::optional<size_t> BufferDataSource::UpperBound(double value) const {
+  return FindUpperBound(value);
+}
+
+std::optional<double> BufferDataSource::GetPointX(size_t index) const {
+  return x_[index];
+}
+
+size_t BufferDataSource::FindLowerBound(double value) const {
+  auto indices = std::views::iota(size_t{0}, size());
+  return std::ranges::partition_point(
+             indices, [&](size_t index) { return x_[index] < value; }) -
+         indices.begin();
+}
+
+size_t BufferDataSource::FindUpperBound(double value) const {
+  auto indices = std::views::iota(size_t{0}, size());
+  return std::ranges::partition_point(
+             indices, [&](size_t index) { return x_[index] <= value; }) -
+         indices.begin();
+}
+
+}  // namespace views
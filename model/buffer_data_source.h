@@ -0,0 +1,101 @@
+#pragma once
+
+#include "graph_qt/model/graph_data_source.h"
+
+#include <functional>
+#include <optional>
+#include <span>
+
+namespace views {
+
+// Read-only view of `count` values placed `stride` values apart, e.g. one
+// field of an array of interleaved samples.
+struct StridedValues {
+  size_t size() const { return count; }
+  bool contiguous() const { return stride == 1; }
+
+  GraphValue operator[](size_t index) const { return data[index * stride]; }
+
+  const GraphValue* data = nullptr;
+  size_t count = 0;
+  size_t stride = 1;
+};
+
+// Data source over sample arrays owned by the caller, e.g. the buffers of an
+// acquisition driver. The arrays are neither copied nor converted: the
+// enumerators read them in place, and contiguous columns are given as column
+// spans. All points are good.
+//
+// The x values must be sorted, so that ranges are found by binary search. The
+// caller keeps the arrays alive and unchanged until they are detached, which
+// calls the release callback given with them. If the caller changes the values
+// in place, it calls `NotifyDataChanged()`.
+class BufferDataSource : public GraphDataSource {
+ public:
+  using ReleaseCallback = std::function<void()>;
+
+  explicit BufferDataSource(
+      GraphRange::Kind horizontal_kind = GraphRange::LINEAR);
+  ~BufferDataSource() override;
+
+  size_t size() const { return x_.size(); }
+  const StridedValues& x() const { return x_; }
+  const StridedValues& y() const { return y_; }
+
+  // Attaches separate x and y arrays of the same size, detaching the previous
+  // arrays. Sends `OnDataSourceHistoryChanged()`.
+  void Attach(std::span<const GraphValue> x,
+              std::span<const GraphValue> y,
+              ReleaseCallback release = {});
+
+  // Attaches interleaved samples of `stride` values each, where the first two
+  // values are x and y.
+  void AttachInterleaved(std::span<const GraphValue> samples,
+                         size_t stride,
+                         ReleaseCallback release = {});
+
+  void Attach(const StridedValues& x,
+              const StridedValues& y,
+              ReleaseCallback release = {});
+
+  // Drops the arrays and calls their release callback. Sends
+  // `OnDataSourceHistoryChanged()`.
+  void Detach();
+
+  // Tells the source that the caller changed the attached values. Sends
+  // `OnDataSourceHistoryChanged()`.
+  void NotifyDataChanged();
+
+  // GraphDataSource
+  double GetCurrentValue() const override;
+  std::unique_ptr<PointEnumerator> EnumPoints(
+      double from,
+      double to,
+      bool include_left_bound,
+      bool include_right_bound) override;
+  GraphRange GetHorizontalRange() const override;
+  GraphRange GetVerticalRange() const override;
+  std::optional<size_t> LowerBound(double value) const override;
+  std::optional<size_t> UpperBound(double value) const override;
+  std::optional<double> GetPointX(size_t index) const override;
+
+ private:
+  void Release();
+  void NotifyHistoryChanged();
+
+  size_t FindLowerBound(double value) const;
+  size_t FindUpperBound(double value) const;
+
+  GraphRange CalculateVerticalRange(size_t first, size_t last) const;
+
+  const GraphRange::Kind horizontal_kind_;
+
+  StridedValues x_;
+  StridedValues y_;
+  ReleaseCallback release_;
+
+  // Calculated on the first request, so attaching doesn't scan the arrays.
+  mutable std::optional<GraphRange> vertical_range_;
+};
+
+}  // namespace views
@@ -0,0 +1,105 @@
+#include "graph_qt/model/buffer_data_source.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace views {
+
+namespace {
+
+std::vector<GraphPoint> EnumAllPoints(
+    std::unique_ptr<PointEnumerator> point_enum) {
+  std::vector<GraphPoint> points;
+  if (point_enum) {
+    size_t count = point_enum->GetCount();
+    ForEachPoint(*point_enum,
+                 [&](const GraphPoint& point) { points.push_back(point); });
+    EXPECT_EQ(points.size(), count);
+  }
+  return points;
+}
+
+std::vector<GraphPoint> MakePoints(std::initializer_list<GraphValue> x,
+                                   std::initializer_list<GraphValue> y) {
+  std::vector<GraphPoint> points;
+  for (auto i = x.begin(), j = y.begin(); i != x.end(); ++i, ++j) {
+    points.emplace_back(*i, *j).good = true;
+  }
+  return points;
+}
+
+}  // namespace
+
+TEST(BufferDataSourceTest, SeparateArrays) {
+  const std::vector<GraphValue> x{1, 2, 2, 4, 5};
+  const std::vector<GraphValue> y{10, -3, 7, 0, 2};
+  bool released = false;
+  BufferDataSource data_source;
+  data_source.Attach(x, y, [&] { released = true; });
+
+  EXPECT_EQ(data_source.x().data, x.data());
+  EXPECT_EQ(data_source.GetHorizontalRange(), GraphRange(1, 5));
+  EXPECT_EQ(data_source.GetVerticalRange(), GraphRange(-3, 10));
+  EXPECT_EQ(data_source.GetCurrentValue(), 2);
+  EXPECT_EQ(data_source.LowerBound(2), 1u);
+  EXPECT_EQ(data_source.UpperBound(2), 3u);
+  EXPECT_EQ(data_source.GetPointX(3), 4);
+  // A scan is no cheaper than the fallback, so the query isn't supported.
+  EXPECT_FALSE(data_source.QueryVerticalRange(2, 5));
+  EXPECT_EQ(data_source.CalculateAutoRange(2, 5), GraphRange(-3, 7));
+
+  EXPECT_EQ(EnumAllPoints(data_source.EnumPoints(2, 4, false, true)),
+            MakePoints({4}, {0}));
+  EXPECT_EQ(EnumAllPoints(data_source.EnumPoints(0, 10, true, true)),
+            MakePoints({1, 2, 2, 4, 5}, {10, -3, 7, 0, 2}));
+  EXPECT_FALSE(data_source.EnumPoints(6, 10, true, true));
+
+  // Contiguous arrays are enumerated as column spans of the arrays.
+  auto point_enum = data_source.EnumPoints(2, 5, true, false);
+  ASSERT_TRUE(point_enum);
+  ASSERT_TRUE(point_enum->SupportsColumns());
+  PointColumnSpans columns;
+  ASSERT_TRUE(point_enum->EnumNextColumns(columns));
+  EXPECT_EQ(columns.x.data(), x.data() + 1);
+  EXPECT_EQ(columns.size(), 3u);
+  EXPECT_TRUE(columns.good(2));
+  EXPECT_FALSE(point_enum->EnumNextColumns(columns));
+
+  EXPECT_FALSE(released);
+  data_source.Detach();
+  EXPECT_TRUE(released);
+  EXPECT_EQ(data_source.size(), 0u);
+  EXPECT_FALSE(data_source.EnumPoints(0, 10, true, true));
+}
+
+TEST(BufferDataSourceTest, InterleavedSamples) {
+  // x, y and a field the source skips.
+  const std::vector<GraphValue> samples{1, 5, 0, 2, 6, 0, 3, 4, 0};
+  BufferDataSource data_source;
+  data_source.AttachInterleaved(samples, /*stride=*/3);
+
+  EXPECT_EQ(data_source.size(), 3u);
+  EXPECT_EQ(data_source.GetHorizontalRange(), GraphRange(1, 3));
+  EXPECT_EQ(data_source.GetVerticalRange(), GraphRange(4, 6));
+
+  auto point_enum = data_source.EnumPoints(1, 3, true, true);
+  ASSERT_TRUE(point_enum);
+  EXPECT_FALSE(point_enum->SupportsColumns());
+  EXPECT_EQ(EnumAllPoints(std::move(point_enum)),
+            MakePoints({1, 2, 3}, {5, 6, 4}));
+}
+
+TEST(BufferDataSourceTest, ReleasesOnReattach) {
+  const std::vector<GraphValue> values{1, 2, 3};
+  int released = 0;
+  {
+    BufferDataSource data_source;
+    data_source.Attach(values, values, [&] { ++released; });
+    data_source.Attach(values, values, [&] { ++released; });
+    EXPECT_EQ(released, 1);
+  }
+  EXPECT_EQ(released, 2);
+}
+
+}  // namespace views
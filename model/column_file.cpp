@@ -0,0 +1,72 @@
+#include "graph_qt/model/column_file.h"
+
+#include <QFile>
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <vector>
+
+namespace views {
+
+static_assert(std::endian::native == std::endian::little,
+              "Column files are mapped in place.");
+
+namespace {
+
+bool WriteBytes(QFile& file, std::span<const std::byte> bytes) {
+  const auto size = static_cast<qint64>(bytes.size());
+  return file.write(reinterpret_cast<const char*>(bytes.data()), size) == size;
+}
+
+}  // namespace
+
+bool WriteColumnFile(const QString& path,
+                     const PointColumnSpans& columns,
+                     uint32_t block_size) {
+  const size_t count = columns.size();
+
+  ColumnFileHeader header = {};
+  std::memcpy(header.magic, ColumnFileHeader::kMagic, sizeof(header.magic));
+  header.version = ColumnFileHeader::kVersion;
+  header.block_size = block_size;
+  header.point_count = count;
+  if (count != 0) {
+    auto [min, max] = std::ranges::minmax(columns.y);
+    header.min_value = min;
+    header.max_value = max;
+  }
+  header.x_offset = sizeof(header);
+  header.y_offset = header.x_offset + count * sizeof(double);
+  header.quality_offset = header.y_offset + count * sizeof(double);
+  header.summary_offset =
+      header.quality_offset + (count + 63) / 64 * sizeof(uint64_t);
+
+  // Pack the quality bits from the start of a word.
+  std::vector<uint64_t> quality((count + 63) / 64);
+  for (size_t i = 0; i < count; ++i) {
+    quality[i / 64] |= uint64_t{columns.good(i)} << (i % 64);
+  }
+
+  std::vector<ColumnFileBlock> blocks;
+  if (block_size != 0) {
+    for (size_t first = 0; first < count; first += block_size) {
+      size_t size = std::min<size_t>(block_size, count - first);
+      auto [min, max] = std::ranges::minmax(columns.y.subspan(first, size));
+      blocks.push_back({min, max});
+    }
+  }
+
+  QFile file{path};
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    return false;
+  }
+  return WriteBytes(file, std::as_bytes(std::span{&header, 1})) &&
+         WriteBytes(file, std::as_bytes(columns.x)) &&
+         WriteBytes(file, std::as_bytes(columns.y)) &&
+         WriteBytes(file, std::as_bytes(std::span{quality})) &&
+         WriteBytes(file, std::as_bytes(std::span{blocks}));
+}
+
+}  // namespace views
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "graph_qt/model/point_columns.h"
+
+#include <QString>
+#include <cstdint>
+
+namespace views {
+
+// On-disk columnar point format, designed to be memory-mapped. All numbers are
+// little-endian, and every section starts at a multiple of 8 bytes.
+//
+//   ColumnFileHeader
+//   x column         point_count doubles, sorted
+//   y column         point_count doubles
+//   quality bitmap   ceil(point_count / 64) uint64s, bit i of word i / 64 is
+//                    the quality of point i
+//   block summaries  ceil(point_count / block_size) ColumnFileBlocks with the
+//                    extremes of every `block_size` points, if block_size > 0
+//
+// The header keeps the extremes of all values, so the ranges of the file are
+// known without reading the columns.
+struct ColumnFileHeader {
+  static constexpr char kMagic[8] = {'G', 'Q', 'T', 'C', 'O', 'L', 0, 0};
+  static constexpr uint32_t kVersion = 1;
+
+  char magic[8];
+  uint32_t version;
+  uint32_t block_size;
+  uint64_t point_count;
+  double min_value;
+  double max_value;
+  uint64_t x_offset;
+  uint64_t y_offset;
+  uint64_t quality_offset;
+  uint64_t summary_offset;
+};
+
+struct ColumnFileBlock {
+  double min;
+  double max;
+};
+
+// Writes `columns` to the file at `path` in the format above. Returns false if
+// the file can't be written.
+bool WriteColumnFile(const QString& path,
+                     const PointColumnSpans& columns,
+                     uint32_t block_size = 4096);
+
+}  // namespace views
@@ -0,0 +1,383 @@
+#include "graph_qt/model/column_file_data_source.h"
+
+#include "graph_qt/model/point_enumerators.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace views {
+
+namespace {
+
+enum class AccessPattern { kRandom, kWillNeed };
+
+// Hints the kernel how the mapped `bytes` will be read. Does nothing on
+// platforms without `madvise()`.
+void AdviseAccess(std::span<const std::byte> bytes, AccessPattern pattern) {
+#if defined(__unix__) || defined(__APPLE__)
+  if (bytes.empty()) {
+    return;
+  }
+  // The address must be page-aligned.
+  static const auto page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+  auto first = reinterpret_cast<uintptr_t>(bytes.data()) & ~(page_size - 1);
+  auto last = reinterpret_cast<uintptr_t>(bytes.data() + bytes.size());
+  madvise(reinterpret_cast<void*>(first), last - first,
+          pattern == AccessPattern::kRandom ? MADV_RANDOM : MADV_WILLNEED);
+#endif
+}
+
+// Returns true if a section of `count` items of `T` at `offset` lies within
+// `file_size` bytes and is aligned.
+template <class T>
+bool IsValidSection(uint64_t offset, uint64_t count, uint64_t file_size) {
+  return offset % alignof(T) == 0 && offset <= file_size &&
+         count <= (file_size - offset) / sizeof(T);
+}
+
+void MergeBlock(ColumnFileBlock& block, const ColumnFileBlock& other) {
+  block.min = std::min(block.min, other.min);
+  block.max = std::max(block.max, other.max);
+}
+
+// Consecutive reduced blocks starting in one pixel column: the first and last
+// points and the extremes between them.
+struct ReducedRun {
+  // Adds the points of the run to `points`. The extremes are placed in the
+  // middle of the run, and are good only if both ends are.
+  void AppendTo(std::vector<GraphPoint>& points) const {
+    const double middle = first.x + (last.x - first.x) / 2;
+    GraphPoint min{middle, extremes.min};
+    GraphPoint max{middle, extremes.max};
+    min.good = max.good = first.good && last.good;
+    points.insert(points.end(), {first, min, max, last});
+  }
+
+  double column;
+  GraphPoint first;
+  GraphPoint last;
+  ColumnFileBlock extremes;
+};
+
+}  // namespace
+
+ColumnFileDataSource::ColumnFileDataSource(GraphRange::Kind horizontal_kind)
+    : horizontal_kind_{horizontal_kind} {}
+
+ColumnFileDataSource::~ColumnFileDataSource() = default;
+
+bool ColumnFileDataSource::Open(const QString& path) {
+  Close();
+
+  bool result = Map(path);
+  if (!result) {
+    Close();
+  }
+
+  if (observer_) {
+    observer_->OnDataSourceCurrentValueChanged();
+    observer_->OnDataSourceHistoryChanged();
+  }
+  return result;
+}
+
+bool ColumnFileDataSource::Map(const QString& path) {
+  file_.setFileName(path);
+  if (!file_.open(QIODevice::ReadOnly)) {
+    return false;
+  }
+
+  const auto file_size = static_cast<uint64_t>(file_.size());
+  if (file_size < sizeof(ColumnFileHeader)) {
+    return false;
+  }
+
+  // Mapping doesn't read the file; pages are read when first accessed.
+  data_ = file_.map(0, file_.size());
+  if (!data_) {
+    return false;
+  }
+  const uchar* data = data_;
+
+  AdviseAccess({reinterpret_cast<const std::byte*>(data), file_size},
+               AccessPattern::kRandom);
+
+  const auto* header = reinterpret_cast<const ColumnFileHeader*>(data);
+  const uint64_t count = header->point_count;
+  const uint64_t block_count =
+      header->block_size != 0
+          ? count / header->block_size + (count % header->block_size != 0)
+          : 0;
+  if (std::memcmp(header->magic, ColumnFileHeader::kMagic,
+                  sizeof(header->magic)) != 0 ||
+      header->version != ColumnFileHeader::kVersion ||
+      !IsValidSection<double>(header->x_offset, count, file_size) ||
+      !IsValidSection<double>(header->y_offset, count, file_size) ||
+      !IsValidSection<uint64_t>(header->quality_offset, (count + 63) / 64,
+                                file_size) ||
+      !IsValidSection<ColumnFileBlock>(header->summary_offset, block_count,
+                                       file_size)) {
+    return false;
+  }
+
+  header_ = header;
+  columns_ = PointColumnSpans{
+      {reinterpret_cast<const double*>(data + header->x_offset), count},
+      {reinterpret_cast<const double*>(data + header->y_offset), count},
+      {reinterpret_cast<const uint64_t*>(data + header->quality_offset),
+       (count + 63) / 64}};
+  blocks_ = {
+      reinterpret_cast<const ColumnFileBlock*>(data + header->summary_offset),
+      block_count};
+  BuildSummaryLevels();
+  return true;
+}
+
+void ColumnFileDataSource::BuildSummaryLevels() {
+  std::span<const ColumnFileBlock> level = blocks_;
+  while (level.size() > kSummaryFanout) {
+    std::vector<ColumnFileBlock> next_level;
+    next_level.reserve((level.size() + kSummaryFanout - 1) / kSummaryFanout);
+    for (size_t i = 0; i < level.size(); i += kSummaryFanout) {
+      auto node = level[i];
+      for (const auto& block : level.subspan(
+               i + 1, std::min(kSummaryFanout, level.size() - i) - 1)) {
+        MergeBlock(node, block);
+      }
+      next_level.push_back(node);
+    }
+    summary_levels_.push_back(std::move(next_level));
+    level = summary_levels_.back();
+  }
+}
+
+void ColumnFileDataSource::Close() {
+  header_ = nullptr;
+  columns_ = {};
+  blocks_ = {};
+  summary_levels_.clear();
+  if (data_) {
+    file_.unmap(data_);
+    data_ = nullptr;
+  }
+  file_.close();
+}
+
+double ColumnFileDataSource::GetCurrentValue() const {
+  return columns_.size() == 0 ? kGraphUnknownValue : columns_.y.back();
+}
+
+std::unique_ptr<PointEnumerator> ColumnFileDataSource::EnumPoints(
+    double from,
+    double to,
+    bool include_left_bound,
+    bool include_right_bound) {
+  size_t first =
+      include_left_bound ? FindLowerBound(from) : FindUpperBound(from);
+  size_t last = include_right_bound ? FindUpperBound(to) : FindLowerBound(to);
+  if (first >= last) {
+    return nullptr;
+  }
+  return EnumRange(first, last);
+}
+
+std::unique_ptr<PointEnumerator> ColumnFileDataSource::EnumReducedPoints(
+    double from,
+    double to,
+    double resolution) {
+  size_t first = FindLowerBound(from);
+  size_t last = FindUpperBound(to);
+  if (first >= last) {
+    return nullptr;
+  }
+
+  // Blocks of up to 4 points aren't worth reducing.
+  const size_t block_size = blocks_.empty() ? 0 : header_->block_size;
+  if (block_size <= 4 || !(resolution > 0)) {
+    return EnumRange(first, last);
+  }
+  const size_t first_block = (first + block_size - 1) / block_size;
+  const size_t last_block = last / block_size;
+
+  // Alternates runs of points read in full and runs of blocks narrower than
+  // a pixel column, reduced to their ends and extremes. Only the ends of the
+  // reduced blocks are read. As the extremes of a block are placed in its
+  // middle, those of a block crossing a column border may be drawn one
+  // column off.
+  std::vector<std::unique_ptr<PointEnumerator>> runs;
+  std::vector<GraphPoint> reduced_points;
+  std::optional<ReducedRun> reduced_run;
+  auto flush_reduced = [&] {
+    if (reduced_run) {
+      reduced_run->AppendTo(reduced_points);
+      reduced_run.reset();
+    }
+    if (!reduced_points.empty()) {
+      runs.push_back(std::make_unique<VectorPointEnumerator>(
+          std::exchange(reduced_points, {})));
+    }
+  };
+
+  size_t raw_first = first;
+  for (size_t i = first_block; i < last_block; ++i) {
+    const size_t block_first = i * block_size;
+    const size_t block_last = block_first + block_size - 1;
+    const double first_x = columns_.x[block_first];
+    const double last_x = columns_.x[block_last];
+    if (last_x - first_x >= resolution) {
+      continue;
+    }
+
+    if (raw_first < block_first) {
+      flush_reduced();
+      runs.push_back(EnumRange(raw_first, block_first));
+    }
+    raw_first = block_last + 1;
+
+    // A run ends at the first block reaching into the next pixel column.
+    if (reduced_run &&
+        std::floor(last_x / resolution) == reduced_run->column) {
+      reduced_run->last = columns_.at(block_last);
+      MergeBlock(reduced_run->extremes, blocks_[i]);
+      continue;
+    }
+    if (reduced_run) {
+      reduced_run->AppendTo(reduced_points);
+    }
+    reduced_run = ReducedRun{std::floor(first_x / resolution),
+                             columns_.at(block_first),
+                             columns_.at(block_last), blocks_[i]};
+  }
+  flush_reduced();
+  if (raw_first < last) {
+    runs.push_back(EnumRange(raw_first, last));
+  }
+
+  if (runs.size() == 1) {
+    return std::move(runs.front());
+  }
+  return std::make_unique<ConcatPointEnumerator>(std::move(runs));
+}
+
+std::unique_ptr<PointEnumerator> ColumnFileDataSource::EnumRange(
+    size_t first,
+    size_t last) const {
+  // The range will be read sequentially.
+  auto columns = columns_.subspan(first, last - first);
+  AdviseAccess(std::as_bytes(columns.x), AccessPattern::kWillNeed);
+  AdviseAccess(std::as_bytes(columns.y), AccessPattern::kWillNeed);
+  return std::make_unique<ColumnPointEnumerator>(columns);
+}
+
+GraphRange ColumnFileDataSource::GetHorizontalRange() const {
+  if (columns_.size() == 0) {
+    return GraphRange{};
+  }
+  return GraphRange{columns_.x.front(), columns_.x.back(), horizontal_kind_};
+}
+
+GraphRange ColumnFileDataSource::GetVerticalRange() const {
+  if (columns_.size() == 0) {
+    return GraphRange{};
+  }
+  return GraphRange{header_->min_value, header_->max_value};
+}
+
+std::optional<GraphRange> ColumnFileDataSource::QueryVerticalRange(
+    double x1,
+    double x2) const {
+  if (blocks_.empty()) {
+    return std::nullopt;
+  }
+
+  size_t first = FindLowerBound(x1);
+  size_t last = FindLowerBound(x2);
+  if (first >= last) {
+    return GraphRange{};
+  }
+
+  double low = std::numeric_limits<double>::max();
+  double high = std::numeric_limits<double>::lowest();
+  auto scan = [&](size_t first, size_t last) {
+    for (double y : columns_.y.subspan(first, last - first)) {
+      low = std::min(low, y);
+      high = std::max(high, y);
+    }
+  };
+
+  // Scan the partial blocks at the ends, and take whole blocks from the
+  // summaries.
+  const size_t block_size = header_->block_size;
+  size_t first_block = (first + block_size - 1) / block_size;
+  size_t last_block = last / block_size;
+  if (first_block >= last_block) {
+    scan(first, last);
+  } else {
+    scan(first, first_block * block_size);
+    QueryBlocks(first_block, last_block, low, high);
+    scan(last_block * block_size, last);
+  }
+  return GraphRange{low, high};
+}
+
+void ColumnFileDataSource::QueryBlocks(size_t first,
+                                       size_t last,
+                                       double& low,
+                                       double& high) const {
+  auto merge = [&](std::span<const ColumnFileBlock> nodes) {
+    for (const auto& node : nodes) {
+      low = std::min(low, node.min);
+      high = std::max(high, node.max);
+    }
+  };
+
+  // Takes the nodes at the unaligned ends of the range on each level, and
+  // the rest from the level above.
+  std::span<const ColumnFileBlock> level = blocks_;
+  for (const auto& upper_level : summary_levels_) {
+    size_t upper_first = (first + kSummaryFanout - 1) / kSummaryFanout;
+    size_t upper_last = last / kSummaryFanout;
+    if (upper_first >= upper_last) {
+      break;
+    }
+    merge(level.subspan(first, upper_first * kSummaryFanout - first));
+    merge(level.subspan(upper_last * kSummaryFanout,
+                        last - upper_last * kSummaryFanout));
+    first = upper_first;
+    last = upper_last;
+    level = upper_level;
+  }
+  merge(level.subspan(first, last - first));
+}
+
+std::optional<size_t> ColumnFileDataSource::LowerBound(double value) const {
+  return FindLowerBound(value);
+}
+
+std::optional<size_t> ColumnFileDataSource::UpperBound(double value) const {
+  return FindUpperBound(value);
+}
+
+std::optional<double> ColumnFileDataSource::GetPointX(size_t index) const {
+  return columns_.x[index];
+}
+
+size_t ColumnFileDataSource::FindLowerBound(double value) const {
+  return std::ranges::lower_bound(columns_.x, value) - columns_.x.begin();
+}
+
+size_t ColumnFileDataSource::FindUpperBound(double value) const {
+  return std::ranges::upper_bound(columns_.x, value) - columns_.x.begin();
+}
+
+}  // namespace views
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "graph_qt/model/column_file.h"
+#include "graph_qt/model/graph_data_source.h"
+
+#include <QFile>
+#include <span>
+#include <vector>
+
+namespace views {
+
+// Read-only data source over a column file (see `ColumnFileHeader`), mapped
+// into memory instead of loaded. Opening reads the header and the block
+// summaries, about 1/4000 of the file at the default block size. Enumeration
+// binary-searches the mapped x column and gives the mapped columns without
+// copying, so only the pages of the requested range are read from disk. The
+// ranges are O(1) from the header.
+//
+// Reduced enumeration replaces the blocks narrower than a pixel column by
+// their ends and extremes, so zoomed-out views read a few values per block.
+// Vertical range queries combine the block summaries in a tree of
+// `kSummaryFanout` blocks per node in O(log n).
+//
+// The mapping is hinted as random-access for the binary searches, and the
+// ranges read in full are hinted for readahead where the platform supports
+// it.
+class ColumnFileDataSource : public GraphDataSource {
+ public:
+  static constexpr size_t kSummaryFanout = 16;
+
+  explicit ColumnFileDataSource(
+      GraphRange::Kind horizontal_kind = GraphRange::LINEAR);
+  ~ColumnFileDataSource() override;
+
+  bool is_open() const { return header_ != nullptr; }
+  size_t size() const { return columns_.size(); }
+
+  // Maps the file at `path`. Returns false if the file can't be mapped or
+  // isn't a valid column file. Sends `OnDataSourceHistoryChanged()`.
+  bool Open(const QString& path);
+  void Close();
+
+  // GraphDataSource
+  double GetCurrentValue() const override;
+  std::unique_ptr<PointEnumerator> EnumPoints(
+      double from,
+      double to,
+      bool include_left_bound,
+      bool include_right_bound) override;
+  std::unique_ptr<PointEnumerator> EnumReducedPoints(
+      double from,
+      double to,
+      double resolution) override;
+  GraphRange GetHorizontalRange() const override;
+  GraphRange GetVerticalRange() const override;
+  std::optional<GraphRange> QueryVerticalRange(double x1,
+                                               double x2) const override;
+  std::optional<size_t> LowerBound(double value) const override;
+  std::optional<size_t> UpperBound(double value) const override;
+  std::optional<double> GetPointX(size_t index) const override;
+
+ private:
+  bool Map(const QString& path);
+  void BuildSummaryLevels();
+
+  // Returns the enumerator of the points in `[first, last)`, whose pages are
+  // hinted for readahead.
+  std::unique_ptr<PointEnumerator> EnumRange(size_t first, size_t last) const;
+
+  // Widens `[low, high]` by the values of blocks `[first, last)`.
+  void QueryBlocks(size_t first,
+                   size_t last,
+                   double& low,
+                   double& high) const;
+
+  size_t FindLowerBound(double value) const;
+  size_t FindUpperBound(double value) const;
+
+  const GraphRange::Kind horizontal_kind_;
+
+  QFile file_;
+  uchar* data_ = nullptr;
+  const ColumnFileHeader* header_ = nullptr;
+  PointColumnSpans columns_;
+  std::span<const ColumnFileBlock> blocks_;
+
+  // `summary_levels_[n][i]` combines blocks `[i * kSummaryFanout^(n+1),
+  // (i + 1) * kSummaryFanout^(n+1))`. The top level has at most
+  // `kSummaryFanout` nodes.
+  std::vector<std::vector<ColumnFileBlock>> summary_levels_;
+};
+
+}  // namespace views
@@ -0,0 +1,164 @@
+#include "graph_qt/model/column_file_data_source.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <vector>
+
+namespace views {
+
+namespace {
+
+PointColumns MakeColumns(size_t count) {
+  PointColumns columns;
+  for (size_t i = 0; i < count; ++i) {
+    columns.push_back(static_cast<double>(i), static_cast<double>(i % 1000),
+                      i % 5 != 0);
+  }
+  return columns;
+}
+
+class ColumnFileDataSourceTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.isValid());
+    path_ = temp_dir_.filePath("points.gqc");
+  }
+
+  QTemporaryDir temp_dir_;
+  QString path_;
+};
+
+}  // namespace
+
+TEST_F(ColumnFileDataSourceTest, EnumPoints) {
+  const auto columns = MakeColumns(100000);
+  ASSERT_TRUE(WriteColumnFile(path_, columns.GetSpans(), 1024));
+
+  ColumnFileDataSource data_source;
+  ASSERT_TRUE(data_source.Open(path_));
+  EXPECT_EQ(data_source.size(), columns.size());
+  EXPECT_EQ(data_source.GetHorizontalRange(), GraphRange(0, 99999));
+  EXPECT_EQ(data_source.GetVerticalRange(), GraphRange(0, 999));
+  EXPECT_EQ(data_source.GetCurrentValue(), 999);
+  EXPECT_EQ(data_source.CountPoints(10, 20, true, false), 10u);
+
+  auto point_enum = data_source.EnumPoints(5000, 7000, true, true);
+  ASSERT_TRUE(point_enum);
+  EXPECT_TRUE(point_enum->SupportsColumns());
+  std::vector<GraphPoint> points;
+  ForEachPoint(*point_enum,
+               [&](const GraphPoint& point) { points.push_back(point); });
+  ASSERT_EQ(points.size(), 2001u);
+  for (size_t i = 0; i < points.size(); ++i) {
+    EXPECT_EQ(points[i], columns.at(5000 + i));
+  }
+}
+
+TEST_F(ColumnFileDataSourceTest, QueryVerticalRangeUsesBlocks) {
+  const auto columns = MakeColumns(100000);
+  ASSERT_TRUE(WriteColumnFile(path_, columns.GetSpans(), 256));
+
+  ColumnFileDataSource data_source;
+  ASSERT_TRUE(data_source.Open(path_));
+  EXPECT_EQ(data_source.QueryVerticalRange(100, 600), GraphRange(100, 599));
+  EXPECT_EQ(data_source.QueryVerticalRange(1100, 1400),
+            GraphRange(100, 399));
+  EXPECT_EQ(data_source.QueryVerticalRange(10, 10), GraphRange{});
+  for (auto [x1, x2] : {std::pair{0, 100000}, {300, 2000}, {999, 1001}}) {
+    auto range = data_source.QueryVerticalRange(x1, x2);
+    ASSERT_TRUE(range);
+    std::vector<double> values(columns.y().begin() + x1,
+                               columns.y().begin() + x2);
+    auto [min, max] = std::ranges::minmax(values);
+    EXPECT_EQ(*range, GraphRange(min, max));
+  }
+}
+
+TEST_F(ColumnFileDataSourceTest, QueryVerticalRangeUsesSummaryTree) {
+  // 2000 blocks of 8 points make two levels above the blocks.
+  PointColumns columns;
+  for (size_t i = 0; i < 16000; ++i) {
+    columns.push_back(static_cast<double>(i), std::sin(i * 0.001) * i, true);
+  }
+  ASSERT_TRUE(WriteColumnFile(path_, columns.GetSpans(), 8));
+
+  ColumnFileDataSource data_source;
+  ASSERT_TRUE(data_source.Open(path_));
+  for (auto [x1, x2] : {std::pair{0, 16000}, {3, 15997}, {129, 4100},
+                        {2047, 2049}, {5000, 5300}}) {
+    auto range = data_source.QueryVerticalRange(x1, x2);
+    ASSERT_TRUE(range);
+    std::vector<double> values(columns.y().begin() + x1,
+                               columns.y().begin() + x2);
+    auto [min, max] = std::ranges::minmax(values);
+    EXPECT_EQ(*range, GraphRange(min, max)) << x1 << " " << x2;
+  }
+}
+
+TEST_F(ColumnFileDataSourceTest, EnumReducedPointsUsesBlocks) {
+  const auto columns = MakeColumns(100000);
+  ASSERT_TRUE(WriteColumnFile(path_, columns.GetSpans(), 64));
+
+  ColumnFileDataSource data_source;
+  ASSERT_TRUE(data_source.Open(path_));
+
+  // Pixel columns narrower than a block give all points.
+  auto point_enum = data_source.EnumReducedPoints(100, 2000, 10);
+  ASSERT_TRUE(point_enum);
+  EXPECT_EQ(point_enum->GetCount(), 1901u);
+
+  // Pixel columns of 10 blocks keep their extremes.
+  const double resolution = 640;
+  point_enum = data_source.EnumReducedPoints(1010, 98990, resolution);
+  ASSERT_TRUE(point_enum);
+  std::vector<GraphPoint> points;
+  ForEachPoint(*point_enum,
+               [&](const GraphPoint& point) { points.push_back(point); });
+  EXPECT_LT(points.size(), 2000u);
+  EXPECT_TRUE(std::ranges::is_sorted(points, {}, &GraphPoint::x));
+  EXPECT_EQ(points.front(), columns.at(1010));
+  EXPECT_EQ(points.back(), columns.at(98990));
+
+  std::map<double, std::pair<double, double>> expected;
+  std::map<double, std::pair<double, double>> reduced;
+  auto add = [&](auto& extremes, const GraphPoint& point) {
+    auto [it, inserted] = extremes.try_emplace(
+        std::floor(point.x / resolution), point.y, point.y);
+    it->second.first = std::min(it->second.first, point.y);
+    it->second.second = std::max(it->second.second, point.y);
+  };
+  for (size_t i = 1010; i <= 98990; ++i) {
+    add(expected, columns.at(i));
+  }
+  for (const auto& point : points) {
+    add(reduced, point);
+  }
+  EXPECT_EQ(reduced, expected);
+
+  // Blocks crossing the pixel column borders are reduced too.
+  point_enum = data_source.EnumReducedPoints(0, 99999, 500);
+  ASSERT_TRUE(point_enum);
+  EXPECT_LT(point_enum->GetCount(), 2000u);
+}
+
+TEST_F(ColumnFileDataSourceTest, RejectsInvalidFiles) {
+  ColumnFileDataSource data_source;
+  EXPECT_FALSE(data_source.Open(temp_dir_.filePath("missing.gqc")));
+
+  {
+    QFile file{path_};
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    std::vector<char> garbage(sizeof(ColumnFileHeader) * 2, 'x');
+    file.write(garbage.data(), garbage.size());
+  }
+  EXPECT_FALSE(data_source.Open(path_));
+  EXPECT_FALSE(data_source.is_open());
+  EXPECT_FALSE(data_source.EnumPoints(0, 1, true, true));
+}
+
+}  // namespace views
@@ -0,0 +1,172 @@
+#include "graph_qt/model/columnar_data_source.h"
+
+#include "graph_qt/model/point_enumerators.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace views {
+
+template <class X, class Y>
+BasicColumnarDataSource<X, Y>::BasicColumnarDataSource(
+    GraphRange::Kind horizontal_kind)
+    : horizontal_kind_{horizontal_kind} {}
+
+template <class X, class Y>
+BasicColumnarDataSource<X, Y>::~BasicColumnarDataSource() = default;
+
+template <class X, class Y>
+void BasicColumnarDataSource<X, Y>::AddPoint(const GraphPoint& point) {
+  AddPoints(std::span{&point, 1});
+}
+
+template <class X, class Y>
+void BasicColumnarDataSource<X, Y>::AddPoints(
+    std::span<const GraphPoint> points) {
+  if (points.empty()) {
+    return;
+  }
+
+  for (const auto& point : points) {
+    Append(GraphValueTraits<X>::FromGraphValue(point.x),
+           GraphValueTraits<Y>::FromGraphValue(point.y), point.good);
+  }
+
+  NotifyPointsAdded();
+}
+
+template <class X, class Y>
+void BasicColumnarDataSource<X, Y>::AddValue(X x, Y y, bool good) {
+  Append(x, y, good);
+  NotifyPointsAdded();
+}
+
+template <class X, class Y>
+void BasicColumnarDataSource<X, Y>::AddValues(std::span<const X> x,
+                                              std::span<const Y> y) {
+  assert(x.size() == y.size());
+  if (x.empty()) {
+    return;
+  }
+
+  for (size_t i = 0; i < x.size(); ++i) {
+    Append(x[i], y[i], true);
+  }
+
+  NotifyPointsAdded();
+}
+
+template <class X, class Y>
+void BasicColumnarDataSource<X, Y>::Append(X x, Y y, bool good) {
+  assert(columns_.empty() || x >= columns_.x().back());
+  if (columns_.empty()) {
+    min_value_ = max_value_ = y;
+  } else {
+    min_value_ = std::min(min_value_, y);
+    max_value_ = std::max(max_value_, y);
+  }
+  columns_.push_back(x, y, good);
+}
+
+template <class X, class Y>
+void BasicColumnarDataSource<X, Y>::NotifyPointsAdded() {
+  if (observer_) {
+    observer_->OnDataSourceCurrentValueChanged();
+    observer_->OnDataSourcePointsAppended();
+  }
+}
+
+template <class X, class Y>
+void BasicColumnarDataSource<X, Y>::Clear() {
+  columns_.clear();
+
+  if (observer_) {
+    observer_->OnDataSourceCurrentValueChanged();
+    observer_->OnDataSourceHistoryChanged();
+  }
+}
+
+template <class X, class Y>
+double BasicColumnarDataSource<X, Y>::GetCurrentValue() const {
+  return columns_.empty()
+             ? kGraphUnknownValue
+             : GraphValueTraits<Y>::ToGraphValue(columns_.y().back());
+}
+
+template <class X, class Y>
+std::unique_ptr<PointEnumerator> BasicColumnarDataSource<X, Y>::EnumPoints(
+    double from,
+    double to,
+    bool include_left_bound,
+    bool include_right_bound) {
+  size_t first =
+      include_left_bound ? FindLowerBound(from) : FindUpperBound(from);
+  size_t last = include_right_bound ? FindUpperBound(to) : FindLowerBound(to);
+  if (first >= last) {
+    return nullptr;
+  }
+
+  return std::make_unique<BasicColumnPointEnumerator<X, Y>>(
+      columns_.GetSpans().subspan(first, last - first));
+}
+
+template <class X, class Y>
+GraphRange BasicColumnarDataSource<X, Y>::GetHorizontalRange() const {
+  if (columns_.empty()) {
+    return GraphRange{};
+  }
+  return GraphRange{GraphValueTraits<X>::ToGraphValue(columns_.x().front()),
+                    GraphValueTraits<X>::ToGraphValue(columns_.x().back()),
+                    horizontal_kind_};
+}
+
+template <class X, class Y>
+GraphRange BasicColumnarDataSource<X, Y>::GetVerticalRange() const {
+  if (columns_.empty()) {
+    return GraphRange{};
+  }
+  return GraphRange{GraphValueTraits<Y>::ToGraphValue(min_value_),
+                    GraphValueTraits<Y>::ToGraphValue(max_value_)};
+}
+
+template <class X, class Y>
+std::optional<size_t> BasicColumnarDataSource<X, Y>::LowerBound(
+    double value) const {
+  return FindLowerBound(value);
+}
+
+template <class X, class Y>
+std::optional<size_t> BasicColumnarDataSource<X, Y>::UpperBound(
+    double value) const {
+  return FindUpperBound(value);
+}
+
+template <class X, class Y>
+std::optional<double> BasicColumnarDataSource<X, Y>::GetPointX(
+    size_t index) const {
+  return GraphValueTraits<X>::ToGraphValue(columns_.x()[index]);
+}
+
+// A stored `x` is at least `value` if it is at least `value` rounded up.
+template <class X, class Y>
+size_t BasicColumnarDataSource<X, Y>::FindLowerBound(double value) const {
+  return std::ranges::lower_bound(columns_.x(),
+                                  GraphValueTraits<X>::Ceil(value)) -
+         columns_.x().begin();
+}
+
+// A stored `x` is greater than `value` if it is greater than `value` rounded
+// down.
+template <class X, class Y>
+size_t BasicColumnarDataSource<X, Y>::FindUpperBound(double value) const {
+  return std::ranges::upper_bound(columns_.x(),
+                                  GraphValueTraits<X>::Floor(value)) -
+         columns_.x().begin();
+}
+
+template class BasicColumnarDataSource<GraphValue, GraphValue>;
+template class BasicColumnarDataSource<GraphValue, float>;
+template class BasicColumnarDataSource<GraphNanoseconds, GraphValue>;
+template class BasicColumnarDataSource<GraphNanoseconds, float>;
+
+}  // namespace views
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "graph_qt/model/graph_data_source.h"
+#include "graph_qt/model/point_columns.h"
+
+#include <span>
+
+namespace views {
+
+// In-memory data source storing points by columns of `X` and `Y` values. Its
+// enumerators give the points as column spans, so reducers like
+// `CalculateAutoRange()` stream over the y array only, instead of arrays of
+// padded `GraphPoint`s.
+//
+// Narrower value types save memory, e.g. `float` values take half the bytes.
+// `GraphNanoseconds` store time exactly, and range searches compare the stored
+// integers, so counts and bounds are exact to the nanosecond. The points
+// handed to the graph are converted to `GraphValue` seconds, which near the
+// current Unix time resolve about 240 ns; enumerators of such columns convert
+// them batch by batch.
+template <class X, class Y>
+class BasicColumnarDataSource : public GraphDataSource {
+ public:
+  using Columns = BasicPointColumns<X, Y>;
+
+  explicit BasicColumnarDataSource(
+      GraphRange::Kind horizontal_kind = GraphRange::LINEAR);
+  ~BasicColumnarDataSource() override;
+
+  const Columns& columns() const { return columns_; }
+  size_t size() const { return columns_.size(); }
+
+  void Reserve(size_t size) { columns_.reserve(size); }
+
+  // Appends points. The points must be sorted by x, and the first one must not
+  // precede the last existing point. Sends a single
+  // `OnDataSourcePointsAppended()`.
+  void AddPoint(const GraphPoint& point);
+  void AddPoints(std::span<const GraphPoint> points);
+
+  // Appends a point of the stored value types without conversion.
+  void AddValue(X x, Y y, bool good);
+
+  // Appends good points given by columns of the stored value types. Sends a
+  // single `OnDataSourcePointsAppended()`.
+  void AddValues(std::span<const X> x, std::span<const Y> y);
+
+  void Clear();
+
+  // GraphDataSource
+  double GetCurrentValue() const override;
+  std::unique_ptr<PointEnumerator> EnumPoints(
+      double from,
+      double to,
+      bool include_left_bound,
+      bool include_right_bound) override;
+  GraphRange GetHorizontalRange() const override;
+  GraphRange GetVerticalRange() const override;
+  std::optional<size_t> LowerBound(double value) const override;
+  std::optional<size_t> UpperBound(double value) const override;
+  std::optional<double> GetPointX(size_t index) const override;
+
+ private:
+  void Append(X x, Y y, bool good);
+  void NotifyPointsAdded();
+
+  size_t FindLowerBound(double value) const;
+  size_t FindUpperBound(double value) const;
+
+  const GraphRange::Kind horizontal_kind_;
+
+  Columns columns_;
+  Y min_value_{};
+  Y max_value_{};
+};
+
+extern template class BasicColumnarDataSource<GraphValue, GraphValue>;
+extern template class BasicColumnarDataSource<GraphValue, float>;
+extern template class BasicColumnarDataSource<GraphNanoseconds, GraphValue>;
+extern template class BasicColumnarDataSource<GraphNanoseconds, float>;
+
+using ColumnarDataSource = BasicColumnarDataSource<GraphValue, GraphValue>;
+
+}  // namespace views
@@ -0,0 +1,129 @@
+#include "graph_qt/model/columnar_data_source.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace views {
+
+namespace {
+
+std::vector<GraphPoint> MakePoints(size_t count) {
+  std::vector<GraphPoint> points;
+  for (size_t i = 0; i < count; ++i) {
+    GraphPoint point{static_cast<double>(i), static_cast<double>(i % 7)};
+    point.good = i % 3 != 0;
+    points.push_back(point);
+  }
+  return points;
+}
+
+}  // namespace
+
+TEST(ColumnarDataSourceTest, EnumColumns) {
+  const auto points = MakePoints(1000);
+  ColumnarDataSource data_source;
+  data_source.AddPoints(points);
+
+  auto point_enum = data_source.EnumPoints(100, 900, true, false);
+  ASSERT_TRUE(point_enum);
+  EXPECT_TRUE(point_enum->SupportsColumns());
+
+  std::vector<GraphPoint> enumerated;
+  ForEachColumns(*point_enum, [&](const PointColumnSpans& columns) {
+    for (size_t i = 0; i < columns.size(); ++i) {
+      enumerated.push_back(columns.at(i));
+    }
+  });
+  EXPECT_EQ(enumerated, std::vector<GraphPoint>(points.begin() + 100,
+                                                points.begin() + 900));
+}
+
+TEST(ColumnarDataSourceTest, EnumPoints) {
+  const auto points = MakePoints(1000);
+  ColumnarDataSource data_source;
+  data_source.AddPoints(points);
+
+  EXPECT_EQ(data_source.GetHorizontalRange(), GraphRange(0, 999));
+  EXPECT_EQ(data_source.GetVerticalRange(), GraphRange(0, 6));
+  EXPECT_EQ(data_source.CountPoints(10, 20, false, true), 10u);
+  EXPECT_EQ(data_source.CalculateAutoRange(0, 3), GraphRange(0, 2));
+
+  auto point_enum = data_source.EnumPoints(0, 999, true, true);
+  std::vector<GraphPoint> enumerated;
+  ForEachPoint(*point_enum,
+               [&](const GraphPoint& point) { enumerated.push_back(point); });
+  EXPECT_EQ(enumerated, points);
+}
+
+TEST(ColumnarDataSourceTest, ColumnsOfPointEnumerator) {
+  // Enumerators without columns are transposed.
+  const auto points = MakePoints(1000);
+  ColumnarDataSource data_source;
+  data_source.AddPoints(points);
+  auto point_enum = data_source.EnumSteppedPoints(0, 999, 1);
+
+  std::vector<GraphPoint> enumerated;
+  ForEachColumns(*point_enum, [&](const PointColumnSpans& columns) {
+    for (size_t i = 0; i < columns.size(); ++i) {
+      enumerated.push_back(columns.at(i));
+    }
+  });
+  EXPECT_EQ(enumerated, points);
+}
+
+TEST(ColumnarDataSourceTest, NanosecondTimeAndFloatValues) {
+  using namespace std::chrono_literals;
+  using DataSource = BasicColumnarDataSource<GraphNanoseconds, float>;
+
+  // Nanoseconds of a Unix time are beyond the precision of doubles.
+  const GraphNanoseconds start = 1'700'000'000s;
+  DataSource data_source;
+  for (int i = 0; i < 1000; ++i) {
+    data_source.AddValue(start + i * 1ns, i * 0.5f, true);
+  }
+
+  EXPECT_EQ(data_source.columns().x()[1] - data_source.columns().x()[0], 1ns);
+  EXPECT_EQ(data_source.GetVerticalRange(), GraphRange(0, 499.5));
+  EXPECT_EQ(data_source.GetCurrentValue(), 499.5);
+
+  // The range is converted to seconds.
+  auto range = data_source.GetHorizontalRange();
+  EXPECT_DOUBLE_EQ(range.low(), 1'700'000'000);
+  EXPECT_NEAR(range.high(), 1'700'000'000 + 999e-9, 1e-6);
+
+  auto point_enum = data_source.EnumPoints(0, 2e9, true, true);
+  ASSERT_TRUE(point_enum);
+  EXPECT_EQ(point_enum->GetCount(), 1000u);
+
+  // Columns are converted to seconds batch by batch.
+  ASSERT_TRUE(point_enum->SupportsColumns());
+  size_t count = 0;
+  PointColumnSpans columns;
+  while (point_enum->EnumNextColumns(columns)) {
+    EXPECT_LE(columns.size(), kPointBatchSize);
+    for (size_t i = 0; i < columns.size(); ++i, ++count) {
+      EXPECT_EQ(columns.y[i], count * 0.5);
+      EXPECT_TRUE(columns.good(i));
+    }
+  }
+  EXPECT_EQ(count, 1000u);
+
+  EXPECT_EQ(data_source.CountPoints(1'700'000'000, 1'700'000'000, true, true),
+            1u);
+  EXPECT_EQ(data_source.CalculateAutoRange(0, 2e9), GraphRange(0, 499.5));
+}
+
+TEST(ColumnarDataSourceTest, ValueTraitsRounding) {
+  using FloatTraits = GraphValueTraits<float>;
+  EXPECT_GE(FloatTraits::Ceil(0.1), 0.1);
+  EXPECT_LE(FloatTraits::Floor(0.1), 0.1);
+  EXPECT_EQ(FloatTraits::Ceil(0.5), 0.5f);
+
+  using TimeTraits = GraphValueTraits<GraphNanoseconds>;
+  EXPECT_EQ(TimeTraits::Ceil(1.5e-9), GraphNanoseconds{2});
+  EXPECT_EQ(TimeTraits::Floor(1.5e-9), GraphNanoseconds{1});
+  EXPECT_EQ(TimeTraits::FromGraphValue(1.6e-9), GraphNanoseconds{2});
+}
+
+}  // namespace views
@@ -0,0 +1,364 @@
+#include "graph_qt/model/compressed_data_source.h"
+
+#include "graph_qt/model/point_codec.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <limits>
+
+namespace views {
+
+namespace {
+
+using Chunk = CompressedDataSource::Chunk;
+using ChunkHeader = CompressedDataSource::ChunkHeader;
+
+// Returns the distinct points of the header sorted by x, which keep the
+// extremes of the chunk at their positions.
+std::vector<GraphPoint> GetHeaderPoints(const ChunkHeader& header) {
+  std::vector<GraphPoint> points{header.first, header.min, header.max,
+                                 header.last};
+  std::ranges::stable_sort(points, {}, &GraphPoint::x);
+  auto [first, last] = std::ranges::unique(points);
+  points.erase(first, last);
+  return points;
+}
+
+bool IsReduced(const ChunkHeader& header, double resolution) {
+  return header.last.x - header.first.x < resolution;
+}
+
+void DecodeChunk(const Chunk& chunk, std::vector<GraphPoint>& points) {
+  PointDecoder decoder{chunk.data, chunk.header.count};
+  points.resize(chunk.header.count);
+  for (auto& point : points) {
+    decoder.Next(point);
+  }
+}
+
+// Enumerates the decoded points of the boundary chunks, the sealed chunks
+// between them, and the points of the active chunk. The sealed chunks are
+// decoded one at a time when the enumeration reaches them.
+class ChunkPointEnumerator : public PointEnumerator {
+ public:
+  ChunkPointEnumerator(std::vector<GraphPoint> head,
+                       std::span<const Chunk> chunks,
+                       std::vector<GraphPoint> tail,
+                       std::span<const GraphPoint> active,
+                       double resolution)
+      : head_{std::move(head)},
+        chunks_{chunks},
+        tail_{std::move(tail)},
+        active_{active},
+        resolution_{resolution} {
+    count_ = head_.size() + tail_.size() + active_.size();
+    for (const auto& chunk : chunks_) {
+      count_ += IsReduced(chunk.header, resolution_)
+                    ? chunk.header.reduced_count
+                    : chunk.header.count;
+    }
+  }
+
+  size_t GetCount() const override { return count_; }
+
+  bool EnumNext(GraphPoint& value) override {
+    return EnumNextBatch(std::span{&value, 1}) == 1;
+  }
+
+  size_t EnumNextBatch(std::span<GraphPoint> points) override {
+    if (current_.empty() && !Advance()) {
+      return 0;
+    }
+    size_t count = std::min(points.size(), current_.size());
+    std::copy_n(current_.begin(), count, points.begin());
+    current_ = current_.subspan(count);
+    count_ -= count;
+    return count;
+  }
+
+ private:
+  enum class Stage { kHead, kChunks, kTail, kActive, kDone };
+
+  // Moves to the next non-empty part. Returns false at the end.
+  bool Advance() {
+    while (current_.empty()) {
+      switch (stage_) {
+        case Stage::kHead:
+          current_ = head_;
+          stage_ = Stage::kChunks;
+          break;
+        case Stage::kChunks:
+          if (chunks_.empty()) {
+            stage_ = Stage::kTail;
+            break;
+          }
+          if (IsReduced(chunks_.front().header, resolution_)) {
+            buffer_ = GetHeaderPoints(chunks_.front().header);
+          } else {
+            DecodeChunk(chunks_.front(), buffer_);
+          }
+          chunks_ = chunks_.subspan(1);
+          current_ = buffer_;
+          break;
+        case Stage::kTail:
+          current_ = tail_;
+          stage_ = Stage::kActive;
+          break;
+        case Stage::kActive:
+          current_ = active_;
+          stage_ = Stage::kDone;
+          break;
+        case Stage::kDone:
+          return false;
+      }
+    }
+    return true;
+  }
+
+  const std::vector<GraphPoint> head_;
+  std::span<const Chunk> chunks_;
+  const std::vector<GraphPoint> tail_;
+  const std::span<const GraphPoint> active_;
+  const double resolution_;
+
+  size_t count_ = 0;
+  Stage stage_ = Stage::kHead;
+  std::span<const GraphPoint> current_;
+  std::vector<GraphPoint> buffer_;
+};
+
+}  // namespace
+
+CompressedDataSource::CompressedDataSource(size_t chunk_size,
+                                           GraphRange::Kind horizontal_kind)
+    : chunk_size_{chunk_size}, horizontal_kind_{horizontal_kind} {
+  assert(chunk_size_ > 0);
+  active_chunk_.reserve(chunk_size_);
+}
+
+CompressedDataSource::~CompressedDataSource() = default;
+
+size_t CompressedDataSource::size() const {
+  return sealed_chunks_.size() * chunk_size_ + active_chunk_.size();
+}
+
+size_t CompressedDataSource::GetMemoryUsage() const {
+  size_t size = active_chunk_.capacity() * sizeof(GraphPoint);
+  for (const auto& chunk : sealed_chunks_) {
+    size += chunk.data.size() * sizeof(uint64_t);
+  }
+  return size;
+}
+
+void CompressedDataSource::AddPoint(const GraphPoint& point) {
+  AddPoints(std::span{&point, 1});
+}
+
+void CompressedDataSource::AddPoints(std::span<const GraphPoint> points) {
+  if (points.empty()) {
+    return;
+  }
+
+  for (const auto& point : points) {
+    assert(active_chunk_.empty() || point.x >= active_chunk_.back().x);
+    vertical_range_ =
+        size() == 0 ? GraphRange{point.y, point.y}
+                    : GraphRange{std::min(vertical_range_.low(), point.y),
+                                 std::max(vertical_range_.high(), point.y)};
+    active_chunk_.push_back(point);
+    if (active_chunk_.size() == chunk_size_) {
+      Seal();
+    }
+  }
+
+  if (observer_) {
+    observer_->OnDataSourceCurrentValueChanged();
+    observer_->OnDataSourcePointsAppended();
+  }
+}
+
+void CompressedDataSource::Seal() {
+  Chunk chunk;
+  chunk.header.count = active_chunk_.size();
+  chunk.header.first = active_chunk_.front();
+  chunk.header.last = active_chunk_.back();
+  chunk.header.min =
+      *std::ranges::min_element(active_chunk_, {}, &GraphPoint::y);
+  chunk.header.max =
+      *std::ranges::max_element(active_chunk_, {}, &GraphPoint::y);
+  chunk.header.reduced_count = GetHeaderPoints(chunk.header).size();
+
+  PointEncoder encoder;
+  for (const auto& point : active_chunk_) {
+    encoder.Append(point);
+  }
+  chunk.data = encoder.Finish();
+
+  sealed_chunks_.push_back(std::move(chunk));
+  active_chunk_.clear();
+}
+
+void CompressedDataSource::Clear() {
+  sealed_chunks_.clear();
+  active_chunk_.clear();
+  vertical_range_ = GraphRange{};
+
+  if (observer_) {
+    observer_->OnDataSourceCurrentValueChanged();
+    observer_->OnDataSourceHistoryChanged();
+  }
+}
+
+double CompressedDataSource::GetCurrentValue() const {
+  if (!active_chunk_.empty()) {
+    return active_chunk_.back().y;
+  }
+  if (!sealed_chunks_.empty()) {
+    return sealed_chunks_.back().header.last.y;
+  }
+  return kGraphUnknownValue;
+}
+
+std::unique_ptr<PointEnumerator> CompressedDataSource::EnumPoints(
+    double from,
+    double to,
+    bool include_left_bound,
+    bool include_right_bound) {
+  return EnumChunkPoints(from, to, include_left_bound, include_right_bound,
+                         /*resolution=*/0);
+}
+
+std::unique_ptr<PointEnumerator> CompressedDataSource::EnumReducedPoints(
+    double from,
+    double to,
+    double resolution) {
+  return EnumChunkPoints(from, to, true, true, resolution);
+}
+
+std::unique_ptr<PointEnumerator> CompressedDataSource::EnumChunkPoints(
+    double from,
+    double to,
+    bool include_left_bound,
+    bool include_right_bound,
+    double resolution) const {
+  auto is_after_from = [&](double x) {
+    return include_left_bound ? x >= from : x > from;
+  };
+  auto is_before_to = [&](double x) {
+    return include_right_bound ? x <= to : x < to;
+  };
+
+  auto decode_in_range = [&](const Chunk& chunk) {
+    std::vector<GraphPoint> points;
+    DecodeChunk(chunk, points);
+    std::erase_if(points, [&](const GraphPoint& point) {
+      return !is_after_from(point.x) || !is_before_to(point.x);
+    });
+    return points;
+  };
+
+  // Chunks overlapping the range.
+  std::span<const Chunk> chunks{sealed_chunks_};
+  auto first_chunk = std::ranges::partition_point(chunks, [&](const auto& c) {
+    return !is_after_from(c.header.last.x);
+  });
+  auto last_chunk = std::ranges::partition_point(chunks, [&](const auto& c) {
+    return is_before_to(c.header.first.x);
+  });
+  if (last_chunk < first_chunk) {
+    last_chunk = first_chunk;
+  }
+
+  // Decode the boundary chunks partially covered by the range.
+  std::vector<GraphPoint> head;
+  if (first_chunk != last_chunk &&
+      !is_after_from(first_chunk->header.first.x)) {
+    head = decode_in_range(*first_chunk++);
+  }
+  std::vector<GraphPoint> tail;
+  if (first_chunk != last_chunk &&
+      !is_before_to(std::prev(last_chunk)->header.last.x)) {
+    tail = decode_in_range(*--last_chunk);
+  }
+
+  auto first_point = std::ranges::partition_point(
+      active_chunk_, [&](const auto& p) { return !is_after_from(p.x); });
+  auto last_point = std::ranges::partition_point(
+      active_chunk_, [&](const auto& p) { return is_before_to(p.x); });
+  if (last_point < first_point) {
+    last_point = first_point;
+  }
+
+  auto point_enum = std::make_unique<ChunkPointEnumerator>(
+      std::move(head), std::span{first_chunk, last_chunk}, std::move(tail),
+      std::span{first_point, last_point}, resolution);
+  if (point_enum->GetCount() == 0) {
+    return nullptr;
+  }
+  return point_enum;
+}
+
+GraphRange CompressedDataSource::GetHorizontalRange() const {
+  if (size() == 0) {
+    return GraphRange{};
+  }
+  double low = sealed_chunks_.empty() ? active_chunk_.front().x
+                                      : sealed_chunks_.front().header.first.x;
+  double high = active_chunk_.empty() ? sealed_chunks_.back().header.last.x
+                                      : active_chunk_.back().x;
+  return GraphRange{low, high, horizontal_kind_};
+}
+
+GraphRange CompressedDataSource::GetVerticalRange() const {
+  return vertical_range_;
+}
+
+std::span<const CompressedDataSource::Chunk> CompressedDataSource::FindChunks(
+    double from,
+    double to) const {
+  std::span<const Chunk> chunks{sealed_chunks_};
+  auto first_chunk = std::ranges::partition_point(
+      chunks, [&](const Chunk& c) { return c.header.last.x < from; });
+  auto last_chunk = std::ranges::partition_point(
+      chunks, [&](const Chunk& c) { return c.header.first.x < to; });
+  return std::span{first_chunk, std::max(first_chunk, last_chunk)};
+}
+
+std::optional<GraphRange> CompressedDataSource::QueryVerticalRange(
+    double x1,
+    double x2) const {
+  double low = std::numeric_limits<double>::max();
+  double high = std::numeric_limits<double>::lowest();
+  auto add_point = [&](const GraphPoint& point) {
+    if (point.x >= x1 && point.x < x2) {
+      low = std::min(low, point.y);
+      high = std::max(high, point.y);
+    }
+  };
+
+  // Chunks inside the range contribute the extremes of their headers, and
+  // only the boundary chunks are decoded.
+  std::vector<GraphPoint> points;
+  for (const auto& chunk : FindChunks(x1, x2)) {
+    if (chunk.header.first.x >= x1 && chunk.header.last.x < x2) {
+      low = std::min(low, chunk.header.min.y);
+      high = std::max(high, chunk.header.max.y);
+    } else {
+      DecodeChunk(chunk, points);
+      std::ranges::for_each(points, add_point);
+    }
+  }
+  auto first_point = std::ranges::partition_point(
+      active_chunk_, [&](const GraphPoint& p) { return p.x < x1; });
+  auto last_point = std::ranges::partition_point(
+      active_chunk_, [&](const GraphPoint& p) { return p.x < x2; });
+  std::for_each(first_point, std::max(first_point, last_point), add_point);
+
+  if (low > high) {
+    return GraphRange{};
+  }
+  return GraphRange{low, high};
+}
+
+}  // namespace views
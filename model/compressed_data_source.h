@@ -0,0 +1,101 @@
+#pragma once
+
+#include "graph_qt/model/graph_data_source.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace views {
+
+// Data source for long histories, keeping points in chunks of `chunk_size`.
+// The active chunk receiving appended points is uncompressed. Full chunks are
+// sealed by compressing them with `PointEncoder` and decompressed on the fly
+// during enumeration.
+//
+// Every sealed chunk keeps a header with its count, boundary points and
+// extremes. Chunks outside the requested range are skipped by a binary search
+// over the headers, and chunks narrower than the drawing resolution are
+// reduced to the points of their header, so neither is decoded.
+class CompressedDataSource : public GraphDataSource {
+ public:
+  static constexpr size_t kDefaultChunkSize = 1024;
+
+  struct ChunkHeader {
+    size_t count = 0;
+    GraphPoint first;
+    GraphPoint last;
+    // Points with the minimum and the maximum value. On equal values keeps the
+    // first point.
+    GraphPoint min;
+    GraphPoint max;
+    // Number of distinct points among the above, enumerated for a reduced
+    // chunk.
+    size_t reduced_count = 0;
+  };
+
+  struct Chunk {
+    ChunkHeader header;
+    std::vector<uint64_t> data;
+  };
+
+  explicit CompressedDataSource(
+      size_t chunk_size = kDefaultChunkSize,
+      GraphRange::Kind horizontal_kind = GraphRange::LINEAR);
+  ~CompressedDataSource() override;
+
+  size_t size() const;
+
+  const std::vector<Chunk>& sealed_chunks() const { return sealed_chunks_; }
+
+  // Returns the number of bytes taken by the points, excluding headers.
+  size_t GetMemoryUsage() const;
+
+  // Appends points. The points must be sorted by x, and the first one must not
+  // precede the last existing point. Sends a single
+  // `OnDataSourcePointsAppended()`.
+  void AddPoint(const GraphPoint& point);
+  void AddPoints(std::span<const GraphPoint> points);
+
+  void Clear();
+
+  // GraphDataSource
+  double GetCurrentValue() const override;
+  std::unique_ptr<PointEnumerator> EnumPoints(
+      double from,
+      double to,
+      bool include_left_bound,
+      bool include_right_bound) override;
+  std::unique_ptr<PointEnumerator> EnumReducedPoints(
+      double from,
+      double to,
+      double resolution) override;
+  GraphRange GetHorizontalRange() const override;
+  GraphRange GetVerticalRange() const override;
+  std::optional<GraphRange> QueryVerticalRange(double x1,
+                                               double x2) const override;
+
+ private:
+  // Enumerates the points of the range, replacing the points of sealed chunks
+  // narrower than `resolution` and inside the range by their header points.
+  std::unique_ptr<PointEnumerator> EnumChunkPoints(double from,
+                                                   double to,
+                                                   bool include_left_bound,
+                                                   bool include_right_bound,
+                                                   double resolution) const;
+
+  void Seal();
+
+  // Returns the sealed chunks overlapping `[from, to)`.
+  std::span<const Chunk> FindChunks(double from, double to) const;
+
+  const size_t chunk_size_;
+  const GraphRange::Kind horizontal_kind_;
+
+  std::vector<Chunk> sealed_chunks_;
+  std::vector<GraphPoint> active_chunk_;
+
+  GraphRange vertical_range_;
+};
+
+}  // namespace views
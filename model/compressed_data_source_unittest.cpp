@@ -0,0 +1,95 @@
+#include "graph_qt/model/compressed_data_source.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace views {
+
+namespace {
+
+std::vector<GraphPoint> MakePoints(size_t count) {
+  std::vector<GraphPoint> points;
+  for (size_t i = 0; i < count; ++i) {
+    points.emplace_back(static_cast<double>(i),
+                        std::round(std::sin(i / 100.0) * 100) / 10);
+  }
+  return points;
+}
+
+std::vector<GraphPoint> EnumAllPoints(
+    std::unique_ptr<PointEnumerator> point_enum) {
+  std::vector<GraphPoint> points;
+  if (point_enum) {
+    size_t count = point_enum->GetCount();
+    ForEachPoint(*point_enum,
+                 [&](const GraphPoint& point) { points.push_back(point); });
+    EXPECT_EQ(points.size(), count);
+  }
+  return points;
+}
+
+}  // namespace
+
+TEST(CompressedDataSourceTest, EnumPoints) {
+  const auto points = MakePoints(10000);
+  CompressedDataSource data_source{/*chunk_size=*/1000};
+  data_source.AddPoints(points);
+
+  EXPECT_EQ(data_source.sealed_chunks().size(), 10u);
+  EXPECT_EQ(data_source.size(), points.size());
+  EXPECT_LT(data_source.GetMemoryUsage(),
+            points.size() * sizeof(GraphPoint) / 2);
+  EXPECT_EQ(data_source.GetHorizontalRange(), GraphRange(0, 9999));
+  EXPECT_EQ(data_source.GetVerticalRange(), GraphRange(-10, 10));
+
+  EXPECT_EQ(EnumAllPoints(data_source.EnumPoints(0, 9999, true, true)),
+            points);
+  EXPECT_EQ(EnumAllPoints(data_source.EnumPoints(1500, 4000, false, true)),
+            std::vector<GraphPoint>(points.begin() + 1501,
+                                    points.begin() + 4001));
+  EXPECT_EQ(EnumAllPoints(data_source.EnumPoints(1200, 1300, true, false)),
+            std::vector<GraphPoint>(points.begin() + 1200,
+                                    points.begin() + 1300));
+  EXPECT_FALSE(data_source.EnumPoints(20000, 30000, true, true));
+}
+
+TEST(CompressedDataSourceTest, ActiveChunk) {
+  const auto points = MakePoints(2500);
+  CompressedDataSource data_source{/*chunk_size=*/1000};
+  data_source.AddPoints(points);
+
+  EXPECT_EQ(data_source.sealed_chunks().size(), 2u);
+  EXPECT_EQ(data_source.GetCurrentValue(), points.back().y);
+  EXPECT_EQ(EnumAllPoints(data_source.EnumPoints(1900, 2100, true, true)),
+            std::vector<GraphPoint>(points.begin() + 1900,
+                                    points.begin() + 2101));
+}
+
+TEST(CompressedDataSourceTest, ReducedChunksUseHeaders) {
+  const auto points = MakePoints(10000);
+  CompressedDataSource data_source{/*chunk_size=*/100};
+  data_source.AddPoints(points);
+
+  // Every chunk inside the range is reduced to its header points.
+  auto reduced = EnumAllPoints(data_source.EnumReducedPoints(0, 9999, 1000));
+  EXPECT_LE(reduced.size(), 100u * 4);
+  EXPECT_EQ(data_source.EnumReducedPoints(0, 9999, 1000)->GetCount(),
+            reduced.size());
+  EXPECT_TRUE(std::ranges::is_sorted(reduced, {}, &GraphPoint::x));
+
+  for (const auto& chunk : data_source.sealed_chunks()) {
+    const auto& header = chunk.header;
+    EXPECT_EQ(header.count, 100u);
+    EXPECT_NE(std::ranges::find(reduced, header.min), reduced.end());
+    EXPECT_NE(std::ranges::find(reduced, header.max), reduced.end());
+  }
+
+  EXPECT_EQ(data_source.QueryVerticalRange(0, 158), GraphRange(0, 10));
+  EXPECT_EQ(data_source.QueryVerticalRange(150, 160),
+            data_source.CalculateAutoRange(150, 160));
+}
+
+}  // namespace views
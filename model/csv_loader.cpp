@@ -0,0 +1,313 @@
+#include "graph_qt/model/csv_loader.h"
+
+#include <algorithm>
+#include <cassert>
+#include <charconv>
+#include <chrono>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#endif
+
+namespace views {
+
+namespace {
+
+std::string_view Trim(std::string_view text) {
+  constexpr std::string_view kSpaces = " \t";
+  size_t first = text.find_first_not_of(kSpaces);
+  if (first == std::string_view::npos) {
+    return {};
+  }
+  return text.substr(first, text.find_last_not_of(kSpaces) - first + 1);
+}
+
+bool ParseNumber(std::string_view text, double& value) {
+  auto [end, error] =
+      std::from_chars(text.data(), text.data() + text.size(), value);
+  return error == std::errc{} && end == text.data() + text.size();
+}
+
+// Parses exactly `digits` decimal digits at the start of `text`.
+bool ConsumeDigits(std::string_view& text, size_t digits, int& value) {
+  if (text.size() < digits) {
+    return false;
+  }
+  auto [end, error] = std::from_chars(text.data(), text.data() + digits, value);
+  if (error != std::errc{} || end != text.data() + digits) {
+    return false;
+  }
+  text.remove_prefix(digits);
+  return true;
+}
+
+bool ConsumeChar(std::string_view& text, std::string_view chars) {
+  if (text.empty() || chars.find(text.front()) == std::string_view::npos) {
+    return false;
+  }
+  text.remove_prefix(1);
+  return true;
+}
+
+// Parses `YYYY-MM-DD[T ]hh:mm:ss[.fff][Z]` to seconds since the epoch.
+bool ParseIsoDateTime(std::string_view text, double& value) {
+  int year, month, day, hour, minute, second;
+  if (!ConsumeDigits(text, 4, year) || !ConsumeChar(text, "-") ||
+      !ConsumeDigits(text, 2, month) || !ConsumeChar(text, "-") ||
+      !ConsumeDigits(text, 2, day) || !ConsumeChar(text, "T ") ||
+      !ConsumeDigits(text, 2, hour) || !ConsumeChar(text, ":") ||
+      !ConsumeDigits(text, 2, minute) || !ConsumeChar(text, ":") ||
+      !ConsumeDigits(text, 2, second)) {
+    return false;
+  }
+
+  if (!text.empty() && text.back() == 'Z') {
+    text.remove_suffix(1);
+  }
+  double fraction = 0;
+  if (!text.empty() && (text.front() != '.' || !ParseNumber(text, fraction))) {
+    return false;
+  }
+
+  const std::chrono::year_month_day date{std::chrono::year{year},
+                                         std::chrono::month(month),
+                                         std::chrono::day(day)};
+  if (!date.ok() || hour > 23 || minute > 59 || second > 60) {
+    return false;
+  }
+
+  const std::chrono::seconds time =
+      std::chrono::sys_days{date}.time_since_epoch() +
+      std::chrono::hours{hour} + std::chrono::minutes{minute} +
+      std::chrono::seconds{second};
+  value = static_cast<double>(time.count()) + fraction;
+  return true;
+}
+
+// Removes the first line of `text` and returns it without the line break.
+std::string_view ConsumeLine(std::string_view& text) {
+  size_t end = text.find('\n');
+  std::string_view line = text.substr(0, end);
+  text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+  if (!line.empty() && line.back() == '\r') {
+    line.remove_suffix(1);
+  }
+  return line;
+}
+
+}  // namespace
+
+CsvLoader::CsvLoader(ColumnarDataSource& data_source,
+                     const Options& options,
+                     Wake wake)
+    : data_source_{data_source}, options_{options}, wake_{std::move(wake)} {
+  assert(options_.chunk_size > 0);
+}
+
+CsvLoader::~CsvLoader() {
+  Stop();
+}
+
+bool CsvLoader::Start(const QString& path) {
+  assert(!data_);
+
+  file_.setFileName(path);
+  if (!file_.open(QIODevice::ReadOnly)) {
+    return false;
+  }
+
+  const auto file_size = static_cast<size_t>(file_.size());
+  if (file_size == 0) {
+    file_.close();
+    finished_ = true;
+    return true;
+  }
+
+  data_ = file_.map(0, file_.size());
+  if (!data_) {
+    file_.close();
+    return false;
+  }
+
+#if defined(__unix__) || defined(__APPLE__)
+  // Every byte is read once, front to back within each chunk.
+  madvise(data_, file_size, MADV_SEQUENTIAL);
+#endif
+
+  std::string_view text{reinterpret_cast<const char*>(data_), file_size};
+  for (size_t i = 0; i < options_.skip_lines; ++i) {
+    ConsumeLine(text);
+  }
+  SplitChunks(text);
+
+  // No worker would wake the owner for a file holding only skipped lines.
+  if (chunk_count_ == 0) {
+    Stop();
+    finished_ = true;
+    return true;
+  }
+
+  size_t thread_count = options_.thread_count;
+  if (thread_count == 0) {
+    thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+  thread_count = std::min(thread_count, chunk_count_);
+  for (size_t i = 0; i < thread_count; ++i) {
+    workers_.emplace_back(&CsvLoader::RunWorker, this);
+  }
+  return true;
+}
+
+void CsvLoader::SplitChunks(std::string_view text) {
+  // Each chunk ends at the first line break after `chunk_size` bytes.
+  std::vector<std::string_view> texts;
+  while (!text.empty()) {
+    size_t end = text.find('\n', std::min(options_.chunk_size, text.size()));
+    end = end == std::string_view::npos ? text.size() : end + 1;
+    texts.push_back(text.substr(0, end));
+    text.remove_prefix(end);
+  }
+
+  total_size_ = 0;
+  chunk_count_ = texts.size();
+  chunks_ = std::make_unique<Chunk[]>(chunk_count_);
+  for (size_t i = 0; i < chunk_count_; ++i) {
+    chunks_[i].text = texts[i];
+    total_size_ += texts[i].size();
+  }
+}
+
+void CsvLoader::RunWorker() {
+  // Chunks are taken in file order, so the chunks delivered first are parsed
+  // first.
+  for (size_t index = next_chunk_++; index < chunk_count_;
+       index = next_chunk_++) {
+    if (cancelled_.load(std::memory_order_relaxed)) {
+      return;
+    }
+
+    Chunk& chunk = chunks_[index];
+    ParseChunk(chunk);
+    chunk.parsed.store(true, std::memory_order_release);
+    parsed_size_.fetch_add(chunk.text.size(), std::memory_order_relaxed);
+
+    if (wake_ && !deliver_pending_.exchange(true)) {
+      wake_();
+    }
+  }
+}
+
+void CsvLoader::ParseChunk(Chunk& chunk) const {
+  std::string_view text = chunk.text;
+  while (!text.empty()) {
+    std::string_view line = ConsumeLine(text);
+    if (Trim(line).empty()) {
+      continue;
+    }
+
+    GraphValue x, y;
+    if (!ParseLine(line, options_, x, y) ||
+        (!chunk.x.empty() && x < chunk.x.back())) {
+      ++chunk.skipped_line_count;
+      continue;
+    }
+    chunk.x.push_back(x);
+    chunk.y.push_back(y);
+  }
+}
+
+// static
+bool CsvLoader::ParseLine(std::string_view line,
+                          const Options& options,
+                          GraphValue& x,
+                          GraphValue& y) {
+  const size_t last_column = std::max(options.x_column, options.y_column);
+  bool has_x = false;
+  bool has_y = false;
+  for (size_t column = 0; column <= last_column; ++column) {
+    size_t end = line.find(options.delimiter);
+    std::string_view field = Trim(line.substr(0, end));
+
+    if (column == options.x_column) {
+      has_x = options.x_format == TimeFormat::kIsoDateTime
+                  ? ParseIsoDateTime(field, x)
+                  : ParseNumber(field, x);
+    }
+    if (column == options.y_column) {
+      has_y = ParseNumber(field, y);
+    }
+
+    if (end == std::string_view::npos) {
+      break;
+    }
+    line.remove_prefix(end + 1);
+  }
+  return has_x && has_y;
+}
+
+size_t CsvLoader::Deliver() {
+  deliver_pending_.store(false);
+
+  size_t count = 0;
+  for (; delivered_count_ < chunk_count_ &&
+         chunks_[delivered_count_].parsed.load(std::memory_order_acquire);
+       ++delivered_count_) {
+    Chunk& chunk = chunks_[delivered_count_];
+
+    // Drop points preceding the points already in the data source.
+    std::span<const GraphValue> x = chunk.x;
+    std::span<const GraphValue> y = chunk.y;
+    if (data_source_.size() != 0) {
+      size_t first =
+          std::ranges::lower_bound(x, data_source_.columns().x().back()) -
+          x.begin();
+      x = x.subspan(first);
+      y = y.subspan(first);
+      chunk.skipped_line_count += first;
+    }
+
+    data_source_.AddValues(x, y);
+    count += x.size();
+    skipped_line_count_ += chunk.skipped_line_count;
+
+    chunk.x = std::vector<GraphValue>();
+    chunk.y = std::vector<GraphValue>();
+  }
+
+  if (data_ && delivered_count_ == chunk_count_) {
+    finished_ = true;
+    Stop();
+  }
+  return count;
+}
+
+void CsvLoader::Cancel() {
+  Stop();
+}
+
+void CsvLoader::Stop() {
+  cancelled_ = true;
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+
+  chunks_.reset();
+  chunk_count_ = delivered_count_;
+
+  if (data_) {
+    file_.unmap(data_);
+    data_ = nullptr;
+  }
+  file_.close();
+}
+
+double CsvLoader::progress() const {
+  if (total_size_ == 0) {
+    return 1.0;
+  }
+  return static_cast<double>(parsed_size_.load(std::memory_order_relaxed)) /
+         static_cast<double>(total_size_);
+}
+
+}  // namespace views
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "graph_qt/model/columnar_data_source.h"
+
+#include <QFile>
+#include <QString>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace views {
+
+// Loads points from a CSV or other delimited text file into a
+// `ColumnarDataSource`. The file is mapped and split at line boundaries into
+// chunks, which worker threads parse in parallel with `std::from_chars()`.
+//
+// Parsed chunks are appended to the data source in file order by `Deliver()`
+// on the thread owning the data source, so the beginning of the file can be
+// viewed while the rest is still being parsed. `wake` is called on a worker
+// thread when a chunk is parsed and no delivery is pending, so the owner can
+// schedule a `Deliver()`.
+//
+// The x values must be sorted. Lines without a valid x and y, or with an x
+// preceding the previous line, are skipped and counted. Quoted fields aren't
+// supported.
+class CsvLoader {
+ public:
+  enum class TimeFormat {
+    // A number, e.g. seconds since the epoch.
+    kNumber,
+    // ISO 8601 date and time in UTC, e.g. `2024-05-01T12:30:00.250Z`, loaded
+    // as seconds since the epoch.
+    kIsoDateTime,
+  };
+
+  struct Options {
+    char delimiter = ',';
+    size_t x_column = 0;
+    size_t y_column = 1;
+    TimeFormat x_format = TimeFormat::kNumber;
+    // Number of header lines at the start of the file.
+    size_t skip_lines = 1;
+    // Number of worker threads, zero for one per core.
+    size_t thread_count = 0;
+    // Approximate size of the chunks in bytes.
+    size_t chunk_size = 4 << 20;
+  };
+
+  using Wake = std::function<void()>;
+
+  CsvLoader(ColumnarDataSource& data_source,
+            const Options& options,
+            Wake wake = {});
+  // Cancels the loading.
+  ~CsvLoader();
+
+  CsvLoader(const CsvLoader&) = delete;
+  CsvLoader& operator=(const CsvLoader&) = delete;
+
+  // Maps the file at `path` and starts the worker threads. Returns false if
+  // the file can't be mapped.
+  bool Start(const QString& path);
+
+  // Stops the worker threads. Points delivered so far stay in the data
+  // source.
+  void Cancel();
+
+  // Appends the parsed chunks following the delivered ones to the data
+  // source. Returns the number of appended points.
+  size_t Deliver();
+
+  // True when the whole file is delivered.
+  bool finished() const { return finished_; }
+
+  // Fraction of the file parsed, from 0 to 1. Thread-safe.
+  double progress() const;
+
+  uint64_t skipped_line_count() const { return skipped_line_count_; }
+
+  // Parses a line of the format of `options`, without the line break.
+  // Returns false if the line has no valid x and y.
+  static bool ParseLine(std::string_view line,
+                        const Options& options,
+                        GraphValue& x,
+                        GraphValue& y);
+
+ private:
+  struct Chunk {
+    std::string_view text;
+    std::vector<GraphValue> x;
+    std::vector<GraphValue> y;
+    uint64_t skipped_line_count = 0;
+    std::atomic<bool> parsed = false;
+  };
+
+  void SplitChunks(std::string_view text);
+  void RunWorker();
+  void ParseChunk(Chunk& chunk) const;
+  void Stop();
+
+  ColumnarDataSource& data_source_;
+  const Options options_;
+  const Wake wake_;
+
+  QFile file_;
+  uchar* data_ = nullptr;
+  uint64_t total_size_ = 0;
+
+  std::unique_ptr<Chunk[]> chunks_;
+  size_t chunk_count_ = 0;
+  size_t delivered_count_ = 0;
+  bool finished_ = false;
+  uint64_t skipped_line_count_ = 0;
+
+  std::vector<std::thread> workers_;
+  std::atomic<size_t> next_chunk_ = 0;
+  std::atomic<uint64_t> parsed_size_ = 0;
+  std::atomic<bool> cancelled_ = false;
+  std::atomic<bool> deliver_pending_ = false;
+};
+
+}  // namespace views
@@ -0,0 +1,117 @@
+#include "graph_qt/model/csv_loader.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+
+namespace views {
+
+namespace {
+
+class CsvLoaderTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.isValid());
+    path_ = temp_dir_.filePath("points.csv");
+  }
+
+  void WriteFile(const std::string& text) {
+    QFile file{path_};
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    ASSERT_EQ(file.write(text.data(), static_cast<qint64>(text.size())),
+              static_cast<qint64>(text.size()));
+  }
+
+  // Delivers until the loader finishes.
+  void Load(CsvLoader& loader) {
+    ASSERT_TRUE(loader.Start(path_));
+    while (!loader.finished()) {
+      if (loader.Deliver() == 0) {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  QTemporaryDir temp_dir_;
+  QString path_;
+};
+
+}  // namespace
+
+TEST_F(CsvLoaderTest, LoadsInParallel) {
+  std::string text = "time,value\n";
+  for (int i = 0; i < 10000; ++i) {
+    text += std::to_string(i) + ".5," + std::to_string(i % 100) + "\r\n";
+  }
+  WriteFile(text);
+
+  ColumnarDataSource data_source;
+  CsvLoader loader{data_source, {.thread_count = 4, .chunk_size = 1000}};
+  Load(loader);
+
+  EXPECT_EQ(loader.progress(), 1.0);
+  EXPECT_EQ(loader.skipped_line_count(), 0u);
+  ASSERT_EQ(data_source.size(), 10000u);
+  for (size_t i = 0; i < data_source.size(); ++i) {
+    EXPECT_EQ(data_source.columns().at(i).x, i + 0.5);
+    EXPECT_EQ(data_source.columns().at(i).y, i % 100);
+    EXPECT_TRUE(data_source.columns().at(i).good);
+  }
+}
+
+TEST_F(CsvLoaderTest, SkipsInvalidLines) {
+  WriteFile(
+      "1;10\n"
+      "2;abc\n"
+      "\n"
+      "3;30\n"
+      "2.5;25\n"
+      "4; 40 \n");
+
+  ColumnarDataSource data_source;
+  CsvLoader loader{data_source, {.delimiter = ';', .skip_lines = 0}};
+  Load(loader);
+
+  EXPECT_EQ(loader.skipped_line_count(), 2u);
+  ASSERT_EQ(data_source.size(), 3u);
+  EXPECT_EQ(data_source.GetHorizontalRange(), GraphRange(1, 4));
+  EXPECT_EQ(data_source.GetVerticalRange(), GraphRange(10, 40));
+}
+
+TEST_F(CsvLoaderTest, FinishesWithHeaderOnly) {
+  WriteFile("time,value\n");
+
+  ColumnarDataSource data_source;
+  CsvLoader loader{data_source, {}};
+  ASSERT_TRUE(loader.Start(path_));
+  EXPECT_TRUE(loader.finished());
+  EXPECT_EQ(loader.progress(), 1.0);
+  EXPECT_EQ(data_source.size(), 0u);
+}
+
+TEST_F(CsvLoaderTest, ParseLine) {
+  const CsvLoader::Options options{.x_column = 2,
+                                   .y_column = 0,
+                                   .x_format =
+                                       CsvLoader::TimeFormat::kIsoDateTime};
+  GraphValue x = 0;
+  GraphValue y = 0;
+  EXPECT_TRUE(CsvLoader::ParseLine("1.5,tag,1970-01-02T00:00:01.25Z", options,
+                                   x, y));
+  EXPECT_EQ(x, 86401.25);
+  EXPECT_EQ(y, 1.5);
+  EXPECT_TRUE(
+      CsvLoader::ParseLine("-2,tag,2024-02-29 12:30:00", options, x, y));
+  EXPECT_EQ(x, 1709209800);
+  EXPECT_EQ(y, -2);
+
+  EXPECT_FALSE(CsvLoader::ParseLine("1,tag,2023-02-29 12:30:00", options, x,
+                                    y));
+  EXPECT_FALSE(CsvLoader::ParseLine("1,tag,2024-02-29", options, x, y));
+  EXPECT_FALSE(CsvLoader::ParseLine("1,tag", options, x, y));
+}
+
+}  // namespace views
@@ -0,0 +1,145 @@
+#include "graph_qt/model/deadband_data_source.h"
+
+#include "graph_qt/model/point_enumerators.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace views {
+
+DeadbandDataSource::DeadbandDataSource(const Deadband& deadband,
+                                       GraphRange::Kind horizontal_kind)
+    : deadband_{deadband}, horizontal_kind_{horizontal_kind} {}
+
+DeadbandDataSource::~DeadbandDataSource() = default;
+
+void DeadbandDataSource::AddPoint(const GraphPoint& point) {
+  AddPoints(std::span{&point, 1});
+}
+
+void DeadbandDataSource::AddPoints(std::span<const GraphPoint> points) {
+  if (points.empty()) {
+    return;
+  }
+
+  bool appended = true;
+  for (const auto& point : points) {
+    appended &= Append(point);
+  }
+
+  if (observer_) {
+    observer_->OnDataSourceCurrentValueChanged();
+    if (appended) {
+      observer_->OnDataSourcePointsAppended();
+    } else {
+      observer_->OnDataSourceHistoryChanged();
+    }
+  }
+}
+
+void DeadbandDataSource::Clear() {
+  points_.clear();
+  hold_ = false;
+  current_value_ = kGraphUnknownValue;
+  vertical_range_ = GraphRange{};
+
+  if (observer_) {
+    observer_->OnDataSourceCurrentValueChanged();
+    observer_->OnDataSourceHistoryChanged();
+  }
+}
+
+bool DeadbandDataSource::IsSignificant(const GraphPoint& point) const {
+  // The last significant sample precedes the hold marker.
+  const GraphPoint& stored = points_[points_.size() - (hold_ ? 2 : 1)];
+  if (point.good != stored.good) {
+    return true;
+  }
+  double delta = std::abs(point.y - stored.y);
+  return delta > deadband_.absolute &&
+         delta > deadband_.relative * std::abs(stored.y);
+}
+
+bool DeadbandDataSource::Append(const GraphPoint& point) {
+  assert(points_.empty() || point.x >= points_.back().x);
+
+  current_value_ = point.y;
+
+  if (points_.empty() || IsSignificant(point)) {
+    points_.push_back(point);
+    hold_ = false;
+    vertical_range_ =
+        points_.size() == 1
+            ? GraphRange{point.y, point.y}
+            : GraphRange{std::min(vertical_range_.low(), point.y),
+                         std::max(vertical_range_.high(), point.y)};
+    return true;
+  }
+
+  if (hold_) {
+    points_.back().x = point.x;
+    return false;
+  }
+
+  GraphPoint marker = points_.back();
+  marker.x = point.x;
+  points_.push_back(marker);
+  hold_ = true;
+  return true;
+}
+
+double DeadbandDataSource::GetCurrentValue() const {
+  return current_value_;
+}
+
+std::unique_ptr<PointEnumerator> DeadbandDataSource::EnumPoints(
+    double from,
+    double to,
+    bool include_left_bound,
+    bool include_right_bound) {
+  size_t first =
+      include_left_bound ? FindLowerBound(from) : FindUpperBound(from);
+  size_t last = include_right_bound ? FindUpperBound(to) : FindLowerBound(to);
+  if (first >= last) {
+    return nullptr;
+  }
+
+  return std::make_unique<SpanPointEnumerator>(
+      std::span{points_}.subspan(first, last - first));
+}
+
+GraphRange DeadbandDataSource::GetHorizontalRange() const {
+  if (points_.empty()) {
+    return GraphRange{};
+  }
+  return GraphRange{points_.front().x, points_.back().x, horizontal_kind_};
+}
+
+GraphRange DeadbandDataSource::GetVerticalRange() const {
+  return vertical_range_;
+}
+
+std::optional<size_t> DeadbandDataSource::LowerBound(double value) const {
+  return FindLowerBound(value);
+}
+
+std::optional<size_t> DeadbandDataSource::UpperBound(double value) const {
+  return FindUpperBound(value);
+}
+
+std::optional<double> DeadbandDataSource::GetPointX(size_t index) const {
+  return points_[index].x;
+}
+
+size_t DeadbandDataSource::FindLowerBound(double value) const {
+  return std::ranges::lower_bound(points_, value, {}, &GraphPoint::x) -
+         points_.begin();
+}
+
+size_t DeadbandDataSource::FindUpperBound(double value) const {
+  return std::ranges::upper_bound(points_, value, {}, &GraphPoint::x) -
+         points_.begin();
+}
+
+}  // namespace views
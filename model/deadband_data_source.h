@@ -0,0 +1,84 @@
+#pragma once
+
+#include "graph_qt/model/graph_data_source.h"
+
+#include <span>
+#include <vector>
+
+namespace views {
+
+// Data source for tags sampled at a fixed rate but changing rarely. A sample
+// is stored only if its value leaves the deadband around the last stored
+// value, or if its quality changes. Samples within the deadband are replaced
+// by a single hold marker, a point repeating the stored value at the x of the
+// last such sample. Memory and enumeration cost are proportional to the number
+// of changes, not to the sample rate.
+//
+// Enumeration reproduces held values exactly for stepped lines. Interpolated
+// lines stay within the deadband of the samples, as each change is preceded by
+// a marker at the previous sample.
+class DeadbandDataSource : public GraphDataSource {
+ public:
+  // A sample is significant if its value differs from the stored value by
+  // more than both `absolute` and `relative` times the stored value.
+  struct Deadband {
+    double absolute = 0;
+    double relative = 0;
+  };
+
+  explicit DeadbandDataSource(
+      const Deadband& deadband,
+      GraphRange::Kind horizontal_kind = GraphRange::LINEAR);
+  ~DeadbandDataSource() override;
+
+  const Deadband& deadband() const { return deadband_; }
+
+  // Returns the number of stored points, including hold markers.
+  size_t size() const { return points_.size(); }
+
+  // Appends samples. The samples must be sorted by x, and the first one must
+  // not precede the last existing sample. Sends a single
+  // `OnDataSourcePointsAppended()`, or `OnDataSourceHistoryChanged()` if an
+  // existing hold marker was moved, as incremental observers resume after
+  // the points they have seen.
+  void AddPoint(const GraphPoint& point);
+  void AddPoints(std::span<const GraphPoint> points);
+
+  void Clear();
+
+  // GraphDataSource
+  double GetCurrentValue() const override;
+  std::unique_ptr<PointEnumerator> EnumPoints(
+      double from,
+      double to,
+      bool include_left_bound,
+      bool include_right_bound) override;
+  GraphRange GetHorizontalRange() const override;
+  GraphRange GetVerticalRange() const override;
+  std::optional<size_t> LowerBound(double value) const override;
+  std::optional<size_t> UpperBound(double value) const override;
+  std::optional<double> GetPointX(size_t index) const override;
+
+ private:
+  bool IsSignificant(const GraphPoint& point) const;
+
+  // Returns false if an existing hold marker was moved.
+  bool Append(const GraphPoint& point);
+
+  size_t FindLowerBound(double value) const;
+  size_t FindUpperBound(double value) const;
+
+  const Deadband deadband_;
+  const GraphRange::Kind horizontal_kind_;
+
+  // Significant samples and hold markers, sorted by x.
+  std::vector<GraphPoint> points_;
+  // True if the last stored point is a hold marker, which moves with every
+  // insignificant sample.
+  bool hold_ = false;
+
+  double current_value_ = kGraphUnknownValue;
+  GraphRange vertical_range_;
+};
+
+}  // namespace views
@@ -0,0 +1,104 @@
+#include "graph_qt/model/deadband_data_source.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace views {
+
+namespace {
+
+class CountingObserver : public GraphDataSource::Observer {
+ public:
+  void OnDataSourceHistoryChanged() override { ++history_changed_count; }
+  void OnDataSourcePointsAppended() override { ++points_appended_count; }
+
+  int history_changed_count = 0;
+  int points_appended_count = 0;
+};
+
+std::vector<GraphPoint> EnumAllPoints(GraphDataSource& data_source) {
+  std::vector<GraphPoint> points;
+  if (auto point_enum = data_source.EnumPoints(-1e9, 1e9, true, true)) {
+    ForEachPoint(*point_enum,
+                 [&](const GraphPoint& point) { points.push_back(point); });
+  }
+  return points;
+}
+
+GraphPoint MakePoint(double x, double y, bool good) {
+  GraphPoint point{x, y};
+  point.good = good;
+  return point;
+}
+
+}  // namespace
+
+TEST(DeadbandDataSourceTest, KeepsChangesAndHoldMarkers) {
+  DeadbandDataSource data_source{{.absolute = 0.5}};
+
+  // 1000 samples of a constant value are stored as the first sample and a
+  // hold marker.
+  for (int i = 0; i < 1000; ++i) {
+    data_source.AddPoint(
+        MakePoint(static_cast<double>(i), i % 2 ? 10.2 : 10.0, true));
+  }
+  EXPECT_EQ(data_source.size(), 2u);
+  EXPECT_EQ(data_source.GetCurrentValue(), 10.2);
+  EXPECT_EQ(data_source.GetHorizontalRange(), GraphRange(0, 999));
+
+  data_source.AddPoint(MakePoint(1000, 20, true));
+  data_source.AddPoint(MakePoint(1001, 20, true));
+  data_source.AddPoint(MakePoint(1002, 20, false));
+
+  EXPECT_EQ(EnumAllPoints(data_source),
+            (std::vector<GraphPoint>{MakePoint(0, 10, true),
+                                     MakePoint(999, 10, true),
+                                     MakePoint(1000, 20, true),
+                                     MakePoint(1001, 20, true),
+                                     MakePoint(1002, 20, false)}));
+  EXPECT_EQ(data_source.GetVerticalRange(), GraphRange(10, 20));
+  EXPECT_EQ(data_source.CountPoints(500, 1001, true, true), 3u);
+}
+
+TEST(DeadbandDataSourceTest, Notifications) {
+  DeadbandDataSource data_source{{.absolute = 0.5}};
+  CountingObserver observer;
+  data_source.SetObserver(&observer);
+
+  // The first sample and the hold marker are appended.
+  data_source.AddPoint(MakePoint(0, 10, true));
+  data_source.AddPoint(MakePoint(1, 10, true));
+  EXPECT_EQ(observer.points_appended_count, 2);
+
+  // Moving the hold marker changes an existing point.
+  data_source.AddPoint(MakePoint(2, 10, true));
+  EXPECT_EQ(observer.history_changed_count, 1);
+
+  data_source.AddPoint(MakePoint(3, 20, true));
+  EXPECT_EQ(observer.points_appended_count, 3);
+
+  data_source.SetObserver(nullptr);
+}
+
+TEST(DeadbandDataSourceTest, RelativeDeadband) {
+  DeadbandDataSource data_source{{.relative = 0.1}};
+  data_source.AddPoints(std::vector<GraphPoint>{
+      {0, 100}, {1, 109}, {2, 91}, {3, 111}, {4, 105}});
+
+  // The deadband is relative to the stored value, so it doesn't drift.
+  EXPECT_EQ(EnumAllPoints(data_source),
+            (std::vector<GraphPoint>{{0, 100}, {2, 100}, {3, 111}, {4, 111}}));
+}
+
+TEST(DeadbandDataSourceTest, Clear) {
+  DeadbandDataSource data_source{{.absolute = 1}};
+  data_source.AddPoints(std::vector<GraphPoint>{{0, 0}, {1, 0}});
+  data_source.Clear();
+
+  EXPECT_EQ(data_source.size(), 0u);
+  EXPECT_EQ(data_source.GetHorizontalRange(), GraphRange{});
+  EXPECT_FALSE(data_source.EnumPoints(0, 1, true, true));
+}
+
+}  // namespace views
@@ -2,8 +2,83 @@
 
 #include "graph_qt/model/graph_types.h"
 
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
 namespace views {
 
+namespace {
+
+// Skips points repeating the value and the quality of the previous point, but
+// keeps the last point.
+class SteppedPointEnumerator : public PointEnumerator {
+ public:
+  explicit SteppedPointEnumerator(std::unique_ptr<PointEnumerator> source)
+      : source_{std::move(source)} {}
+
+  size_t GetCount() const override { return source_->GetCount(); }
+
+  bool EnumNext(GraphPoint& value) override {
+    return EnumNextBatch(std::span{&value, 1}) != 0;
+  }
+
+  size_t EnumNextBatch(std::span<GraphPoint> points) override {
+    size_t count = 0;
+    while (count < points.size()) {
+      if (index_ == batch_count_) {
+        batch_count_ = source_->EnumNextBatch(batch_);
+        index_ = 0;
+        if (batch_count_ == 0) {
+          // Keep the last point, so the last step spans the whole range.
+          if (skipped_point_) {
+            points[count++] = *skipped_point_;
+            skipped_point_.reset();
+          }
+          break;
+        }
+      }
+
+      const GraphPoint& point = batch_[index_++];
+      if (last_point_ && point.y == last_point_->y &&
+          point.good == last_point_->good) {
+        skipped_point_ = point;
+        continue;
+      }
+
+      points[count++] = point;
+      last_point_ = point;
+      skipped_point_.reset();
+    }
+    return count;
+  }
+
+ private:
+  const std::unique_ptr<PointEnumerator> source_;
+
+  std::array<GraphPoint, kPointBatchSize> batch_;
+  size_t index_ = 0;
+  size_t batch_count_ = 0;
+
+  std::optional<GraphPoint> last_point_;
+  std::optional<GraphPoint> skipped_point_;
+};
+
+}  // namespace
+
+size_t PointEnumerator::EnumNextBatch(std::span<GraphPoint> points) {
+  size_t count = 0;
+  while (count < points.size() && EnumNext(points[count])) {
+    ++count;
+  }
+  return count;
+}
+
+bool PointEnumerator::EnumNextColumns(PointColumnSpans& columns) {
+  assert(false);
+  return false;
+}
+
 GraphDataSource::GraphDataSource() = default;
 
 GraphDataSource::~GraphDataSource() {
@@ -11,28 +86,75 @@ GraphDataSource::~GraphDataSource() {
 }
 
 GraphRange GraphDataSource::CalculateAutoRange(double x1, double x2) {
+  if (auto range = QueryVerticalRange(x1, x2)) {
+    return *range;
+  }
+
   auto point_enum = EnumPoints(x1, x2, true, false);
   if (!point_enum) {
     return GraphRange();
   }
 
-  GraphPoint point;
-  if (!point_enum->EnumNext(point)) {
+  double low = std::numeric_limits<double>::max();
+  double high = std::numeric_limits<double>::lowest();
+
+  // Only the y column is read.
+  ForEachColumns(*point_enum, [&](const PointColumnSpans& columns) {
+    for (GraphValue y : columns.y) {
+      low = std::min(low, y);
+      high = std::max(high, y);
+    }
+  });
+
+  if (low > high) {
     return GraphRange();
   }
 
-  double low = point.y;
-  double high = point.y;
+  return GraphRange(low, high);
+}
 
-  while (point_enum->EnumNext(point)) {
-    if (point.y < low) {
-      low = point.y;
-    } else if (point.y > high) {
-      high = point.y;
-    }
+GraphStatistics GraphDataSource::CalculateStatistics(double x1, double x2) {
+  if (auto statistics = QueryStatistics(x1, x2)) {
+    return *statistics;
   }
 
-  return GraphRange(low, high);
+  auto point_enum = EnumPoints(x1, x2, true, true);
+  if (!point_enum) {
+    return GraphStatistics{};
+  }
+
+  return views::CalculateStatistics(*point_enum, x2);
+}
+
+std::optional<size_t> GraphDataSource::CountPoints(
+    double from,
+    double to,
+    bool include_left_bound,
+    bool include_right_bound) const {
+  auto first = include_left_bound ? LowerBound(from) : UpperBound(from);
+  auto last = include_right_bound ? UpperBound(to) : LowerBound(to);
+  if (!first || !last) {
+    return std::nullopt;
+  }
+  return *last > *first ? *last - *first : 0;
+}
+
+std::unique_ptr<PointEnumerator> GraphDataSource::EnumReducedPoints(
+    double from,
+    double to,
+    double resolution) {
+  return EnumPoints(from, to, true, true);
+}
+
+std::unique_ptr<PointEnumerator> GraphDataSource::EnumSteppedPoints(
+    double from,
+    double to,
+    double resolution) {
+  auto point_enum = EnumReducedPoints(from, to, resolution);
+  if (!point_enum) {
+    return nullptr;
+  }
+  return std::make_unique<SteppedPointEnumerator>(std::move(point_enum));
 }
 
 QString GraphDataSource::GetYAxisLabel(double value) const {
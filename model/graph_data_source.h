@@ -1,14 +1,19 @@
 #pragma once
 
 #include "graph_qt/model/graph_range.h"
+#include "graph_qt/model/graph_statistics.h"
+#include "graph_qt/model/graph_types.h"
+#include "graph_qt/model/point_columns.h"
 
 #include <QString>
+#include <array>
 #include <memory>
+#include <optional>
+#include <span>
+#include <vector>
 
 namespace views {
 
-struct GraphPoint;
-
 class PointEnumerator {
  public:
   virtual ~PointEnumerator() = default;
@@ -16,13 +21,77 @@ class PointEnumerator {
   virtual size_t GetCount() const = 0;
 
   virtual bool EnumNext(GraphPoint& value) = 0;
+
+  // Fills `points` with the next points and returns the number of points
+  // written. Returns zero when there are no more points. The default
+  // implementation calls `EnumNext()` for each point.
+  virtual size_t EnumNextBatch(std::span<GraphPoint> points);
+
+  // Enumerators over columnar storage return true, and give the points by
+  // `EnumNextColumns()` without copying them.
+  virtual bool SupportsColumns() const { return false; }
+
+  // Sets `columns` to the next run of points and returns true, or returns
+  // false when there are no more points. The spans stay valid until the next
+  // call. Must be called only if `SupportsColumns()` returns true.
+  virtual bool EnumNextColumns(PointColumnSpans& columns);
 };
 
+// Number of points pulled from an enumerator per `EnumNextBatch()` call.
+inline constexpr size_t kPointBatchSize = 256;
+
+// Calls `callback` for every remaining point of `point_enum`, pulling the
+// points in batches.
+template <class Callback>
+void ForEachPoint(PointEnumerator& point_enum, Callback&& callback) {
+  std::array<GraphPoint, kPointBatchSize> batch;
+  while (size_t count = point_enum.EnumNextBatch(batch)) {
+    for (const GraphPoint& point : std::span{batch}.first(count)) {
+      callback(point);
+    }
+  }
+}
+
+// Calls `callback` with the remaining points of `point_enum` as runs of
+// `PointColumnSpans`, so that reducers read only the columns they need.
+// Enumerators not supporting columns are transposed batch by batch.
+template <class Callback>
+void ForEachColumns(PointEnumerator& point_enum, Callback&& callback) {
+  if (point_enum.SupportsColumns()) {
+    PointColumnSpans columns;
+    while (point_enum.EnumNextColumns(columns)) {
+      callback(static_cast<const PointColumnSpans&>(columns));
+    }
+    return;
+  }
+
+  std::array<GraphPoint, kPointBatchSize> batch;
+  std::array<GraphValue, kPointBatchSize> x;
+  std::array<GraphValue, kPointBatchSize> y;
+  std::array<uint64_t, (kPointBatchSize + 63) / 64> quality;
+  while (size_t count = point_enum.EnumNextBatch(batch)) {
+    quality.fill(0);
+    for (size_t i = 0; i < count; ++i) {
+      x[i] = batch[i].x;
+      y[i] = batch[i].y;
+      quality[i / 64] |= uint64_t{batch[i].good} << (i % 64);
+    }
+    callback(PointColumnSpans{std::span{x}.first(count),
+                              std::span{y}.first(count), quality});
+  }
+}
+
 class GraphDataSource {
  public:
   class Observer {
    public:
     virtual void OnDataSourceHistoryChanged() {}
+    // Points were appended after the last point, and the rest of the history
+    // is unchanged, except that sources of fixed capacity may have evicted
+    // their oldest points. Observers keeping incremental state can extend it
+    // instead of rebuilding. Forwards to `OnDataSourceHistoryChanged()` by
+    // default.
+    virtual void OnDataSourcePointsAppended() { OnDataSourceHistoryChanged(); }
     virtual void OnDataSourceCurrentValueChanged() {}
     virtual void OnDataSourceItemChanged() {}
     virtual void OnDataSourceDeleted() {}
@@ -41,6 +110,25 @@ class GraphDataSource {
       bool include_left_bound,
       bool include_right_bound) = 0;
 
+  // Enumerates the points of `[from, to]` for drawing, where `resolution` is
+  // the x distance covered by one pixel column. Sources keeping summaries may
+  // reduce the points to a few per column as long as the extremes of every
+  // column are kept. The default implementation enumerates all points.
+  virtual std::unique_ptr<PointEnumerator> EnumReducedPoints(double from,
+                                                             double to,
+                                                             double resolution);
+
+  // Enumerates the points of `[from, to]` for drawing a stepped line. Points
+  // repeating the value and the quality of the previous point are skipped, as
+  // they don't change the drawn steps, but the last point of the range is
+  // kept. Transitions closer than `resolution` may be reduced to the extremes
+  // of their pixel column. The default implementation filters the points of
+  // `EnumReducedPoints()`, and `GetCount()` of its enumerator returns an upper
+  // bound.
+  virtual std::unique_ptr<PointEnumerator> EnumSteppedPoints(double from,
+                                                             double to,
+                                                             double resolution);
+
   virtual QString GetYAxisLabel(double value) const;
 
   // Must be O(1).
@@ -49,8 +137,71 @@ class GraphDataSource {
   // Must be O(1).
   virtual GraphRange GetVerticalRange() const { return GraphRange{}; }
 
+  // Returns the range of point values in `[x1, x2)`. Uses
+  // `QueryVerticalRange()` when supported, otherwise enumerates the points.
   GraphRange CalculateAutoRange(double x1, double x2);
 
+  // Optional range query. Sources keeping min/max summaries can implement it
+  // in O(log n) to spare `CalculateAutoRange()` a scan of every point in
+  // `[x1, x2)`. Returns an empty range if there are no points, or
+  // `std::nullopt` if the query is not supported, which is the default.
+  virtual std::optional<GraphRange> QueryVerticalRange(double x1,
+                                                       double x2) const {
+    return std::nullopt;
+  }
+
+  // Returns the statistics of the points in `[x1, x2]`. Uses
+  // `QueryStatistics()` when supported, otherwise enumerates the points.
+  GraphStatistics CalculateStatistics(double x1, double x2);
+
+  // Optional statistics query. Sources keeping an aggregate index can
+  // implement it in O(log n). Returns `std::nullopt` if the query is not
+  // supported, which is the default.
+  virtual std::optional<GraphStatistics> QueryStatistics(double x1,
+                                                         double x2) const {
+    return std::nullopt;
+  }
+
+  // Optional quantile bands of `[from, to]`, one per pixel column of width
+  // `resolution`, with the values at `quantile`, at the median and at
+  // `1 - quantile`. Sources keeping mergeable sketches can implement it
+  // without reading the raw points. Returns `std::nullopt` if the query is not
+  // supported, which is the default.
+  virtual std::optional<std::vector<GraphBand>> QueryQuantileBands(
+      double from,
+      double to,
+      double resolution,
+      double quantile) const {
+    return std::nullopt;
+  }
+
+  // Optional index queries. Sources that keep points in a sorted
+  // random-access sequence can implement them in O(log n) or faster to let
+  // callers count and locate points without enumerating them. The defaults
+  // return `std::nullopt`, meaning the queries are not supported.
+
+  // Returns the index of the first point with `x >= value`.
+  virtual std::optional<size_t> LowerBound(double value) const {
+    return std::nullopt;
+  }
+
+  // Returns the index of the first point with `x > value`.
+  virtual std::optional<size_t> UpperBound(double value) const {
+    return std::nullopt;
+  }
+
+  // Returns the x of the point at `index`.
+  virtual std::optional<double> GetPointX(size_t index) const {
+    return std::nullopt;
+  }
+
+  // Returns the number of points `EnumPoints()` would enumerate for the same
+  // arguments, or `std::nullopt` if the index queries are not supported.
+  std::optional<size_t> CountPoints(double from,
+                                    double to,
+                                    bool include_left_bound,
+                                    bool include_right_bound) const;
+
   // Limits.
   double limit_lo_ = kGraphUnknownValue;
   double limit_hi_ = kGraphUnknownValue;
@@ -0,0 +1,198 @@
+#include "graph_qt/model/graph_data_source.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace views {
+
+namespace {
+
+// Enumerator that only implements `EnumNext()`.
+class SinglePointEnumerator : public PointEnumerator {
+ public:
+  explicit SinglePointEnumerator(std::vector<GraphPoint> points)
+      : points_{std::move(points)} {}
+
+  size_t GetCount() const override { return points_.size() - index_; }
+
+  bool EnumNext(GraphPoint& value) override {
+    if (index_ >= points_.size()) {
+      return false;
+    }
+    value = points_[index_++];
+    return true;
+  }
+
+ private:
+  const std::vector<GraphPoint> points_;
+  size_t index_ = 0;
+};
+
+class VectorDataSource : public GraphDataSource {
+ public:
+  explicit VectorDataSource(std::vector<GraphPoint> points)
+      : points_{std::move(points)} {}
+
+  std::unique_ptr<PointEnumerator> EnumPoints(
+      double from,
+      double to,
+      bool include_left_bound,
+      bool include_right_bound) override {
+    std::vector<GraphPoint> points;
+    for (const auto& point : points_) {
+      if ((include_left_bound ? point.x >= from : point.x > from) &&
+          (include_right_bound ? point.x <= to : point.x < to)) {
+        points.push_back(point);
+      }
+    }
+    return std::make_unique<SinglePointEnumerator>(std::move(points));
+  }
+
+  std::optional<size_t> LowerBound(double value) const override {
+    return std::ranges::lower_bound(points_, value, {}, &GraphPoint::x) -
+           points_.begin();
+  }
+
+  std::optional<size_t> UpperBound(double value) const override {
+    return std::ranges::upper_bound(points_, value, {}, &GraphPoint::x) -
+           points_.begin();
+  }
+
+  std::optional<double> GetPointX(size_t index) const override {
+    return points_[index].x;
+  }
+
+ private:
+  const std::vector<GraphPoint> points_;
+};
+
+std::vector<GraphPoint> MakePoints(size_t count) {
+  std::vector<GraphPoint> points;
+  for (size_t i = 0; i < count; ++i) {
+    points.emplace_back(static_cast<double>(i), static_cast<double>(i % 7));
+  }
+  return points;
+}
+
+}  // namespace
+
+TEST(PointEnumeratorTest, EnumNextBatchFallsBackToEnumNext) {
+  auto points = MakePoints(10);
+  SinglePointEnumerator point_enum{points};
+
+  std::vector<GraphPoint> batch(4);
+  EXPECT_EQ(point_enum.EnumNextBatch(batch), 4u);
+  EXPECT_EQ(batch[3], points[3]);
+  EXPECT_EQ(point_enum.EnumNextBatch(batch), 4u);
+  EXPECT_EQ(batch[0], points[4]);
+  EXPECT_EQ(point_enum.EnumNextBatch(batch), 2u);
+  EXPECT_EQ(batch[1], points[9]);
+  EXPECT_EQ(point_enum.EnumNextBatch(batch), 0u);
+}
+
+TEST(PointEnumeratorTest, ForEachPointVisitsAllPoints) {
+  auto points = MakePoints(kPointBatchSize * 2 + 3);
+  SinglePointEnumerator point_enum{points};
+
+  std::vector<GraphPoint> visited;
+  ForEachPoint(point_enum,
+               [&](const GraphPoint& point) { visited.push_back(point); });
+
+  EXPECT_EQ(visited, points);
+}
+
+TEST(GraphDataSourceTest, CalculateAutoRange) {
+  VectorDataSource data_source{MakePoints(100)};
+
+  EXPECT_EQ(data_source.CalculateAutoRange(0, 100), GraphRange(0, 6));
+  EXPECT_EQ(data_source.CalculateAutoRange(1, 4), GraphRange(1, 3));
+  EXPECT_EQ(data_source.CalculateAutoRange(200, 300), GraphRange());
+}
+
+TEST(GraphDataSourceTest, CalculateAutoRangeUsesRangeQuery) {
+  class RangeQueryDataSource : public VectorDataSource {
+   public:
+    using VectorDataSource::VectorDataSource;
+
+    std::optional<GraphRange> QueryVerticalRange(double x1,
+                                                 double x2) const override {
+      return GraphRange(x1, x2);
+    }
+  };
+
+  RangeQueryDataSource data_source{MakePoints(100)};
+  EXPECT_EQ(data_source.CalculateAutoRange(1, 4), GraphRange(1, 4));
+}
+
+TEST(GraphDataSourceTest, CalculateStatistics) {
+  VectorDataSource data_source{
+      {{0, 1}, {1, 3}, {3, 5}, {4, 3}, {10, 100}}};
+
+  auto statistics = data_source.CalculateStatistics(0, 5);
+  EXPECT_EQ(statistics.count, 4u);
+  EXPECT_EQ(statistics.mean, 3);
+  EXPECT_EQ(statistics.stddev, std::sqrt(2.0));
+  // 1 * 1 + 3 * 2 + 5 * 1 + 3 * 1
+  EXPECT_EQ(statistics.integral, 15);
+  EXPECT_EQ(statistics.min, 1);
+  EXPECT_EQ(statistics.max, 5);
+
+  EXPECT_EQ(data_source.CalculateStatistics(5, 9), GraphStatistics());
+}
+
+TEST(GraphDataSourceTest, CountPointsMatchesEnumeration) {
+  VectorDataSource data_source{MakePoints(100)};
+
+  for (bool include_left_bound : {false, true}) {
+    for (bool include_right_bound : {false, true}) {
+      for (auto [from, to] : {std::pair{10.0, 20.0}, std::pair{10.5, 20.5},
+                              std::pair{-5.0, 50.0}, std::pair{90.0, 200.0},
+                              std::pair{30.0, 30.0}, std::pair{40.0, 30.0}}) {
+        auto point_enum = data_source.EnumPoints(from, to, include_left_bound,
+                                                 include_right_bound);
+        EXPECT_EQ(data_source.CountPoints(from, to, include_left_bound,
+                                          include_right_bound),
+                  point_enum->GetCount())
+            << from << " " << to;
+      }
+    }
+  }
+}
+
+TEST(GraphDataSourceTest, EnumSteppedPointsSkipsRepeatedValues) {
+  std::vector<GraphPoint> points;
+  for (int i = 0; i < 1000; ++i) {
+    points.emplace_back(i, i / 300);
+  }
+  points[500].good = true;
+  VectorDataSource data_source{points};
+
+  std::vector<GraphPoint> stepped_points;
+  auto point_enum = data_source.EnumSteppedPoints(0, 1000, 1);
+  ForEachPoint(*point_enum, [&](const GraphPoint& point) {
+    stepped_points.push_back(point);
+  });
+
+  EXPECT_EQ(stepped_points,
+            (std::vector<GraphPoint>{points[0], points[300], points[500],
+                                     points[501], points[600], points[900],
+                                     points[999]}));
+}
+
+TEST(GraphDataSourceTest, CountPointsNotSupported) {
+  class NoIndexDataSource : public GraphDataSource {
+   public:
+    std::unique_ptr<PointEnumerator> EnumPoints(double, double, bool, bool)
+        override {
+      return nullptr;
+    }
+  };
+
+  NoIndexDataSource data_source;
+  EXPECT_EQ(data_source.CountPoints(0, 1, true, true), std::nullopt);
+}
+
+}  // namespace views
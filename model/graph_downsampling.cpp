@@ -0,0 +1,126 @@
+#include "graph_qt/model/graph_downsampling.h"
+
+#include "graph_qt/model/graph_data_source.h"
+
+#include <cmath>
+
+namespace views {
+
+namespace {
+
+// Reads points from an enumerator one by one, pulling them in batches.
+class PointReader {
+ public:
+  explicit PointReader(PointEnumerator& point_enum) : point_enum_{point_enum} {}
+
+  bool Read(GraphPoint& point) {
+    if (index_ == count_) {
+      count_ = point_enum_.EnumNextBatch(batch_);
+      index_ = 0;
+      if (count_ == 0) {
+        return false;
+      }
+    }
+    point = batch_[index_++];
+    return true;
+  }
+
+  // Appends up to `count` points to `points`.
+  void Read(size_t count, std::vector<GraphPoint>& points) {
+    GraphPoint point;
+    for (size_t i = 0; i < count && Read(point); ++i) {
+      points.push_back(point);
+    }
+  }
+
+ private:
+  PointEnumerator& point_enum_;
+  std::array<GraphPoint, kPointBatchSize> batch_;
+  size_t index_ = 0;
+  size_t count_ = 0;
+};
+
+GraphPoint GetAverage(const std::vector<GraphPoint>& points) {
+  GraphPoint average;
+  for (const auto& point : points) {
+    average.x += point.x;
+    average.y += point.y;
+  }
+  average.x /= points.size();
+  average.y /= points.size();
+  return average;
+}
+
+}  // namespace
+
+std::vector<GraphPoint> DownsampleLttb(PointEnumerator& point_enum,
+                                       size_t threshold) {
+  const size_t count = point_enum.GetCount();
+
+  PointReader reader{point_enum};
+  std::vector<GraphPoint> result;
+
+  if (threshold >= count || threshold < 3) {
+    result.reserve(count);
+    reader.Read(count, result);
+    return result;
+  }
+
+  result.reserve(threshold);
+
+  // Bucket `i` covers the points `[1 + i * bucket_size, 1 + (i + 1) *
+  // bucket_size)`. The first and the last points make their own buckets.
+  const size_t bucket_count = threshold - 2;
+  const double bucket_size = static_cast<double>(count - 2) / bucket_count;
+  auto get_bucket_end = [&](size_t bucket) {
+    return 1 + static_cast<size_t>(std::floor((bucket + 1) * bucket_size));
+  };
+
+  GraphPoint selected_point;
+  if (!reader.Read(selected_point)) {
+    return result;
+  }
+  result.push_back(selected_point);
+
+  std::vector<GraphPoint> bucket;
+  std::vector<GraphPoint> next_bucket;
+  reader.Read(get_bucket_end(0) - 1, bucket);
+
+  for (size_t i = 0; i < bucket_count && !bucket.empty(); ++i) {
+    next_bucket.clear();
+    size_t next_bucket_size = i + 1 < bucket_count
+                                  ? get_bucket_end(i + 1) - get_bucket_end(i)
+                                  : 1;
+    reader.Read(next_bucket_size, next_bucket);
+
+    GraphPoint next_average =
+        next_bucket.empty() ? bucket.back() : GetAverage(next_bucket);
+
+    // Twice the triangle area. The constant factor doesn't affect selection.
+    double max_area = -1;
+    const GraphPoint* max_area_point = nullptr;
+    for (const auto& point : bucket) {
+      double area = std::abs(
+          (selected_point.x - next_average.x) * (point.y - selected_point.y) -
+          (selected_point.x - point.x) * (next_average.y - selected_point.y));
+      if (area > max_area) {
+        max_area = area;
+        max_area_point = &point;
+      }
+    }
+
+    selected_point = *max_area_point;
+    result.push_back(selected_point);
+
+    bucket.swap(next_bucket);
+  }
+
+  // The last point.
+  if (!bucket.empty()) {
+    result.push_back(bucket.back());
+  }
+
+  return result;
+}
+
+}  // namespace views
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "graph_qt/model/graph_types.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace views {
+
+class PointEnumerator;
+
+// Downsamples the enumerated points to `threshold` points with the
+// Largest-Triangle-Three-Buckets algorithm. The first and the last points are
+// kept, and every bucket in between is represented by the point forming the
+// largest triangle with the previously selected point and the average of the
+// next bucket. The points are streamed, so only two buckets are kept in
+// memory. Returns all points if there are no more than `threshold` of them.
+std::vector<GraphPoint> DownsampleLttb(PointEnumerator& point_enum,
+                                       size_t threshold);
+
+}  // namespace views
@@ -0,0 +1,60 @@
+#include "graph_qt/model/graph_downsampling.h"
+
+#include "graph_qt/model/point_enumerators.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace views {
+
+namespace {
+
+std::vector<GraphPoint> MakeSine(size_t count) {
+  std::vector<GraphPoint> points;
+  for (size_t i = 0; i < count; ++i) {
+    points.emplace_back(i, std::sin(i / 50.0));
+  }
+  return points;
+}
+
+std::vector<GraphPoint> Downsample(const std::vector<GraphPoint>& points,
+                                   size_t threshold) {
+  SpanPointEnumerator point_enum{points};
+  return DownsampleLttb(point_enum, threshold);
+}
+
+}  // namespace
+
+TEST(GraphDownsamplingTest, LttbKeepsThresholdPoints) {
+  auto points = MakeSine(10000);
+
+  auto downsampled = Downsample(points, 100);
+
+  ASSERT_EQ(downsampled.size(), 100u);
+  EXPECT_EQ(downsampled.front(), points.front());
+  EXPECT_EQ(downsampled.back(), points.back());
+  EXPECT_TRUE(std::ranges::is_sorted(downsampled, {}, &GraphPoint::x));
+}
+
+TEST(GraphDownsamplingTest, LttbKeepsSpikes) {
+  auto points = MakeSine(10000);
+  points[5555].y = 100;
+  points[7777].y = -100;
+
+  auto downsampled = Downsample(points, 50);
+
+  EXPECT_NE(std::ranges::find(downsampled, points[5555]), downsampled.end());
+  EXPECT_NE(std::ranges::find(downsampled, points[7777]), downsampled.end());
+}
+
+TEST(GraphDownsamplingTest, LttbReturnsAllPointsBelowThreshold) {
+  auto points = MakeSine(50);
+
+  EXPECT_EQ(Downsample(points, 50), points);
+  EXPECT_EQ(Downsample(points, 1000), points);
+}
+
+}  // namespace views
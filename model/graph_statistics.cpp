@@ -0,0 +1,49 @@
+#include "graph_qt/model/graph_statistics.h"
+
+#include "graph_qt/model/graph_data_source.h"
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+
+namespace views {
+
+GraphStatistics CalculateStatistics(PointEnumerator& point_enum, double to) {
+  GraphStatistics statistics;
+  // Welford's algorithm keeps the variance precise on long intervals.
+  double sum_squared_deviations = 0.0;
+  std::optional<GraphPoint> previous;
+
+  // The quality column isn't read.
+  ForEachColumns(point_enum, [&](const PointColumnSpans& columns) {
+    for (size_t i = 0; i < columns.size(); ++i) {
+      const GraphValue x = columns.x[i];
+      const GraphValue y = columns.y[i];
+      if (previous) {
+        statistics.integral += previous->y * (x - previous->x);
+        statistics.min = std::min(statistics.min, y);
+        statistics.max = std::max(statistics.max, y);
+      } else {
+        statistics.min = y;
+        statistics.max = y;
+      }
+
+      ++statistics.count;
+      double delta = y - statistics.mean;
+      statistics.mean += delta / statistics.count;
+      sum_squared_deviations += delta * (y - statistics.mean);
+
+      previous = GraphPoint{x, y};
+    }
+  });
+
+  if (!previous) {
+    return statistics;
+  }
+
+  statistics.integral += previous->y * (to - previous->x);
+  statistics.stddev = std::sqrt(sum_squared_deviations / statistics.count);
+  return statistics;
+}
+
+}  // namespace views
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "graph_qt/model/graph_types.h"
+
+#include <cstddef>
+
+namespace views {
+
+class PointEnumerator;
+
+// Statistics of the points of an interval.
+struct GraphStatistics {
+  bool operator==(const GraphStatistics& other) const = default;
+
+  size_t count = 0;
+  double mean = 0.0;
+  // Population standard deviation.
+  double stddev = 0.0;
+  // Area under the line with every value held until the next point, and the
+  // last one until the end of the interval. Zero for a single point at the
+  // end of the interval.
+  double integral = 0.0;
+  double min = 0.0;
+  double max = 0.0;
+};
+
+// Calculates the statistics of the enumerated points of an interval ending at
+// `to`, in O(n).
+GraphStatistics CalculateStatistics(PointEnumerator& point_enum, double to);
+
+}  // namespace views
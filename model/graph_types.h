@@ -1,5 +1,8 @@
 #pragma once
 
+#include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <limits>
 
 namespace views {
@@ -8,6 +11,64 @@ using GraphValue = double;
 
 const GraphValue kGraphUnknownValue = std::numeric_limits<GraphValue>::min();
 
+// Time stored as integer nanoseconds. As a `GraphValue` it is in seconds, so
+// the conversion is lossy: doubles resolve about 240 ns near the current Unix
+// time.
+using GraphNanoseconds = std::chrono::duration<int64_t, std::nano>;
+
+// Conversion of the value types a storage may keep to and from `GraphValue`,
+// the type of the data source and axis API. `FromGraphValue()` rounds to the
+// nearest representable value. `Ceil()` and `Floor()` round up and down, so
+// that range bounds stay exact.
+template <class T>
+struct GraphValueTraits;
+
+template <>
+struct GraphValueTraits<double> {
+  static GraphValue ToGraphValue(double value) { return value; }
+  static double FromGraphValue(GraphValue value) { return value; }
+  static double Ceil(GraphValue value) { return value; }
+  static double Floor(GraphValue value) { return value; }
+};
+
+template <>
+struct GraphValueTraits<float> {
+  static GraphValue ToGraphValue(float value) { return value; }
+  static float FromGraphValue(GraphValue value) {
+    return static_cast<float>(value);
+  }
+  static float Ceil(GraphValue value) {
+    auto result = static_cast<float>(value);
+    return result < value
+               ? std::nextafter(result, std::numeric_limits<float>::infinity())
+               : result;
+  }
+  static float Floor(GraphValue value) {
+    auto result = static_cast<float>(value);
+    return result > value
+               ? std::nextafter(result, -std::numeric_limits<float>::infinity())
+               : result;
+  }
+};
+
+template <>
+struct GraphValueTraits<GraphNanoseconds> {
+  using Seconds = std::chrono::duration<GraphValue>;
+
+  static GraphValue ToGraphValue(GraphNanoseconds value) {
+    return Seconds{value}.count();
+  }
+  static GraphNanoseconds FromGraphValue(GraphValue value) {
+    return std::chrono::round<GraphNanoseconds>(Seconds{value});
+  }
+  static GraphNanoseconds Ceil(GraphValue value) {
+    return std::chrono::ceil<GraphNanoseconds>(Seconds{value});
+  }
+  static GraphNanoseconds Floor(GraphValue value) {
+    return std::chrono::floor<GraphNanoseconds>(Seconds{value});
+  }
+};
+
 struct GraphPoint {
   GraphPoint() = default;
   GraphPoint(GraphValue x, GraphValue y) : x(x), y(y) {}
@@ -19,4 +80,15 @@ struct GraphPoint {
   bool good = false;
 };
 
+// Values at a low quantile, the median and a high quantile of the points of
+// the pixel column starting at `x`.
+struct GraphBand {
+  bool operator==(const GraphBand& other) const = default;
+
+  GraphValue x = 0.0;
+  GraphValue low = 0.0;
+  GraphValue median = 0.0;
+  GraphValue high = 0.0;
+};
+
 }  // namespace views
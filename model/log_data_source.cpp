@@ -0,0 +1,551 @@
+#include "graph_qt/model/log_data_source.h"
+
+#include <QDir>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <limits>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace views {
+
+namespace {
+
+using BlockHeader = LogDataSource::BlockHeader;
+
+// Upper bound of the count of a valid block, to reject garbage headers before
+// reading their payload.
+constexpr uint32_t kMaxBlockSize = 1 << 24;
+
+constexpr std::array<uint32_t, 256> MakeCrcTable() {
+  std::array<uint32_t, 256> table{};
+  for (uint32_t i = 0; i < table.size(); ++i) {
+    uint32_t crc = i;
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = crc & 1 ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+    }
+    table[i] = crc;
+  }
+  return table;
+}
+
+// CRC-32 (IEEE). Continues from `crc`, which is zero for the first bytes.
+uint32_t UpdateCrc(uint32_t crc, std::span<const std::byte> bytes) {
+  static constexpr auto kTable = MakeCrcTable();
+  crc = ~crc;
+  for (std::byte byte : bytes) {
+    crc = kTable[(crc ^ static_cast<uint8_t>(byte)) & 0xFF] ^ (crc >> 8);
+  }
+  return ~crc;
+}
+
+size_t GetPayloadSize(uint32_t count) {
+  return count * 2 * sizeof(double) + (count + 63) / 64 * sizeof(uint64_t);
+}
+
+uint32_t CalculateChecksum(BlockHeader header,
+                           std::span<const std::byte> payload) {
+  header.checksum = 0;
+  uint32_t crc = UpdateCrc(0, std::as_bytes(std::span{&header, 1}));
+  return UpdateCrc(crc, payload);
+}
+
+// Splits `points` into the columns of a block payload.
+std::vector<std::byte> EncodePayload(std::span<const GraphPoint> points) {
+  const size_t count = points.size();
+  std::vector<std::byte> payload(GetPayloadSize(count));
+  auto* x = reinterpret_cast<double*>(payload.data());
+  auto* y = x + count;
+  auto* quality = reinterpret_cast<uint64_t*>(y + count);
+  for (size_t i = 0; i < count; ++i) {
+    x[i] = points[i].x;
+    y[i] = points[i].y;
+    quality[i / 64] |= uint64_t{points[i].good} << (i % 64);
+  }
+  return payload;
+}
+
+void DecodePayload(std::span<const std::byte> payload,
+                   uint32_t count,
+                   std::vector<GraphPoint>& points) {
+  std::vector<double> columns(count * 2);
+  std::vector<uint64_t> quality((count + 63) / 64);
+  std::memcpy(columns.data(), payload.data(), columns.size() * sizeof(double));
+  std::memcpy(quality.data(), payload.data() + columns.size() * sizeof(double),
+              quality.size() * sizeof(uint64_t));
+  points.clear();
+  points.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    auto& point = points.emplace_back(columns[i], columns[count + i]);
+    point.good = (quality[i / 64] >> (i % 64)) & 1;
+  }
+}
+
+bool ReadBytes(QFile& file, uint64_t offset, std::span<std::byte> bytes) {
+  const auto size = static_cast<qint64>(bytes.size());
+  return file.seek(static_cast<qint64>(offset)) &&
+         file.read(reinterpret_cast<char*>(bytes.data()), size) == size;
+}
+
+bool WriteBytes(QFile& file, std::span<const std::byte> bytes) {
+  const auto size = static_cast<qint64>(bytes.size());
+  return file.write(reinterpret_cast<const char*>(bytes.data()), size) == size;
+}
+
+}  // namespace
+
+// Enumerates the decoded points of the boundary blocks, the blocks between
+// them, and the points not written yet. The blocks between are read one at a
+// time when the enumeration reaches them.
+class LogDataSource::BlockPointEnumerator : public PointEnumerator {
+ public:
+  BlockPointEnumerator(const LogDataSource& data_source,
+                       std::vector<GraphPoint> head,
+                       std::span<const Block> blocks,
+                       std::vector<GraphPoint> tail,
+                       std::span<const GraphPoint> pending)
+      : data_source_{data_source},
+        head_{std::move(head)},
+        blocks_{blocks},
+        tail_{std::move(tail)},
+        pending_{pending} {
+    count_ = head_.size() + tail_.size() + pending_.size();
+    for (const auto& block : blocks_) {
+      count_ += block.header.count;
+    }
+  }
+
+  size_t GetCount() const override { return count_; }
+
+  bool EnumNext(GraphPoint& value) override {
+    return EnumNextBatch(std::span{&value, 1}) == 1;
+  }
+
+  size_t EnumNextBatch(std::span<GraphPoint> points) override {
+    if (current_.empty() && !Advance()) {
+      return 0;
+    }
+    size_t count = std::min(points.size(), current_.size());
+    std::copy_n(current_.begin(), count, points.begin());
+    current_ = current_.subspan(count);
+    count_ -= std::min(count_, count);
+    return count;
+  }
+
+ private:
+  enum class Stage { kHead, kBlocks, kTail, kPending, kDone };
+
+  // Moves to the next non-empty part. Returns false at the end.
+  bool Advance() {
+    while (current_.empty()) {
+      switch (stage_) {
+        case Stage::kHead:
+          current_ = head_;
+          stage_ = Stage::kBlocks;
+          break;
+        case Stage::kBlocks:
+          if (blocks_.empty()) {
+            stage_ = Stage::kTail;
+            break;
+          }
+          // A corrupted block is skipped.
+          if (!data_source_.ReadBlock(blocks_.front(), buffer_)) {
+            count_ -= std::min<size_t>(count_, blocks_.front().header.count);
+            buffer_.clear();
+          }
+          blocks_ = blocks_.subspan(1);
+          current_ = buffer_;
+          break;
+        case Stage::kTail:
+          current_ = tail_;
+          stage_ = Stage::kPending;
+          break;
+        case Stage::kPending:
+          current_ = pending_;
+          stage_ = Stage::kDone;
+          break;
+        case Stage::kDone:
+          return false;
+      }
+    }
+    return true;
+  }
+
+  const LogDataSource& data_source_;
+  const std::vector<GraphPoint> head_;
+  std::span<const Block> blocks_;
+  const std::vector<GraphPoint> tail_;
+  const std::span<const GraphPoint> pending_;
+
+  size_t count_ = 0;
+  Stage stage_ = Stage::kHead;
+  std::span<const GraphPoint> current_;
+  std::vector<GraphPoint> buffer_;
+};
+
+LogDataSource::LogDataSource(const Options& options,
+                             GraphRange::Kind horizontal_kind)
+    : options_{options}, horizontal_kind_{horizontal_kind} {
+  assert(options_.block_size > 0 && options_.block_size <= kMaxBlockSize);
+  assert(options_.blocks_per_segment > 0);
+  pending_.reserve(options_.block_size);
+}
+
+LogDataSource::~LogDataSource() {
+  Flush();
+}
+
+QString LogDataSource::GetSegmentPath(size_t index) const {
+  return QDir{directory_}.filePath("segment-" + QString::number(index) +
+                                   ".log");
+}
+
+bool LogDataSource::Open(const QString& directory) {
+  Close();
+
+  directory_ = directory;
+  bool result = QDir{directory_}.mkpath(".");
+
+  for (size_t index = 0; result && QFile::exists(GetSegmentPath(index));
+       ++index) {
+    auto segment = std::make_unique<QFile>(GetSegmentPath(index));
+    if (!segment->open(QIODevice::ReadWrite)) {
+      result = false;
+      break;
+    }
+    segments_.push_back(std::move(segment));
+    segment_block_count_ = 0;
+
+    if (!RecoverSegment(index)) {
+      // Later segments were written after the torn block, so they can't be
+      // consistent with it.
+      for (size_t later = index + 1; QFile::exists(GetSegmentPath(later));
+           ++later) {
+        QFile::remove(GetSegmentPath(later));
+      }
+      break;
+    }
+  }
+
+  if (result && segments_.empty()) {
+    auto segment = std::make_unique<QFile>(GetSegmentPath(0));
+    result = segment->open(QIODevice::ReadWrite);
+    segments_.push_back(std::move(segment));
+  }
+
+  if (!result) {
+    segments_.clear();
+    blocks_.clear();
+    stored_count_ = 0;
+  }
+
+  if (!blocks_.empty()) {
+    std::vector<GraphPoint> points;
+    last_point_ = ReadBlock(blocks_.back(), points)
+                      ? points.back()
+                      : GraphPoint{blocks_.back().header.last_x,
+                                   kGraphUnknownValue};
+  }
+
+  vertical_range_ = GraphRange{};
+  for (const auto& block : blocks_) {
+    vertical_range_ =
+        &block == &blocks_.front()
+            ? GraphRange{block.header.min_y, block.header.max_y}
+            : GraphRange{std::min(vertical_range_.low(), block.header.min_y),
+                         std::max(vertical_range_.high(), block.header.max_y)};
+  }
+
+  if (observer_) {
+    observer_->OnDataSourceCurrentValueChanged();
+    observer_->OnDataSourceHistoryChanged();
+  }
+  return result;
+}
+
+bool LogDataSource::RecoverSegment(size_t index) {
+  QFile& segment = *segments_[index];
+  const auto size = static_cast<uint64_t>(segment.size());
+
+  uint64_t offset = 0;
+  std::vector<std::byte> payload;
+  while (offset < size) {
+    BlockHeader header;
+    bool valid = size - offset >= sizeof(header) &&
+                 ReadBytes(segment, offset,
+                           std::as_writable_bytes(std::span{&header, 1})) &&
+                 header.magic == BlockHeader::kMagic && header.count != 0 &&
+                 header.count <= kMaxBlockSize &&
+                 (blocks_.empty() ||
+                  header.first_x >= blocks_.back().header.last_x);
+    if (valid) {
+      payload.resize(GetPayloadSize(header.count));
+      valid = size - offset - sizeof(header) >= payload.size() &&
+              ReadBytes(segment, offset + sizeof(header), payload) &&
+              CalculateChecksum(header, payload) == header.checksum;
+    }
+
+    if (!valid) {
+      segment.resize(static_cast<qint64>(offset));
+      return false;
+    }
+
+    blocks_.push_back({index, offset, header});
+    stored_count_ += header.count;
+    ++segment_block_count_;
+    offset += sizeof(header) + payload.size();
+  }
+  return true;
+}
+
+void LogDataSource::Close() {
+  Flush();
+  segments_.clear();
+  blocks_.clear();
+  stored_count_ = 0;
+  segment_block_count_ = 0;
+  unsynced_block_count_ = 0;
+  write_error_ = false;
+  pending_.clear();
+  vertical_range_ = GraphRange{};
+}
+
+void LogDataSource::AddPoint(const GraphPoint& point) {
+  AddPoints(std::span{&point, 1});
+}
+
+void LogDataSource::AddPoints(std::span<const GraphPoint> points) {
+  if (points.empty()) {
+    return;
+  }
+
+  for (const auto& point : points) {
+    assert(size() == 0 || point.x >= last_point_.x);
+    vertical_range_ =
+        size() == 0 ? GraphRange{point.y, point.y}
+                    : GraphRange{std::min(vertical_range_.low(), point.y),
+                                 std::max(vertical_range_.high(), point.y)};
+    pending_.push_back(point);
+    last_point_ = point;
+    if (pending_.size() >= options_.block_size && !write_error_) {
+      WriteBlock();
+    }
+  }
+
+  if (observer_) {
+    observer_->OnDataSourceCurrentValueChanged();
+    observer_->OnDataSourcePointsAppended();
+  }
+}
+
+bool LogDataSource::Flush() {
+  return WriteBlock() && Sync();
+}
+
+bool LogDataSource::WriteBlock() {
+  if (pending_.empty() || segments_.empty()) {
+    return !write_error_;
+  }
+
+  if (segment_block_count_ == options_.blocks_per_segment) {
+    // The full segment is synced before the next one exists, so only the
+    // last segment can end with a torn block.
+    auto segment = std::make_unique<QFile>(GetSegmentPath(segments_.size()));
+    if (!Sync() || !segment->open(QIODevice::ReadWrite)) {
+      write_error_ = true;
+      return false;
+    }
+    segments_.push_back(std::move(segment));
+    segment_block_count_ = 0;
+  }
+
+  BlockHeader header = {};
+  header.magic = BlockHeader::kMagic;
+  header.count = static_cast<uint32_t>(pending_.size());
+  header.first_x = pending_.front().x;
+  header.last_x = pending_.back().x;
+  auto [min, max] = std::ranges::minmax(pending_, {}, &GraphPoint::y);
+  header.min_y = min.y;
+  header.max_y = max.y;
+  const auto payload = EncodePayload(pending_);
+  header.checksum = CalculateChecksum(header, payload);
+
+  QFile& segment = *segments_.back();
+  const auto offset = static_cast<uint64_t>(segment.size());
+  if (!segment.seek(static_cast<qint64>(offset)) ||
+      !WriteBytes(segment, std::as_bytes(std::span{&header, 1})) ||
+      !WriteBytes(segment, payload)) {
+    write_error_ = true;
+    return false;
+  }
+
+  blocks_.push_back({segments_.size() - 1, offset, header});
+  stored_count_ += header.count;
+  ++segment_block_count_;
+  pending_.clear();
+
+  if (options_.sync_interval != 0 &&
+      ++unsynced_block_count_ >= options_.sync_interval) {
+    return Sync();
+  }
+  return true;
+}
+
+bool LogDataSource::Sync() {
+  if (segments_.empty()) {
+    return !write_error_;
+  }
+
+  QFile& segment = *segments_.back();
+  bool result = segment.flush();
+#if defined(_WIN32)
+  result = result && _commit(segment.handle()) == 0;
+#else
+  result = result && fsync(segment.handle()) == 0;
+#endif
+  if (!result) {
+    write_error_ = true;
+  }
+  unsynced_block_count_ = 0;
+  return result;
+}
+
+bool LogDataSource::ReadBlock(const Block& block,
+                              std::vector<GraphPoint>& points) const {
+  std::vector<std::byte> payload(GetPayloadSize(block.header.count));
+  if (!ReadBytes(*segments_[block.segment], block.offset + sizeof(BlockHeader),
+                 payload) ||
+      CalculateChecksum(block.header, payload) != block.header.checksum) {
+    return false;
+  }
+  DecodePayload(payload, block.header.count, points);
+  return true;
+}
+
+double LogDataSource::GetCurrentValue() const {
+  return size() == 0 ? kGraphUnknownValue : last_point_.y;
+}
+
+std::unique_ptr<PointEnumerator> LogDataSource::EnumPoints(
+    double from,
+    double to,
+    bool include_left_bound,
+    bool include_right_bound) {
+  auto is_after_from = [&](double x) {
+    return include_left_bound ? x >= from : x > from;
+  };
+  auto is_before_to = [&](double x) {
+    return include_right_bound ? x <= to : x < to;
+  };
+
+  auto read_in_range = [&](const Block& block) {
+    std::vector<GraphPoint> points;
+    if (ReadBlock(block, points)) {
+      std::erase_if(points, [&](const GraphPoint& point) {
+        return !is_after_from(point.x) || !is_before_to(point.x);
+      });
+    }
+    return points;
+  };
+
+  // Blocks overlapping the range.
+  std::span<const Block> blocks{blocks_};
+  auto first_block = std::ranges::partition_point(
+      blocks, [&](const Block& b) { return !is_after_from(b.header.last_x); });
+  auto last_block = std::ranges::partition_point(
+      blocks, [&](const Block& b) { return is_before_to(b.header.first_x); });
+  if (last_block < first_block) {
+    last_block = first_block;
+  }
+
+  // Read the boundary blocks partially covered by the range.
+  std::vector<GraphPoint> head;
+  if (first_block != last_block &&
+      !is_after_from(first_block->header.first_x)) {
+    head = read_in_range(*first_block++);
+  }
+  std::vector<GraphPoint> tail;
+  if (first_block != last_block &&
+      !is_before_to(std::prev(last_block)->header.last_x)) {
+    tail = read_in_range(*--last_block);
+  }
+
+  auto first_point = std::ranges::partition_point(
+      pending_, [&](const GraphPoint& p) { return !is_after_from(p.x); });
+  auto last_point = std::ranges::partition_point(
+      pending_, [&](const GraphPoint& p) { return is_before_to(p.x); });
+  if (last_point < first_point) {
+    last_point = first_point;
+  }
+
+  auto point_enum = std::make_unique<BlockPointEnumerator>(
+      *this, std::move(head), std::span{first_block, last_block},
+      std::move(tail), std::span{first_point, last_point});
+  if (point_enum->GetCount() == 0) {
+    return nullptr;
+  }
+  return point_enum;
+}
+
+GraphRange LogDataSource::GetHorizontalRange() const {
+  if (size() == 0) {
+    return GraphRange{};
+  }
+  double low = blocks_.empty() ? pending_.front().x
+                               : blocks_.front().header.first_x;
+  double high = pending_.empty() ? blocks_.back().header.last_x
+                                 : pending_.back().x;
+  return GraphRange{low, high, horizontal_kind_};
+}
+
+GraphRange LogDataSource::GetVerticalRange() const {
+  return vertical_range_;
+}
+
+std::optional<GraphRange> LogDataSource::QueryVerticalRange(double x1,
+                                                            double x2) const {
+  double low = std::numeric_limits<double>::max();
+  double high = std::numeric_limits<double>::lowest();
+  auto add_point = [&](const GraphPoint& point) {
+    if (point.x >= x1 && point.x < x2) {
+      low = std::min(low, point.y);
+      high = std::max(high, point.y);
+    }
+  };
+
+  // Blocks inside the range contribute the extremes of their headers, and
+  // only the boundary blocks are read.
+  std::span<const Block> blocks{blocks_};
+  auto first_block = std::ranges::partition_point(
+      blocks, [&](const Block& b) { return b.header.last_x < x1; });
+  auto last_block = std::ranges::partition_point(
+      blocks, [&](const Block& b) { return b.header.first_x < x2; });
+  std::vector<GraphPoint> points;
+  for (const auto& block : std::span{first_block,
+                                     std::max(first_block, last_block)}) {
+    if (block.header.first_x >= x1 && block.header.last_x < x2) {
+      low = std::min(low, block.header.min_y);
+      high = std::max(high, block.header.max_y);
+    } else if (ReadBlock(block, points)) {
+      std::ranges::for_each(points, add_point);
+    }
+  }
+  auto first_point = std::ranges::partition_point(
+      pending_, [&](const GraphPoint& p) { return p.x < x1; });
+  auto last_point = std::ranges::partition_point(
+      pending_, [&](const GraphPoint& p) { return p.x < x2; });
+  std::for_each(first_point, std::max(first_point, last_point), add_point);
+
+  if (low > high) {
+    return GraphRange{};
+  }
+  return GraphRange{low, high};
+}
+
+}  // namespace views
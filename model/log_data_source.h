@@ -0,0 +1,141 @@
+#pragma once
+
+#include "graph_qt/model/graph_data_source.h"
+
+#include <QFile>
+#include <QString>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace views {
+
+// Data source persisting appended points in an append-only log, so that the
+// history of a live tag survives a restart. Points are collected in memory
+// and written in blocks of `block_size` points to segment files
+// `segment-<n>.log` in a directory, with a new segment every
+// `blocks_per_segment` blocks.
+//
+// Every block starts with a `BlockHeader` holding its x range, its extremes
+// and a CRC-32 of the block. The headers form a sparse in-memory index, so
+// enumeration reads only the blocks overlapping the range. The files are
+// synced every `sync_interval` blocks. On opening, the log is recovered up to
+// the last block with a valid checksum, and a torn block at the end is
+// truncated.
+//
+// Block layout, in native byte order:
+//
+//   BlockHeader
+//   x column        count doubles
+//   y column        count doubles
+//   quality bitmap  ceil(count / 64) uint64s
+class LogDataSource : public GraphDataSource {
+ public:
+  struct Options {
+    size_t block_size = 4096;
+    size_t blocks_per_segment = 256;
+    // Number of blocks written between syncs, zero to sync only on `Flush()`.
+    size_t sync_interval = 16;
+  };
+
+  struct BlockHeader {
+    static constexpr uint32_t kMagic = 0x424C5147;  // "GQLB"
+
+    uint32_t magic;
+    uint32_t count;
+    // CRC-32 of the header with a zero checksum, followed by the payload.
+    uint32_t checksum;
+    uint32_t reserved;
+    double first_x;
+    double last_x;
+    double min_y;
+    double max_y;
+  };
+
+  explicit LogDataSource(const Options& options,
+                         GraphRange::Kind horizontal_kind = GraphRange::LINEAR);
+  ~LogDataSource() override;
+
+  size_t size() const { return stored_count_ + pending_.size(); }
+  size_t block_count() const { return blocks_.size(); }
+
+  // True if a write to the log failed. Points added since stay in memory.
+  bool has_write_error() const { return write_error_; }
+
+  // Opens the log in `directory`, creating it if needed, and recovers the
+  // stored points. Returns false if the log can't be opened. Sends
+  // `OnDataSourceHistoryChanged()`.
+  bool Open(const QString& directory);
+
+  // Flushes and closes the log.
+  void Close();
+
+  // Appends points. The points must be sorted by x, and the first one must not
+  // precede the last existing point. Sends a single
+  // `OnDataSourcePointsAppended()`.
+  void AddPoint(const GraphPoint& point);
+  void AddPoints(std::span<const GraphPoint> points);
+
+  // Writes the collected points as a block, even if it isn't full, and syncs
+  // the log. Returns false on a write error.
+  bool Flush();
+
+  // GraphDataSource
+  double GetCurrentValue() const override;
+  std::unique_ptr<PointEnumerator> EnumPoints(
+      double from,
+      double to,
+      bool include_left_bound,
+      bool include_right_bound) override;
+  GraphRange GetHorizontalRange() const override;
+  GraphRange GetVerticalRange() const override;
+  std::optional<GraphRange> QueryVerticalRange(double x1,
+                                               double x2) const override;
+
+ private:
+  class BlockPointEnumerator;
+
+  // Index entry of a block stored in a segment.
+  struct Block {
+    size_t segment;
+    uint64_t offset;
+    BlockHeader header;
+  };
+
+  QString GetSegmentPath(size_t index) const;
+
+  // Reads the blocks of segment `index`, truncating it after the last valid
+  // block. Returns false if the segment ends with an invalid block.
+  bool RecoverSegment(size_t index);
+
+  bool WriteBlock();
+  bool Sync();
+
+  // Reads the points of `block`. Returns false on a read error or if the
+  // block was corrupted since it was indexed.
+  bool ReadBlock(const Block& block, std::vector<GraphPoint>& points) const;
+
+  const Options options_;
+  const GraphRange::Kind horizontal_kind_;
+
+  QString directory_;
+  std::vector<std::unique_ptr<QFile>> segments_;
+  size_t segment_block_count_ = 0;
+  size_t unsynced_block_count_ = 0;
+  bool write_error_ = false;
+
+  std::vector<Block> blocks_;
+  size_t stored_count_ = 0;
+
+  // Points not written yet.
+  std::vector<GraphPoint> pending_;
+
+  // The last point, stored or pending, if `size() != 0`. Cached so that the
+  // current value and the order checks don't read the last block back.
+  GraphPoint last_point_;
+
+  GraphRange vertical_range_;
+};
+
+}  // namespace views
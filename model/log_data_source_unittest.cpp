@@ -0,0 +1,134 @@
+#include "graph_qt/model/log_data_source.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace views {
+
+namespace {
+
+constexpr LogDataSource::Options kOptions{.block_size = 100,
+                                          .blocks_per_segment = 4,
+                                          .sync_interval = 2};
+
+std::vector<GraphPoint> MakePoints(size_t count) {
+  std::vector<GraphPoint> points;
+  for (size_t i = 0; i < count; ++i) {
+    auto& point = points.emplace_back(static_cast<double>(i),
+                                      static_cast<double>(i % 250));
+    point.good = i % 7 != 0;
+  }
+  return points;
+}
+
+std::vector<GraphPoint> EnumAllPoints(
+    std::unique_ptr<PointEnumerator> point_enum) {
+  std::vector<GraphPoint> points;
+  if (point_enum) {
+    size_t count = point_enum->GetCount();
+    ForEachPoint(*point_enum,
+                 [&](const GraphPoint& point) { points.push_back(point); });
+    EXPECT_EQ(points.size(), count);
+  }
+  return points;
+}
+
+class LogDataSourceTest : public ::testing::Test {
+ protected:
+  void SetUp() override { ASSERT_TRUE(temp_dir_.isValid()); }
+
+  QTemporaryDir temp_dir_;
+};
+
+}  // namespace
+
+TEST_F(LogDataSourceTest, EnumPoints) {
+  const auto points = MakePoints(1050);
+  LogDataSource data_source{kOptions};
+  ASSERT_TRUE(data_source.Open(temp_dir_.path()));
+  data_source.AddPoints(points);
+
+  EXPECT_EQ(data_source.block_count(), 10u);
+  EXPECT_EQ(data_source.size(), points.size());
+  EXPECT_EQ(data_source.GetHorizontalRange(), GraphRange(0, 1049));
+  EXPECT_EQ(data_source.GetVerticalRange(), GraphRange(0, 249));
+  EXPECT_EQ(data_source.GetCurrentValue(), points.back().y);
+  EXPECT_TRUE(QFile::exists(temp_dir_.filePath("segment-2.log")));
+
+  EXPECT_EQ(EnumAllPoints(data_source.EnumPoints(0, 1049, true, true)),
+            points);
+  EXPECT_EQ(EnumAllPoints(data_source.EnumPoints(150, 1020, false, true)),
+            std::vector<GraphPoint>(points.begin() + 151,
+                                    points.begin() + 1021));
+  EXPECT_EQ(EnumAllPoints(data_source.EnumPoints(120, 130, true, false)),
+            std::vector<GraphPoint>(points.begin() + 120,
+                                    points.begin() + 130));
+  EXPECT_FALSE(data_source.EnumPoints(2000, 3000, true, true));
+
+  EXPECT_EQ(data_source.QueryVerticalRange(0, 1050), GraphRange(0, 249));
+  EXPECT_EQ(data_source.QueryVerticalRange(240, 260), GraphRange(0, 249));
+  EXPECT_EQ(data_source.QueryVerticalRange(260, 480), GraphRange(10, 229));
+}
+
+TEST_F(LogDataSourceTest, Reopen) {
+  const auto points = MakePoints(1050);
+  {
+    LogDataSource data_source{kOptions};
+    ASSERT_TRUE(data_source.Open(temp_dir_.path()));
+    data_source.AddPoints(points);
+  }
+
+  LogDataSource data_source{kOptions};
+  ASSERT_TRUE(data_source.Open(temp_dir_.path()));
+  EXPECT_EQ(data_source.block_count(), 11u);
+  EXPECT_EQ(data_source.GetCurrentValue(), points.back().y);
+  EXPECT_EQ(EnumAllPoints(data_source.EnumPoints(0, 1049, true, true)),
+            points);
+
+  // Appending continues after the recovered points.
+  const auto more_points = MakePoints(1200);
+  data_source.AddPoints(std::span{more_points}.subspan(points.size()));
+  EXPECT_TRUE(data_source.Flush());
+  EXPECT_EQ(EnumAllPoints(data_source.EnumPoints(0, 1199, true, true)),
+            more_points);
+}
+
+TEST_F(LogDataSourceTest, TruncatesTornBlock) {
+  const auto points = MakePoints(300);
+  {
+    LogDataSource data_source{kOptions};
+    ASSERT_TRUE(data_source.Open(temp_dir_.path()));
+    data_source.AddPoints(points);
+  }
+
+  // Corrupt the last block of the first segment.
+  QFile segment{temp_dir_.filePath("segment-0.log")};
+  ASSERT_TRUE(segment.open(QIODevice::ReadWrite));
+  const qint64 size = segment.size();
+  ASSERT_TRUE(segment.seek(size - 10));
+  ASSERT_EQ(segment.write("garbage", 7), 7);
+  segment.close();
+
+  LogDataSource data_source{kOptions};
+  ASSERT_TRUE(data_source.Open(temp_dir_.path()));
+  EXPECT_EQ(data_source.block_count(), 2u);
+  EXPECT_EQ(EnumAllPoints(data_source.EnumPoints(0, 299, true, true)),
+            std::vector<GraphPoint>(points.begin(), points.begin() + 200));
+  EXPECT_EQ(segment.size(), size / 3 * 2);
+}
+
+TEST_F(LogDataSourceTest, KeepsPointsWithoutLog) {
+  const auto points = MakePoints(250);
+  LogDataSource data_source{kOptions};
+  data_source.AddPoints(points);
+
+  EXPECT_EQ(data_source.block_count(), 0u);
+  EXPECT_FALSE(data_source.has_write_error());
+  EXPECT_EQ(EnumAllPoints(data_source.EnumPoints(0, 249, true, true)),
+            points);
+}
+
+}  // namespace views
@@ -0,0 +1,259 @@
+#include "graph_qt/model/merge_buffer_data_source.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <utility>
+
+namespace views {
+
+// Merges the sorted points of the main store, the frozen delta and the delta.
+// On equal x the points come in that order, as they were added earlier. The
+// delta is read in place, so the source must not be modified while the
+// enumerator is alive.
+class MergeBufferDataSource::MergingPointEnumerator : public PointEnumerator {
+ public:
+  MergingPointEnumerator(std::span<const GraphPoint> points,
+                         std::span<const GraphPoint> tail,
+                         std::span<const GraphPoint> frozen_delta,
+                         Delta::const_iterator delta_first,
+                         Delta::const_iterator delta_last,
+                         size_t delta_count)
+      : points_{points},
+        tail_{tail},
+        frozen_delta_{frozen_delta},
+        delta_{delta_first},
+        delta_last_{delta_last},
+        count_{points.size() + tail.size() + frozen_delta.size() +
+               delta_count} {}
+
+  size_t GetCount() const override { return count_; }
+
+  bool EnumNext(GraphPoint& value) override {
+    return EnumNextBatch(std::span{&value, 1}) == 1;
+  }
+
+  size_t EnumNextBatch(std::span<GraphPoint> points) override {
+    size_t count = 0;
+    for (; count < points.size() && count_ != 0; ++count, --count_) {
+      // The tail follows the main store.
+      if (points_.empty()) {
+        points_ = std::exchange(tail_, {});
+      }
+
+      if (!frozen_delta_.empty() &&
+          (points_.empty() || frozen_delta_.front().x < points_.front().x) &&
+          (delta_ == delta_last_ || frozen_delta_.front().x <= delta_->x)) {
+        points[count] = frozen_delta_.front();
+        frozen_delta_ = frozen_delta_.subspan(1);
+      } else if (delta_ != delta_last_ &&
+                 (points_.empty() || delta_->x < points_.front().x)) {
+        points[count] = *delta_++;
+      } else {
+        points[count] = points_.front();
+        points_ = points_.subspan(1);
+      }
+    }
+    return count;
+  }
+
+ private:
+  std::span<const GraphPoint> points_;
+  std::span<const GraphPoint> tail_;
+  std::span<const GraphPoint> frozen_delta_;
+  Delta::const_iterator delta_;
+  const Delta::const_iterator delta_last_;
+  size_t count_;
+};
+
+MergeBufferDataSource::MergeBufferDataSource(GraphRange::Kind horizontal_kind)
+    : horizontal_kind_{horizontal_kind} {}
+
+MergeBufferDataSource::~MergeBufferDataSource() {
+  if (compaction_thread_.joinable()) {
+    compaction_thread_.join();
+  }
+}
+
+void MergeBufferDataSource::AddPoint(const GraphPoint& point) {
+  AddPoints(std::span{&point, 1});
+}
+
+void MergeBufferDataSource::AddPoints(std::span<const GraphPoint> points) {
+  if (points.empty()) {
+    return;
+  }
+
+  bool appended = true;
+  for (const auto& point : points) {
+    appended &= Insert(point);
+  }
+
+  if (compaction_done_.load(std::memory_order_acquire)) {
+    FinishCompaction();
+  }
+  if (!is_compacting() && delta_.size() > kMaxDeltaSize) {
+    StartCompaction();
+  }
+
+  if (observer_) {
+    observer_->OnDataSourceCurrentValueChanged();
+    if (appended) {
+      observer_->OnDataSourcePointsAppended();
+    } else {
+      observer_->OnDataSourceHistoryChanged();
+    }
+  }
+}
+
+bool MergeBufferDataSource::Insert(const GraphPoint& point) {
+  vertical_range_ =
+      size() == 0 ? GraphRange{point.y, point.y}
+                  : GraphRange{std::min(vertical_range_.low(), point.y),
+                               std::max(vertical_range_.high(), point.y)};
+
+  const GraphPoint* last_point = GetLastPoint();
+  if (!last_point || point.x >= last_point->x) {
+    (is_compacting() ? tail_ : points_).push_back(point);
+    return true;
+  }
+
+  delta_.insert(point);
+  return false;
+}
+
+const GraphPoint* MergeBufferDataSource::GetLastPoint() const {
+  if (!tail_.empty()) {
+    return &tail_.back();
+  }
+  return points_.empty() ? nullptr : &points_.back();
+}
+
+void MergeBufferDataSource::StartCompaction() {
+  assert(!is_compacting());
+  frozen_delta_.assign(delta_.begin(), delta_.end());
+  delta_.clear();
+
+  compaction_done_.store(false, std::memory_order_relaxed);
+  compaction_thread_ = std::thread{[this] {
+    std::vector<GraphPoint> merged;
+    merged.reserve(points_.size() + frozen_delta_.size());
+    std::ranges::merge(points_, frozen_delta_, std::back_inserter(merged),
+                       LessX{});
+    compacted_points_ = std::move(merged);
+    compaction_done_.store(true, std::memory_order_release);
+  }};
+}
+
+void MergeBufferDataSource::FinishCompaction() {
+  compaction_thread_.join();
+  compaction_done_.store(false, std::memory_order_relaxed);
+
+  points_ = std::exchange(compacted_points_, {});
+  points_.insert(points_.end(), tail_.begin(), tail_.end());
+  tail_.clear();
+  frozen_delta_.clear();
+}
+
+void MergeBufferDataSource::Compact() {
+  if (is_compacting()) {
+    FinishCompaction();
+  }
+  if (delta_.empty()) {
+    return;
+  }
+
+  std::vector<GraphPoint> merged;
+  merged.reserve(size());
+  std::ranges::merge(points_, delta_, std::back_inserter(merged), LessX{});
+  points_ = std::move(merged);
+  delta_.clear();
+}
+
+double MergeBufferDataSource::GetCurrentValue() const {
+  const GraphPoint* last_point = GetLastPoint();
+  return last_point ? last_point->y : kGraphUnknownValue;
+}
+
+std::unique_ptr<PointEnumerator> MergeBufferDataSource::EnumPoints(
+    double from,
+    double to,
+    bool include_left_bound,
+    bool include_right_bound) {
+  auto find_range = [&](std::span<const GraphPoint> points) {
+    auto first =
+        include_left_bound
+            ? std::ranges::lower_bound(points, from, {}, &GraphPoint::x)
+            : std::ranges::upper_bound(points, from, {}, &GraphPoint::x);
+    auto last = std::max(
+        first, include_right_bound
+                   ? std::ranges::upper_bound(points, to, {}, &GraphPoint::x)
+                   : std::ranges::lower_bound(points, to, {}, &GraphPoint::x));
+    return std::span{first, last};
+  };
+  auto points = find_range(points_);
+  auto tail = find_range(tail_);
+  auto frozen_delta = find_range(frozen_delta_);
+
+  // Multiset iterators are only bidirectional, so emptiness is decided by
+  // comparing keys rather than by the distance between the bounds.
+  auto delta_first = include_left_bound ? delta_.lower_bound(from)
+                                        : delta_.upper_bound(from);
+  auto delta_last = delta_first;
+  if (delta_first != delta_.end() &&
+      (include_right_bound ? delta_first->x <= to : delta_first->x < to)) {
+    delta_last = include_right_bound ? delta_.upper_bound(to)
+                                     : delta_.lower_bound(to);
+  }
+  const size_t delta_count =
+      delta_first == delta_last ? 0 : std::distance(delta_first, delta_last);
+
+  if (points.empty() && tail.empty() && frozen_delta.empty() &&
+      delta_count == 0) {
+    return nullptr;
+  }
+
+  return std::make_unique<MergingPointEnumerator>(
+      points, tail, frozen_delta, delta_first, delta_last, delta_count);
+}
+
+GraphRange MergeBufferDataSource::GetHorizontalRange() const {
+  if (points_.empty()) {
+    return GraphRange{};
+  }
+  double low = points_.front().x;
+  if (!frozen_delta_.empty()) {
+    low = std::min(low, frozen_delta_.front().x);
+  }
+  if (!delta_.empty()) {
+    low = std::min(low, delta_.begin()->x);
+  }
+  return GraphRange{low, GetLastPoint()->x, horizontal_kind_};
+}
+
+GraphRange MergeBufferDataSource::GetVerticalRange() const {
+  return vertical_range_;
+}
+
+std::optional<size_t> MergeBufferDataSource::LowerBound(double value) const {
+  return FindBound(value, false);
+}
+
+std::optional<size_t> MergeBufferDataSource::UpperBound(double value) const {
+  return FindBound(value, true);
+}
+
+size_t MergeBufferDataSource::FindBound(double value, bool upper) const {
+  auto find_bound = [&](std::span<const GraphPoint> points) {
+    auto bound =
+        upper ? std::ranges::upper_bound(points, value, {}, &GraphPoint::x)
+              : std::ranges::lower_bound(points, value, {}, &GraphPoint::x);
+    return static_cast<size_t>(bound - points.begin());
+  };
+  auto delta_bound =
+      upper ? delta_.upper_bound(value) : delta_.lower_bound(value);
+  return find_bound(points_) + find_bound(tail_) + find_bound(frozen_delta_) +
+         static_cast<size_t>(std::distance(delta_.begin(), delta_bound));
+}
+
+}  // namespace views
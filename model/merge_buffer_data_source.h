@@ -0,0 +1,110 @@
+#pragma once
+
+#include "graph_qt/model/graph_data_source.h"
+
+#include <atomic>
+#include <set>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace views {
+
+// Data source accepting points out of order, e.g. samples backfilled by a
+// device reconnecting after an outage. Points at or after the last point are
+// appended to the sorted main store in O(1). Late points go to a small sorted
+// delta buffer in O(log n), and enumeration merges both transparently.
+//
+// When the delta grows past `kMaxDeltaSize`, a worker thread merges it into a
+// copy of the main store, while points keep being added: appended points go
+// to a tail, and late ones to a new delta. The merged store replaces the main
+// store on the next `AddPoints()` after the worker is done, which then only
+// moves the tail. `Compact()` merges everything on the calling thread, e.g.
+// when the application is idle.
+class MergeBufferDataSource : public GraphDataSource {
+ public:
+  static constexpr size_t kMaxDeltaSize = 4096;
+
+  explicit MergeBufferDataSource(
+      GraphRange::Kind horizontal_kind = GraphRange::LINEAR);
+  // Waits for a running compaction.
+  ~MergeBufferDataSource() override;
+
+  size_t size() const {
+    return points_.size() + tail_.size() + frozen_delta_.size() +
+           delta_.size();
+  }
+  size_t delta_size() const { return frozen_delta_.size() + delta_.size(); }
+  bool is_compacting() const { return compaction_thread_.joinable(); }
+
+  // Adds points in any order. Notifies `OnDataSourcePointsAppended()` if all
+  // points were appended, and `OnDataSourceHistoryChanged()` otherwise.
+  void AddPoint(const GraphPoint& point);
+  void AddPoints(std::span<const GraphPoint> points);
+
+  // Waits for a running compaction, and merges the delta buffer into the main
+  // store in O(n). Doesn't notify, as the points don't change.
+  void Compact();
+
+  // GraphDataSource
+  double GetCurrentValue() const override;
+  std::unique_ptr<PointEnumerator> EnumPoints(
+      double from,
+      double to,
+      bool include_left_bound,
+      bool include_right_bound) override;
+  GraphRange GetHorizontalRange() const override;
+  GraphRange GetVerticalRange() const override;
+  // O(log n) plus the number of delta points before `value`.
+  std::optional<size_t> LowerBound(double value) const override;
+  std::optional<size_t> UpperBound(double value) const override;
+
+ private:
+  class MergingPointEnumerator;
+
+  // Transparent, so that the delta can be searched by x in O(log n).
+  struct LessX {
+    using is_transparent = void;
+
+    bool operator()(const GraphPoint& a, const GraphPoint& b) const {
+      return a.x < b.x;
+    }
+    bool operator()(const GraphPoint& a, double x) const { return a.x < x; }
+    bool operator()(double x, const GraphPoint& b) const { return x < b.x; }
+  };
+
+  using Delta = std::multiset<GraphPoint, LessX>;
+
+  // Returns true if the point was appended.
+  bool Insert(const GraphPoint& point);
+
+  const GraphPoint* GetLastPoint() const;
+
+  // Starts merging the delta on the worker thread.
+  void StartCompaction();
+  // Replaces the main store with the merged one.
+  void FinishCompaction();
+
+  // Returns the number of points before `value`, or up to `value` if
+  // `upper`.
+  size_t FindBound(double value, bool upper) const;
+
+  const GraphRange::Kind horizontal_kind_;
+
+  // Sorted main store, and the points appended to it while the worker merges
+  // it. The store and the frozen delta aren't modified while it runs.
+  std::vector<GraphPoint> points_;
+  std::vector<GraphPoint> tail_;
+  // Late points taken by the running compaction.
+  std::vector<GraphPoint> frozen_delta_;
+  // Late points. Points with equal x keep their insertion order.
+  Delta delta_;
+
+  std::thread compaction_thread_;
+  std::atomic<bool> compaction_done_ = false;
+  std::vector<GraphPoint> compacted_points_;
+
+  GraphRange vertical_range_;
+};
+
+}  // namespace views
@@ -0,0 +1,151 @@
+#include "graph_qt/model/merge_buffer_data_source.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace views {
+
+namespace {
+
+class CountingObserver : public GraphDataSource::Observer {
+ public:
+  void OnDataSourceHistoryChanged() override { ++history_changed_count; }
+  void OnDataSourcePointsAppended() override { ++points_appended_count; }
+
+  int history_changed_count = 0;
+  int points_appended_count = 0;
+};
+
+std::vector<GraphPoint> EnumAllPoints(GraphDataSource& data_source,
+                                      double from,
+                                      double to) {
+  std::vector<GraphPoint> points;
+  if (auto point_enum = data_source.EnumPoints(from, to, true, true)) {
+    ForEachPoint(*point_enum,
+                 [&](const GraphPoint& point) { points.push_back(point); });
+  }
+  return points;
+}
+
+}  // namespace
+
+TEST(MergeBufferDataSourceTest, EnumMergesLatePoints) {
+  MergeBufferDataSource data_source;
+  CountingObserver observer;
+  data_source.SetObserver(&observer);
+
+  data_source.AddPoints(std::vector<GraphPoint>{{0, 0}, {2, 2}, {4, 4}});
+  EXPECT_EQ(observer.points_appended_count, 1);
+
+  data_source.AddPoint({3, 3});
+  data_source.AddPoint({1, 1});
+  EXPECT_EQ(observer.history_changed_count, 2);
+  EXPECT_EQ(data_source.delta_size(), 2u);
+
+  data_source.AddPoint({5, 5});
+  EXPECT_EQ(observer.points_appended_count, 2);
+
+  EXPECT_EQ(EnumAllPoints(data_source, 0, 10),
+            (std::vector<GraphPoint>{
+                {0, 0}, {1, 1}, {2, 2}, {3, 3}, {4, 4}, {5, 5}}));
+  EXPECT_EQ(EnumAllPoints(data_source, 1, 3),
+            (std::vector<GraphPoint>{{1, 1}, {2, 2}, {3, 3}}));
+  EXPECT_EQ(data_source.EnumPoints(1, 3, false, false)->GetCount(), 1u);
+  EXPECT_EQ(data_source.GetCurrentValue(), 5);
+
+  data_source.Compact();
+  EXPECT_EQ(data_source.delta_size(), 0u);
+  EXPECT_EQ(EnumAllPoints(data_source, 1, 3),
+            (std::vector<GraphPoint>{{1, 1}, {2, 2}, {3, 3}}));
+
+  data_source.SetObserver(nullptr);
+}
+
+TEST(MergeBufferDataSourceTest, EnumEmptyRangeWithLatePoints) {
+  MergeBufferDataSource data_source;
+  data_source.AddPoints(std::vector<GraphPoint>{{0, 0}, {10, 10}});
+  data_source.AddPoint({5, 5});
+
+  EXPECT_EQ(data_source.EnumPoints(5, 5, false, false), nullptr);
+  EXPECT_EQ(data_source.EnumPoints(6, 4, true, true), nullptr);
+  EXPECT_EQ(EnumAllPoints(data_source, 5, 5),
+            (std::vector<GraphPoint>{{5, 5}}));
+}
+
+TEST(MergeBufferDataSourceTest, Ranges) {
+  MergeBufferDataSource data_source;
+  EXPECT_EQ(data_source.GetHorizontalRange(), GraphRange{});
+
+  data_source.AddPoint({10, 1});
+  data_source.AddPoint({5, -3});
+  EXPECT_EQ(data_source.GetHorizontalRange(), GraphRange(5, 10));
+  EXPECT_EQ(data_source.GetVerticalRange(), GraphRange(-3, 1));
+}
+
+TEST(MergeBufferDataSourceTest, CompactsLargeDelta) {
+  std::vector<GraphPoint> points;
+  for (int i = 0; i < 10000; ++i) {
+    points.emplace_back(i, i);
+  }
+  auto shuffled = points;
+  std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937{});
+
+  MergeBufferDataSource data_source;
+  for (size_t i = 0; i < shuffled.size(); ++i) {
+    data_source.AddPoint(shuffled[i]);
+    if (i % 1000 == 0) {
+      auto enumerated = EnumAllPoints(data_source, 0, 10000);
+      EXPECT_EQ(enumerated.size(), i + 1);
+      EXPECT_TRUE(std::ranges::is_sorted(enumerated, {}, &GraphPoint::x));
+    }
+  }
+
+  EXPECT_EQ(data_source.size(), points.size());
+  EXPECT_EQ(EnumAllPoints(data_source, 0, 10000), points);
+  data_source.Compact();
+  EXPECT_EQ(data_source.delta_size(), 0u);
+  EXPECT_EQ(EnumAllPoints(data_source, 0, 10000), points);
+}
+
+TEST(MergeBufferDataSourceTest, CompactsInBackground) {
+  MergeBufferDataSource data_source;
+  data_source.AddPoint({1e6, 0});
+  std::vector<GraphPoint> late_points;
+  for (size_t i = 0; i <= MergeBufferDataSource::kMaxDeltaSize; ++i) {
+    late_points.emplace_back(static_cast<double>(i), 1.0);
+  }
+  data_source.AddPoints(late_points);
+  EXPECT_TRUE(data_source.is_compacting());
+
+  // Points keep being added while the worker merges.
+  data_source.AddPoint({0.5, 2});
+  data_source.AddPoint({1e6, 3});
+  const size_t count = late_points.size() + 3;
+  EXPECT_EQ(data_source.size(), count);
+  EXPECT_EQ(data_source.LowerBound(1), 2u);
+  EXPECT_EQ(data_source.UpperBound(1), 3u);
+  EXPECT_EQ(data_source.CountPoints(0, 1e6, true, true), count);
+  auto points = EnumAllPoints(data_source, 0, 1e6);
+  ASSERT_EQ(points.size(), count);
+  EXPECT_TRUE(std::ranges::is_sorted(points, {}, &GraphPoint::x));
+  EXPECT_EQ(points[1], GraphPoint(0.5, 2));
+  // On equal x, the points come in the order they were added.
+  EXPECT_EQ(points[count - 2], GraphPoint(1e6, 0));
+  EXPECT_EQ(points[count - 1], GraphPoint(1e6, 3));
+
+  // The merged store replaces the main store once the worker is done.
+  for (int i = 0; data_source.is_compacting() && i < 1000; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    data_source.AddPoint({2e6 + i, 4});
+  }
+  EXPECT_FALSE(data_source.is_compacting());
+  EXPECT_EQ(data_source.delta_size(), 1u);
+  EXPECT_EQ(EnumAllPoints(data_source, 0, 1e6), points);
+}
+
+}  // namespace views
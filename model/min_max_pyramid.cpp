@@ -0,0 +1,140 @@
+#include "graph_qt/model/min_max_pyramid.h"
+
+#include <cassert>
+
+namespace views {
+
+void MinMaxPyramid::Update(std::span<const GraphPoint> points) {
+  assert(points.size() >= size_);
+
+  for (; size_ < points.size(); ++size_) {
+    auto extremes = MakeExtremes(points[size_], size_);
+    size_t unit = size_;
+    for (auto& level : levels_) {
+      size_t bucket = unit / kFanout;
+      if (bucket == level.size()) {
+        level.push_back(extremes);
+      } else {
+        level[bucket].Merge(extremes);
+      }
+      unit = bucket;
+    }
+
+    if (levels_.empty() || levels_.back().size() > 1) {
+      AddLevel(points);
+    }
+  }
+}
+
+void MinMaxPyramid::AddLevel(std::span<const GraphPoint> points) {
+  Level level;
+
+  auto add = [&level](size_t unit, const Extremes& extremes) {
+    size_t bucket = unit / kFanout;
+    if (bucket == level.size()) {
+      level.push_back(extremes);
+    } else {
+      level[bucket].Merge(extremes);
+    }
+  };
+
+  if (levels_.empty()) {
+    for (size_t i = 0; i <= size_; ++i) {
+      add(i, MakeExtremes(points[i], i));
+    }
+  } else {
+    const auto& below = levels_.back();
+    for (size_t i = 0; i < below.size(); ++i) {
+      add(i, below[i]);
+    }
+  }
+
+  levels_.push_back(std::move(level));
+}
+
+void MinMaxPyramid::Clear() {
+  size_ = 0;
+  levels_.clear();
+}
+
+const MinMaxPyramid::Extremes& MinMaxPyramid::GetTotal() const {
+  assert(size_ != 0);
+  return levels_.back().front();
+}
+
+MinMaxPyramid::Extremes MinMaxPyramid::Query(
+    std::span<const GraphPoint> points,
+    size_t first,
+    size_t last) const {
+  assert(first < last);
+  assert(last <= size_);
+
+  auto result = MakeExtremes(points[first], first);
+
+  // `first` and `last` are in units of the current level. Level -1 stands for
+  // the points themselves.
+  auto merge_units = [&](int level, size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i) {
+      result.Merge(level < 0 ? MakeExtremes(points[i], i) : levels_[level][i]);
+    }
+  };
+
+  for (int level = -1; first < last; ++level) {
+    size_t upper_first = (first + kFanout - 1) / kFanout;
+    size_t upper_last = last / kFanout;
+    if (level + 1 == static_cast<int>(levels_.size()) ||
+        upper_first >= upper_last) {
+      merge_units(level, first, last);
+      break;
+    }
+
+    merge_units(level, first, upper_first * kFanout);
+    merge_units(level, upper_last * kFanout, last);
+    first = upper_first;
+    last = upper_last;
+  }
+
+  return result;
+}
+
+size_t MinMaxPyramid::FindFirstDifferent(std::span<const GraphPoint> points,
+                                         size_t first,
+                                         size_t last,
+                                         const GraphPoint& sample) const {
+  assert(last <= size_);
+
+  const unsigned quality = GetQuality(sample);
+
+  for (size_t i = first; i < last;) {
+    // Skip the largest bucket of equal points starting at `i`.
+    size_t skip_size = 0;
+    size_t bucket_size = kFanout;
+    for (const auto& level : levels_) {
+      if (i % bucket_size != 0 || i + bucket_size > last) {
+        break;
+      }
+      const auto& bucket = level[i / bucket_size];
+      if (bucket.min != sample.y || bucket.max != sample.y ||
+          bucket.quality != quality) {
+        break;
+      }
+      skip_size = bucket_size;
+      bucket_size *= kFanout;
+    }
+
+    if (skip_size != 0) {
+      i += skip_size;
+      continue;
+    }
+
+    if (points[i].y != sample.y || GetQuality(points[i]) != quality) {
+      return i;
+    }
+
+    ++i;
+  }
+
+  return last;
+}
+
+}  // namespace views
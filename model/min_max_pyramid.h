@@ -0,0 +1,93 @@
+#pragma once
+
+#include "graph_qt/model/graph_types.h"
+
+#include <span>
+#include <vector>
+
+namespace views {
+
+// Hierarchical min/max summary over an append-only sequence of points. Level
+// `n` keeps the extremes of every `kFanout^(n+1)` consecutive points, so the
+// extremes of any index range are found in O(log n), and appending a point
+// updates O(log n) buckets.
+//
+// The pyramid doesn't own the points. The same sequence must be passed to all
+// calls.
+class MinMaxPyramid {
+ public:
+  static constexpr size_t kFanout = 8;
+
+  struct Extremes {
+    // On equal values keeps the lowest index.
+    void Merge(const Extremes& other) {
+      if (other.min < min ||
+          (other.min == min && other.min_index < min_index)) {
+        min = other.min;
+        min_index = other.min_index;
+      }
+      if (other.max > max ||
+          (other.max == max && other.max_index < max_index)) {
+        max = other.max;
+        max_index = other.max_index;
+      }
+      quality |= other.quality;
+    }
+
+    double min;
+    double max;
+    size_t min_index;
+    size_t max_index;
+    // Combination of `QualityFlags` of the points.
+    unsigned quality;
+  };
+
+  enum QualityFlags { HAS_GOOD = 0x1, HAS_BAD = 0x2 };
+
+  // Summarizes the points appended since the last call.
+  void Update(std::span<const GraphPoint> points);
+
+  void Clear();
+
+  // Number of points summarized.
+  size_t size() const { return size_; }
+
+  // Returns the extremes of all points in O(1). The pyramid must not be empty.
+  const Extremes& GetTotal() const;
+
+  // Returns the extremes of the points in `[first, last)`. The range must not
+  // be empty. On equal values the lowest index is reported.
+  Extremes Query(std::span<const GraphPoint> points,
+                 size_t first,
+                 size_t last) const;
+
+  // Returns the index of the first point in `[first, last)` having a value or
+  // quality different from `sample`, or `last` if there is none. Buckets of
+  // equal points are skipped, so the cost is O(log n) regardless of the
+  // distance.
+  size_t FindFirstDifferent(std::span<const GraphPoint> points,
+                            size_t first,
+                            size_t last,
+                            const GraphPoint& sample) const;
+
+ private:
+  using Level = std::vector<Extremes>;
+
+  static unsigned GetQuality(const GraphPoint& point) {
+    return point.good ? HAS_GOOD : HAS_BAD;
+  }
+
+  static Extremes MakeExtremes(const GraphPoint& point, size_t index) {
+    return {point.y, point.y, index, index, GetQuality(point)};
+  }
+
+  void AddLevel(std::span<const GraphPoint> points);
+
+  size_t size_ = 0;
+
+  // `levels_[n][i]` summarizes points `[i * kFanout^(n+1), (i + 1) *
+  // kFanout^(n+1))`. The top level has a single bucket.
+  std::vector<Level> levels_;
+};
+
+}  // namespace views
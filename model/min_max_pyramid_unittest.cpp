@@ -0,0 +1,127 @@
+#include "graph_qt/model/min_max_pyramid.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace views {
+
+namespace {
+
+std::vector<GraphPoint> MakeRandomPoints(size_t count) {
+  std::mt19937 generator{42};
+  std::uniform_int_distribution<int> distribution{-1000, 1000};
+
+  std::vector<GraphPoint> points;
+  for (size_t i = 0; i < count; ++i) {
+    points.emplace_back(static_cast<double>(i), distribution(generator));
+  }
+  return points;
+}
+
+// Returns points holding each value for a random number of samples.
+std::vector<GraphPoint> MakeSteppedPoints(size_t count) {
+  std::mt19937 generator{42};
+  std::uniform_int_distribution<int> value_distribution{-3, 3};
+  std::uniform_int_distribution<size_t> length_distribution{1, 200};
+
+  std::vector<GraphPoint> points;
+  while (points.size() < count) {
+    double value = value_distribution(generator);
+    size_t length = std::min(length_distribution(generator),
+                             count - points.size());
+    for (size_t i = 0; i < length; ++i) {
+      points.emplace_back(static_cast<double>(points.size()), value);
+    }
+  }
+  return points;
+}
+
+MinMaxPyramid::Extremes BruteForce(const std::vector<GraphPoint>& points,
+                                   size_t first,
+                                   size_t last) {
+  MinMaxPyramid::Extremes result{points[first].y, points[first].y, first,
+                                 first};
+  for (size_t i = first + 1; i < last; ++i) {
+    result.Merge({points[i].y, points[i].y, i, i});
+  }
+  return result;
+}
+
+void ExpectEq(const MinMaxPyramid::Extremes& actual,
+              const MinMaxPyramid::Extremes& expected) {
+  EXPECT_EQ(actual.min, expected.min);
+  EXPECT_EQ(actual.max, expected.max);
+  EXPECT_EQ(actual.min_index, expected.min_index);
+  EXPECT_EQ(actual.max_index, expected.max_index);
+}
+
+}  // namespace
+
+TEST(MinMaxPyramidTest, QueryMatchesBruteForce) {
+  auto points = MakeRandomPoints(3000);
+
+  MinMaxPyramid pyramid;
+  pyramid.Update(points);
+  ASSERT_EQ(pyramid.size(), points.size());
+
+  std::mt19937 generator{7};
+  std::uniform_int_distribution<size_t> distribution{0, points.size()};
+  for (int i = 0; i < 1000; ++i) {
+    size_t first = distribution(generator);
+    size_t last = distribution(generator);
+    if (first > last) {
+      std::swap(first, last);
+    }
+    if (first == last) {
+      continue;
+    }
+    ExpectEq(pyramid.Query(points, first, last),
+             BruteForce(points, first, last));
+  }
+
+  ExpectEq(pyramid.GetTotal(), BruteForce(points, 0, points.size()));
+}
+
+TEST(MinMaxPyramidTest, IncrementalUpdate) {
+  auto all_points = MakeRandomPoints(1000);
+
+  std::vector<GraphPoint> points;
+  MinMaxPyramid pyramid;
+  for (const auto& point : all_points) {
+    points.push_back(point);
+    pyramid.Update(points);
+
+    ExpectEq(pyramid.GetTotal(), BruteForce(points, 0, points.size()));
+    ExpectEq(pyramid.Query(points, points.size() / 3, points.size()),
+             BruteForce(points, points.size() / 3, points.size()));
+  }
+}
+
+TEST(MinMaxPyramidTest, FindFirstDifferentMatchesBruteForce) {
+  auto points = MakeSteppedPoints(5000);
+  // Same values of different quality are different.
+  for (size_t i = 1000; i < 1100; ++i) {
+    points[i].good = true;
+  }
+
+  MinMaxPyramid pyramid;
+  pyramid.Update(points);
+
+  for (size_t first = 0; first < points.size(); first += 7) {
+    const auto& sample = points[first];
+    auto expected = std::find_if(
+        points.begin() + first, points.end(), [&](const GraphPoint& point) {
+          return point.y != sample.y || point.good != sample.good;
+        });
+    EXPECT_EQ(pyramid.FindFirstDifferent(points, first, points.size(), sample),
+              static_cast<size_t>(expected - points.begin()))
+        << first;
+  }
+
+  EXPECT_EQ(pyramid.FindFirstDifferent(points, 10, 10, points[0]), 10u);
+}
+
+}  // namespace views
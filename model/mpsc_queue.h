@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+namespace views {
+
+// Bounded lock-free queue written by any number of threads and read by a
+// single thread. Every cell carries a sequence number telling whether it's
+// free for the producer of a position or filled for the consumer, so
+// producers only contend on one atomic increment and never block each other.
+// A single producer is served the same way.
+template <class T>
+class MpscQueue {
+ public:
+  // The capacity is rounded up to a power of two.
+  explicit MpscQueue(size_t capacity)
+      : capacity_{std::bit_ceil(capacity)},
+        cells_{std::make_unique<Cell[]>(capacity_)} {
+    assert(capacity > 0);
+    for (size_t i = 0; i < capacity_; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+
+  size_t capacity() const { return capacity_; }
+
+  // Thread-safe. Returns false if the queue is full.
+  bool TryPush(const T& value) {
+    size_t position = enqueue_position_.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell& cell = cells_[position & (capacity_ - 1)];
+      size_t sequence = cell.sequence.load(std::memory_order_acquire);
+      auto difference = static_cast<std::intptr_t>(sequence) -
+                        static_cast<std::intptr_t>(position);
+      if (difference == 0) {
+        if (enqueue_position_.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed)) {
+          cell.value = value;
+          cell.sequence.store(position + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (difference < 0) {
+        // The consumer hasn't freed the cell yet.
+        return false;
+      } else {
+        position = enqueue_position_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Must be called from the consumer thread only. Returns false if the queue
+  // is empty.
+  bool TryPop(T& value) {
+    Cell& cell = cells_[dequeue_position_ & (capacity_ - 1)];
+    size_t sequence = cell.sequence.load(std::memory_order_acquire);
+    if (sequence != dequeue_position_ + 1) {
+      return false;
+    }
+
+    value = cell.value;
+    cell.sequence.store(dequeue_position_ + capacity_,
+                        std::memory_order_release);
+    ++dequeue_position_;
+    return true;
+  }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  // Keeps the producer and the consumer positions on separate cache lines.
+  static constexpr size_t kCacheLineSize = 64;
+
+  const size_t capacity_;
+  const std::unique_ptr<Cell[]> cells_;
+
+  alignas(kCacheLineSize) std::atomic<size_t> enqueue_position_ = 0;
+  alignas(kCacheLineSize) size_t dequeue_position_ = 0;
+};
+
+}  // namespace views
@@ -0,0 +1,218 @@
+#include "graph_qt/model/point_codec.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+namespace views {
+
+namespace {
+
+// Delta-of-delta buckets: a prefix of `prefix_bits - 1` ones terminated by a
+// zero, followed by the value in `value_bits`. Values fitting no bucket follow
+// a prefix of `kLastDeltaPrefixBits` ones, and a zero delta-of-delta is a
+// single zero.
+struct DeltaBucket {
+  int prefix_bits;
+  int value_bits;
+};
+
+constexpr DeltaBucket kDeltaBuckets[] = {{2, 7}, {3, 9}, {4, 12}};
+constexpr int kLastDeltaPrefixBits = 4;
+
+bool FitsBits(int64_t value, int bit_count) {
+  const int64_t limit = int64_t{1} << (bit_count - 1);
+  return value >= -limit && value < limit;
+}
+
+uint64_t MaskBits(int bit_count) {
+  return bit_count == 64 ? ~uint64_t{0} : (uint64_t{1} << bit_count) - 1;
+}
+
+int64_t SignExtend(uint64_t value, int bit_count) {
+  const int shift = 64 - bit_count;
+  return static_cast<int64_t>(value << shift) >> shift;
+}
+
+}  // namespace
+
+// PointEncoder
+
+void PointEncoder::Append(const GraphPoint& point) {
+  const auto x_bits = std::bit_cast<int64_t>(point.x);
+  const auto y_bits = std::bit_cast<uint64_t>(point.y);
+
+  WriteBits(point.good ? 1 : 0, 1);
+
+  if (count_++ == 0) {
+    WriteBits(static_cast<uint64_t>(x_bits), 64);
+    WriteBits(y_bits, 64);
+    prev_x_bits_ = x_bits;
+    prev_y_bits_ = y_bits;
+    return;
+  }
+
+  // Wrapping arithmetic keeps the encoding lossless for any bit patterns.
+  const auto x_delta = static_cast<int64_t>(
+      static_cast<uint64_t>(x_bits) - static_cast<uint64_t>(prev_x_bits_));
+  const auto x_delta_of_delta = static_cast<int64_t>(
+      static_cast<uint64_t>(x_delta) - static_cast<uint64_t>(prev_x_delta_));
+  prev_x_bits_ = x_bits;
+  prev_x_delta_ = x_delta;
+
+  if (x_delta_of_delta == 0) {
+    WriteBits(0, 1);
+  } else {
+    bool written = false;
+    for (const auto& bucket : kDeltaBuckets) {
+      if (FitsBits(x_delta_of_delta, bucket.value_bits)) {
+        WriteBits(MaskBits(bucket.prefix_bits) - 1, bucket.prefix_bits);
+        WriteBits(static_cast<uint64_t>(x_delta_of_delta) &
+                      MaskBits(bucket.value_bits),
+                  bucket.value_bits);
+        written = true;
+        break;
+      }
+    }
+    if (!written) {
+      WriteBits(MaskBits(kLastDeltaPrefixBits), kLastDeltaPrefixBits);
+      WriteBits(static_cast<uint64_t>(x_delta_of_delta), 64);
+    }
+  }
+
+  const uint64_t y_xor = y_bits ^ prev_y_bits_;
+  prev_y_bits_ = y_bits;
+
+  if (y_xor == 0) {
+    WriteBits(0, 1);
+    return;
+  }
+
+  // The leading zero count is stored in 5 bits.
+  const int leading_zeros = std::min(std::countl_zero(y_xor), 31);
+  const int trailing_zeros = std::countr_zero(y_xor);
+
+  if (prev_leading_zeros_ >= 0 && leading_zeros >= prev_leading_zeros_ &&
+      trailing_zeros >= prev_trailing_zeros_) {
+    // The meaningful bits fit the window of the previous value.
+    const int bit_count = 64 - prev_leading_zeros_ - prev_trailing_zeros_;
+    WriteBits(0b10, 2);
+    WriteBits(y_xor >> prev_trailing_zeros_, bit_count);
+    return;
+  }
+
+  // A meaningful bit count of 64 is stored as zero.
+  const int bit_count = 64 - leading_zeros - trailing_zeros;
+  WriteBits(0b11, 2);
+  WriteBits(static_cast<uint64_t>(leading_zeros), 5);
+  WriteBits(static_cast<uint64_t>(bit_count & 63), 6);
+  WriteBits(y_xor >> trailing_zeros, bit_count);
+  prev_leading_zeros_ = leading_zeros;
+  prev_trailing_zeros_ = trailing_zeros;
+}
+
+std::vector<uint64_t> PointEncoder::Finish() {
+  words_.shrink_to_fit();
+  return std::move(words_);
+}
+
+void PointEncoder::WriteBits(uint64_t value, int bit_count) {
+  assert(bit_count > 0 && bit_count <= 64);
+  assert((value & ~MaskBits(bit_count)) == 0);
+
+  if (bit_offset_ == 64) {
+    words_.push_back(0);
+    bit_offset_ = 0;
+  }
+
+  // Bits are stored from the most significant bit of each word.
+  const int free_bits = 64 - bit_offset_;
+  if (bit_count <= free_bits) {
+    words_.back() |= value << (free_bits - bit_count);
+    bit_offset_ += bit_count;
+    return;
+  }
+
+  const int rest_bits = bit_count - free_bits;
+  words_.back() |= value >> rest_bits;
+  words_.push_back(value << (64 - rest_bits));
+  bit_offset_ = rest_bits;
+}
+
+// PointDecoder
+
+bool PointDecoder::Next(GraphPoint& point) {
+  if (remaining_count_ == 0) {
+    return false;
+  }
+  --remaining_count_;
+
+  point.good = ReadBits(1) != 0;
+
+  if (first_) {
+    first_ = false;
+    prev_x_bits_ = static_cast<int64_t>(ReadBits(64));
+    prev_y_bits_ = ReadBits(64);
+    point.x = std::bit_cast<double>(prev_x_bits_);
+    point.y = std::bit_cast<double>(prev_y_bits_);
+    return true;
+  }
+
+  int64_t x_delta_of_delta = 0;
+  if (ReadBits(1) != 0) {
+    // Every bucket adds a one to the prefix.
+    bool decoded = false;
+    for (const auto& bucket : kDeltaBuckets) {
+      if (ReadBits(1) == 0) {
+        x_delta_of_delta =
+            SignExtend(ReadBits(bucket.value_bits), bucket.value_bits);
+        decoded = true;
+        break;
+      }
+    }
+    if (!decoded) {
+      x_delta_of_delta = static_cast<int64_t>(ReadBits(64));
+    }
+  }
+
+  prev_x_delta_ = static_cast<int64_t>(static_cast<uint64_t>(prev_x_delta_) +
+                                       static_cast<uint64_t>(x_delta_of_delta));
+  prev_x_bits_ = static_cast<int64_t>(static_cast<uint64_t>(prev_x_bits_) +
+                                      static_cast<uint64_t>(prev_x_delta_));
+  point.x = std::bit_cast<double>(prev_x_bits_);
+
+  if (ReadBits(1) != 0) {
+    if (ReadBits(1) != 0) {
+      prev_leading_zeros_ = static_cast<int>(ReadBits(5));
+      int bit_count = static_cast<int>(ReadBits(6));
+      if (bit_count == 0) {
+        bit_count = 64;
+      }
+      prev_trailing_zeros_ = 64 - prev_leading_zeros_ - bit_count;
+    }
+    const int bit_count = 64 - prev_leading_zeros_ - prev_trailing_zeros_;
+    prev_y_bits_ ^= ReadBits(bit_count) << prev_trailing_zeros_;
+  }
+  point.y = std::bit_cast<double>(prev_y_bits_);
+  return true;
+}
+
+uint64_t PointDecoder::ReadBits(int bit_count) {
+  assert(bit_count > 0 && bit_count <= 64);
+
+  const size_t word_index = bit_position_ / 64;
+  const int offset = static_cast<int>(bit_position_ % 64);
+  bit_position_ += bit_count;
+
+  const int free_bits = 64 - offset;
+  const uint64_t word = words_[word_index] << offset;
+  if (bit_count <= free_bits) {
+    return word >> (64 - bit_count);
+  }
+
+  const int rest_bits = bit_count - free_bits;
+  return (word >> (64 - bit_count)) |
+         (words_[word_index + 1] >> (64 - rest_bits));
+}
+
+}  // namespace views
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "graph_qt/model/graph_types.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace views {
+
+// Lossless streaming compression of sorted points in the style of Gorilla
+// (Facebook's in-memory TSDB). The x of each point is stored as the
+// delta-of-delta of its bit pattern, which is zero for regularly sampled
+// points, and y as the XOR with the previous y, of which only the meaningful
+// bits are stored. The quality takes one bit. Regular samples of a slowly
+// changing value take a few bits per point instead of 17 bytes.
+class PointEncoder {
+ public:
+  size_t count() const { return count_; }
+
+  void Append(const GraphPoint& point);
+
+  // Returns the encoded stream, to be decoded by `PointDecoder` with `count()`
+  // points.
+  std::vector<uint64_t> Finish();
+
+ private:
+  void WriteBits(uint64_t value, int bit_count);
+
+  std::vector<uint64_t> words_;
+  int bit_offset_ = 64;
+
+  size_t count_ = 0;
+  int64_t prev_x_bits_ = 0;
+  int64_t prev_x_delta_ = 0;
+  uint64_t prev_y_bits_ = 0;
+  int prev_leading_zeros_ = -1;
+  int prev_trailing_zeros_ = 0;
+};
+
+class PointDecoder {
+ public:
+  PointDecoder(std::span<const uint64_t> words, size_t count)
+      : words_{words}, remaining_count_{count} {}
+
+  size_t remaining_count() const { return remaining_count_; }
+
+  bool Next(GraphPoint& point);
+
+ private:
+  uint64_t ReadBits(int bit_count);
+
+  std::span<const uint64_t> words_;
+  size_t bit_position_ = 0;
+
+  size_t remaining_count_;
+  bool first_ = true;
+  int64_t prev_x_bits_ = 0;
+  int64_t prev_x_delta_ = 0;
+  uint64_t prev_y_bits_ = 0;
+  int prev_leading_zeros_ = 0;
+  int prev_trailing_zeros_ = 0;
+};
+
+}  // namespace views
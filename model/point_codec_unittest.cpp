@@ -0,0 +1,69 @@
+#include "graph_qt/model/point_codec.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace views {
+
+namespace {
+
+std::vector<GraphPoint> EncodeAndDecode(const std::vector<GraphPoint>& points,
+                                        size_t* word_count = nullptr) {
+  PointEncoder encoder;
+  for (const auto& point : points) {
+    encoder.Append(point);
+  }
+  EXPECT_EQ(encoder.count(), points.size());
+  auto words = encoder.Finish();
+  if (word_count) {
+    *word_count = words.size();
+  }
+
+  PointDecoder decoder{words, points.size()};
+  std::vector<GraphPoint> decoded;
+  GraphPoint point;
+  while (decoder.Next(point)) {
+    decoded.push_back(point);
+  }
+  return decoded;
+}
+
+}  // namespace
+
+TEST(PointCodecTest, RegularSamples) {
+  std::vector<GraphPoint> points;
+  for (int i = 0; i < 1000; ++i) {
+    GraphPoint point{1.7e9 + i, i < 500 ? 20.0 : 20.5};
+    point.good = i != 700;
+    points.push_back(point);
+  }
+
+  size_t word_count = 0;
+  EXPECT_EQ(EncodeAndDecode(points, &word_count), points);
+  // A few bits per point.
+  EXPECT_LT(word_count * 64, points.size() * 4);
+}
+
+TEST(PointCodecTest, IrregularSamples) {
+  std::mt19937 generator;
+  std::uniform_real_distribution<double> step{0, 10};
+  std::normal_distribution<double> value;
+
+  std::vector<GraphPoint> points;
+  double x = -1000;
+  for (int i = 0; i < 1000; ++i) {
+    x += i % 100 == 0 ? 0 : step(generator);
+    points.emplace_back(x, value(generator));
+  }
+  points.emplace_back(x, std::numeric_limits<double>::infinity());
+  points.emplace_back(1e300, -0.0);
+  points.emplace_back(1e300, std::numeric_limits<double>::lowest());
+
+  EXPECT_EQ(EncodeAndDecode(points), points);
+}
+
+}  // namespace views
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "graph_qt/model/graph_types.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace views {
+
+// Read-only view of a run of points stored by columns of `X` and `Y` values.
+// The quality flags are packed in a bitmap, where the flag of the first point
+// is bit `quality_offset` of `quality`.
+template <class X, class Y>
+struct BasicPointColumnSpans {
+  size_t size() const { return x.size(); }
+
+  bool good(size_t index) const {
+    size_t bit = quality_offset + index;
+    return (quality[bit / 64] >> (bit % 64)) & 1;
+  }
+
+  // Converts the point to the `GraphValue` representation.
+  GraphPoint at(size_t index) const {
+    GraphPoint point{GraphValueTraits<X>::ToGraphValue(x[index]),
+                     GraphValueTraits<Y>::ToGraphValue(y[index])};
+    point.good = good(index);
+    return point;
+  }
+
+  BasicPointColumnSpans subspan(size_t first, size_t count) const {
+    return {x.subspan(first, count), y.subspan(first, count), quality,
+            quality_offset + first};
+  }
+
+  std::span<const X> x;
+  std::span<const Y> y;
+  std::span<const uint64_t> quality;
+  size_t quality_offset = 0;
+};
+
+using PointColumnSpans = BasicPointColumnSpans<GraphValue, GraphValue>;
+
+// Growable struct-of-arrays point storage: contiguous x and y arrays and a
+// quality bitmap. Scans reading one column touch only its bytes, and the
+// arrays are laid out for vectorized loops. The value types can be narrower
+// than `GraphValue`, e.g. `GraphNanoseconds` and `float`.
+template <class X, class Y>
+class BasicPointColumns {
+ public:
+  using Spans = BasicPointColumnSpans<X, Y>;
+
+  size_t size() const { return x_.size(); }
+  bool empty() const { return x_.empty(); }
+
+  std::span<const X> x() const { return x_; }
+  std::span<const Y> y() const { return y_; }
+
+  GraphPoint at(size_t index) const { return GetSpans().at(index); }
+
+  Spans GetSpans() const { return {x_, y_, quality_, 0}; }
+
+  void reserve(size_t size) {
+    x_.reserve(size);
+    y_.reserve(size);
+    quality_.reserve((size + 63) / 64);
+  }
+
+  void push_back(X x, Y y, bool good) {
+    size_t bit = x_.size();
+    if (bit % 64 == 0) {
+      quality_.push_back(0);
+    }
+    quality_.back() |= uint64_t{good} << (bit % 64);
+    x_.push_back(x);
+    y_.push_back(y);
+  }
+
+  void clear() {
+    x_.clear();
+    y_.clear();
+    quality_.clear();
+  }
+
+ private:
+  std::vector<X> x_;
+  std::vector<Y> y_;
+  std::vector<uint64_t> quality_;
+};
+
+using PointColumns = BasicPointColumns<GraphValue, GraphValue>;
+
+}  // namespace views
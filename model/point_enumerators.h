@@ -0,0 +1,219 @@
+#pragma once
+
+#include "graph_qt/model/graph_data_source.h"
+#include "graph_qt/model/graph_types.h"
+#include "graph_qt/model/point_columns.h"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace views {
+
+// Enumerates points of a contiguous array owned by the data source. The array
+// must not be modified while the enumerator is alive.
+class SpanPointEnumerator : public PointEnumerator {
+ public:
+  explicit SpanPointEnumerator(std::span<const GraphPoint> points)
+      : points_{points} {}
+
+  size_t GetCount() const override { return points_.size(); }
+
+  bool EnumNext(GraphPoint& value) override {
+    if (points_.empty()) {
+      return false;
+    }
+
+    value = points_.front();
+    points_ = points_.subspan(1);
+    return true;
+  }
+
+  size_t EnumNextBatch(std::span<GraphPoint> points) override {
+    size_t count = std::min(points.size(), points_.size());
+    std::copy_n(points_.begin(), count, points.begin());
+    points_ = points_.subspan(count);
+    return count;
+  }
+
+ private:
+  std::span<const GraphPoint> points_;
+};
+
+// Enumerates two contiguous arrays one after another, e.g. the parts of a ring
+// buffer before and after the wrap point. The arrays must not be modified
+// while the enumerator is alive.
+class RingPointEnumerator : public PointEnumerator {
+ public:
+  RingPointEnumerator(std::span<const GraphPoint> head,
+                      std::span<const GraphPoint> tail)
+      : head_{head}, tail_{tail} {}
+
+  size_t GetCount() const override { return head_.size() + tail_.size(); }
+
+  bool EnumNext(GraphPoint& value) override {
+    if (head_.empty()) {
+      std::swap(head_, tail_);
+      if (head_.empty()) {
+        return false;
+      }
+    }
+
+    value = head_.front();
+    head_ = head_.subspan(1);
+    return true;
+  }
+
+  size_t EnumNextBatch(std::span<GraphPoint> points) override {
+    if (head_.empty()) {
+      std::swap(head_, tail_);
+    }
+    size_t count = std::min(points.size(), head_.size());
+    std::copy_n(head_.begin(), count, points.begin());
+    head_ = head_.subspan(count);
+    return count;
+  }
+
+ private:
+  std::span<const GraphPoint> head_;
+  std::span<const GraphPoint> tail_;
+};
+
+// Enumerates points stored by columns. Columns of `GraphValue` are given
+// without copying through `EnumNextColumns()`; columns of other value types
+// are converted to `GraphValue` in batches of `kPointBatchSize` points. The
+// columns must not be modified while the enumerator is alive.
+template <class X, class Y>
+class BasicColumnPointEnumerator : public PointEnumerator {
+ public:
+  using Spans = BasicPointColumnSpans<X, Y>;
+
+  explicit BasicColumnPointEnumerator(const Spans& columns)
+      : columns_{columns} {}
+
+  size_t GetCount() const override { return columns_.size(); }
+
+  bool EnumNext(GraphPoint& value) override {
+    return EnumNextBatch(std::span{&value, 1}) == 1;
+  }
+
+  size_t EnumNextBatch(std::span<GraphPoint> points) override {
+    size_t count = std::min(points.size(), columns_.size());
+    for (size_t i = 0; i < count; ++i) {
+      points[i] = columns_.at(i);
+    }
+    columns_ = columns_.subspan(count, columns_.size() - count);
+    return count;
+  }
+
+  bool SupportsColumns() const override { return true; }
+
+  bool EnumNextColumns(PointColumnSpans& columns) override {
+    if (columns_.size() == 0) {
+      return false;
+    }
+    size_t count = std::is_same_v<Spans, PointColumnSpans>
+                       ? columns_.size()
+                       : std::min(columns_.size(), kPointBatchSize);
+    auto run = columns_.subspan(0, count);
+    columns_ = columns_.subspan(count, columns_.size() - count);
+    columns = {Convert(run.x, x_), Convert(run.y, y_), run.quality,
+               run.quality_offset};
+    return true;
+  }
+
+ private:
+  // Conversion buffer of a column, empty for columns given without copying.
+  template <class T>
+  using Buffer = std::conditional_t<std::is_same_v<T, GraphValue>,
+                                    std::array<GraphValue, 0>,
+                                    std::array<GraphValue, kPointBatchSize>>;
+
+  template <class T>
+  static std::span<const GraphValue> Convert(std::span<const T> values,
+                                             Buffer<T>& buffer) {
+    if constexpr (std::is_same_v<T, GraphValue>) {
+      return values;
+    } else {
+      for (size_t i = 0; i < values.size(); ++i) {
+        buffer[i] = GraphValueTraits<T>::ToGraphValue(values[i]);
+      }
+      return std::span{buffer}.first(values.size());
+    }
+  }
+
+  Spans columns_;
+  Buffer<X> x_;
+  Buffer<Y> y_;
+};
+
+using ColumnPointEnumerator =
+    BasicColumnPointEnumerator<GraphValue, GraphValue>;
+
+// Enumerates points the enumerator owns, e.g. ones computed for a request.
+class VectorPointEnumerator : public PointEnumerator {
+ public:
+  explicit VectorPointEnumerator(std::vector<GraphPoint> points)
+      : points_{std::move(points)} {}
+
+  size_t GetCount() const override { return points_.size() - index_; }
+
+  bool EnumNext(GraphPoint& value) override {
+    if (index_ >= points_.size()) {
+      return false;
+    }
+
+    value = points_[index_++];
+    return true;
+  }
+
+  size_t EnumNextBatch(std::span<GraphPoint> points) override {
+    size_t count = std::min(points.size(), points_.size() - index_);
+    std::copy_n(points_.begin() + index_, count, points.begin());
+    index_ += count;
+    return count;
+  }
+
+ private:
+  const std::vector<GraphPoint> points_;
+  size_t index_ = 0;
+};
+
+// Enumerates the points of several enumerators one after another, e.g. raw
+// points at the ends of a range and summarized points between them.
+class ConcatPointEnumerator : public PointEnumerator {
+ public:
+  explicit ConcatPointEnumerator(
+      std::vector<std::unique_ptr<PointEnumerator>> sources)
+      : sources_{std::move(sources)} {}
+
+  size_t GetCount() const override {
+    size_t count = 0;
+    for (size_t i = index_; i < sources_.size(); ++i) {
+      count += sources_[i]->GetCount();
+    }
+    return count;
+  }
+
+  bool EnumNext(GraphPoint& value) override {
+    return EnumNextBatch(std::span{&value, 1}) == 1;
+  }
+
+  size_t EnumNextBatch(std::span<GraphPoint> points) override {
+    for (; index_ < sources_.size(); ++index_) {
+      if (size_t count = sources_[index_]->EnumNextBatch(points)) {
+        return count;
+      }
+    }
+    return 0;
+  }
+
+ private:
+  const std::vector<std::unique_ptr<PointEnumerator>> sources_;
+  size_t index_ = 0;
+};
+
+}  // namespace views
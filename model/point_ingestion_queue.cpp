@@ -0,0 +1,42 @@
+#include "graph_qt/model/point_ingestion_queue.h"
+
+namespace views {
+
+PointIngestionQueue::PointIngestionQueue(size_t capacity, Sink sink, Wake wake)
+    : queue_{capacity}, sink_{std::move(sink)}, wake_{std::move(wake)} {
+  batch_.reserve(queue_.capacity());
+}
+
+PointIngestionQueue::~PointIngestionQueue() = default;
+
+bool PointIngestionQueue::Push(const GraphPoint& point) {
+  if (!queue_.TryPush(point)) {
+    dropped_count_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  if (!drain_pending_.exchange(true, std::memory_order_acq_rel) && wake_) {
+    wake_();
+  }
+  return true;
+}
+
+size_t PointIngestionQueue::Drain() {
+  // Points pushed after this wake the consumer again. Acquiring the flag
+  // makes the points pushed before it visible.
+  drain_pending_.exchange(false, std::memory_order_acq_rel);
+
+  // Bounded by the capacity, so continuous pushes can't stall the consumer.
+  batch_.clear();
+  GraphPoint point;
+  while (batch_.size() < batch_.capacity() && queue_.TryPop(point)) {
+    batch_.push_back(point);
+  }
+
+  if (!batch_.empty()) {
+    sink_(batch_);
+  }
+  return batch_.size();
+}
+
+}  // namespace views
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "graph_qt/model/graph_types.h"
+#include "graph_qt/model/mpsc_queue.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace views {
+
+// Collects points pushed from any thread and hands them to a sink in batches
+// on the consumer thread, usually a data source appending them with a single
+// notification. Producers never block: when the queue is full the point is
+// dropped and counted.
+//
+// `wake` is called on a producer thread when a point arrives at an idle
+// queue, so the consumer can schedule a `Drain()`. It isn't called again
+// until the drain starts.
+class PointIngestionQueue {
+ public:
+  using Sink = std::function<void(std::span<const GraphPoint> points)>;
+  using Wake = std::function<void()>;
+
+  PointIngestionQueue(size_t capacity, Sink sink, Wake wake = {});
+  ~PointIngestionQueue();
+
+  // Thread-safe. Returns false if the queue is full and the point is dropped.
+  bool Push(const GraphPoint& point);
+
+  // Must be called from the consumer thread only. Passes the queued points to
+  // the sink in one batch and returns their count. Doesn't allocate.
+  size_t Drain();
+
+  // Number of points dropped because the queue was full.
+  uint64_t dropped_count() const {
+    return dropped_count_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  MpscQueue<GraphPoint> queue_;
+  const Sink sink_;
+  const Wake wake_;
+
+  std::vector<GraphPoint> batch_;
+
+  std::atomic<bool> drain_pending_ = false;
+  std::atomic<uint64_t> dropped_count_ = 0;
+};
+
+}  // namespace views
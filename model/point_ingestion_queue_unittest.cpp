@@ -0,0 +1,81 @@
+#include "graph_qt/model/point_ingestion_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+namespace views {
+
+TEST(MpscQueueTest, ConcurrentProducers) {
+  const int kProducerCount = 4;
+  const int kPointCount = 100000;
+
+  MpscQueue<GraphPoint> queue{1024};
+
+  std::vector<std::thread> producers;
+  for (int producer = 0; producer < kProducerCount; ++producer) {
+    producers.emplace_back([&queue, producer] {
+      for (int i = 0; i < kPointCount; ++i) {
+        while (!queue.TryPush({static_cast<double>(producer),
+                               static_cast<double>(i)})) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  // Points of every producer arrive in order.
+  std::vector<int> next_values(kProducerCount);
+  int count = 0;
+  GraphPoint point;
+  while (count < kProducerCount * kPointCount) {
+    if (!queue.TryPop(point)) {
+      std::this_thread::yield();
+      continue;
+    }
+    auto& next_value = next_values[static_cast<int>(point.x)];
+    ASSERT_EQ(point.y, next_value);
+    ++next_value;
+    ++count;
+  }
+
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  EXPECT_FALSE(queue.TryPop(point));
+}
+
+TEST(PointIngestionQueueTest, DrainsInBatches) {
+  std::vector<std::vector<GraphPoint>> batches;
+  int wake_count = 0;
+  PointIngestionQueue queue{
+      8,
+      [&](std::span<const GraphPoint> points) {
+        batches.emplace_back(points.begin(), points.end());
+      },
+      [&] { ++wake_count; }};
+
+  EXPECT_EQ(queue.Drain(), 0u);
+  EXPECT_TRUE(batches.empty());
+
+  for (int i = 0; i < 10; ++i) {
+    queue.Push({static_cast<double>(i), 0});
+  }
+
+  // Only the first point woke the consumer, and the overflow was dropped.
+  EXPECT_EQ(wake_count, 1);
+  EXPECT_EQ(queue.dropped_count(), 2u);
+
+  EXPECT_EQ(queue.Drain(), 8u);
+  ASSERT_EQ(batches.size(), 1u);
+  EXPECT_EQ(batches[0].size(), 8u);
+  EXPECT_EQ(batches[0].back().x, 7);
+
+  queue.Push({10, 0});
+  EXPECT_EQ(wake_count, 2);
+  EXPECT_EQ(queue.Drain(), 1u);
+  EXPECT_EQ(batches.size(), 2u);
+}
+
+}  // namespace views
@@ -0,0 +1,307 @@
+#include "graph_qt/model/pyramid_data_source.h"
+
+#include "graph_qt/model/point_enumerators.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace views {
+
+namespace {
+
+// Below this amount of points per pixel column the raw points are served.
+const size_t kMinPointsPerColumnToReduce = 4;
+
+}  // namespace
+
+PyramidDataSource::PyramidDataSource(GraphRange::Kind horizontal_kind)
+    : horizontal_kind_{horizontal_kind} {}
+
+PyramidDataSource::~PyramidDataSource() = default;
+
+void PyramidDataSource::AddPoint(const GraphPoint& point) {
+  AddPoints(std::span{&point, 1});
+}
+
+void PyramidDataSource::AddPoints(std::span<const GraphPoint> points) {
+  if (points.empty()) {
+    return;
+  }
+
+  assert(points_.empty() || points.front().x >= points_.back().x);
+
+  points_.insert(points_.end(), points.begin(), points.end());
+  pyramid_.Update(points_);
+  aggregate_index_.Update(points_);
+  quantile_summary_.Update(points_);
+
+  NotifyPointsAdded();
+}
+
+void PyramidDataSource::Clear() {
+  points_.clear();
+  pyramid_.Clear();
+  aggregate_index_.Clear();
+  quantile_summary_.Clear();
+
+  if (observer_) {
+    observer_->OnDataSourceCurrentValueChanged();
+    observer_->OnDataSourceHistoryChanged();
+  }
+}
+
+void PyramidDataSource::NotifyPointsAdded() {
+  if (observer_) {
+    observer_->OnDataSourceCurrentValueChanged();
+    observer_->OnDataSourcePointsAppended();
+  }
+}
+
+double PyramidDataSource::GetCurrentValue() const {
+  return points_.empty() ? kGraphUnknownValue : points_.back().y;
+}
+
+std::unique_ptr<PointEnumerator> PyramidDataSource::EnumPoints(
+    double from,
+    double to,
+    bool include_left_bound,
+    bool include_right_bound) {
+  size_t first =
+      include_left_bound ? FindLowerBound(from) : FindUpperBound(from);
+  size_t last = include_right_bound ? FindUpperBound(to) : FindLowerBound(to);
+  if (first >= last) {
+    return nullptr;
+  }
+
+  return std::make_unique<SpanPointEnumerator>(
+      std::span{points_}.subspan(first, last - first));
+}
+
+std::unique_ptr<PointEnumerator> PyramidDataSource::EnumReducedPoints(
+    double from,
+    double to,
+    double resolution) {
+  size_t first = FindLowerBound(from);
+  size_t last = FindUpperBound(to);
+  if (first >= last) {
+    return nullptr;
+  }
+
+  double column_count =
+      resolution > 0 ? std::ceil((to - from) / resolution) : 0;
+  if (last - first <= column_count * kMinPointsPerColumnToReduce ||
+      resolution <= 0) {
+    return std::make_unique<SpanPointEnumerator>(
+        std::span{points_}.subspan(first, last - first));
+  }
+
+  // Every pixel column is represented by its first, minimum, maximum and last
+  // points in the original order. These keep both the vertical extent of the
+  // column and the segments connecting it to the neighbor columns.
+  std::vector<GraphPoint> reduced_points;
+  reduced_points.reserve(static_cast<size_t>(column_count) * 4);
+
+  auto begin = points_.begin();
+  for (size_t column_first = first; column_first < last;) {
+    // Skip empty columns.
+    double column = std::floor((points_[column_first].x - from) / resolution);
+    double column_end = from + (column + 1) * resolution;
+    size_t column_last =
+        std::ranges::lower_bound(begin + column_first, begin + last, column_end,
+                                 {}, &GraphPoint::x) -
+        begin;
+    column_last = std::max(column_last, column_first + 1);
+
+    auto extremes = pyramid_.Query(points_, column_first, column_last);
+
+    size_t indexes[] = {column_first, extremes.min_index, extremes.max_index,
+                        column_last - 1};
+    std::ranges::sort(indexes);
+    for (size_t i = 0; i < std::size(indexes); ++i) {
+      if (i == 0 || indexes[i] != indexes[i - 1]) {
+        reduced_points.push_back(points_[indexes[i]]);
+      }
+    }
+
+    column_first = column_last;
+  }
+
+  return std::make_unique<VectorPointEnumerator>(std::move(reduced_points));
+}
+
+std::unique_ptr<PointEnumerator> PyramidDataSource::EnumSteppedPoints(
+    double from,
+    double to,
+    double resolution) {
+  size_t first = FindLowerBound(from);
+  size_t last = FindUpperBound(to);
+  if (first >= last) {
+    return nullptr;
+  }
+
+  auto get_column = [&](size_t index) {
+    return resolution > 0 ? std::floor((points_[index].x - from) / resolution)
+                          : points_[index].x;
+  };
+
+  auto begin = points_.begin();
+  std::vector<GraphPoint> stepped_points;
+  auto add_point = [&](size_t index) {
+    if (stepped_points.empty() || stepped_points.back() != points_[index]) {
+      stepped_points.push_back(points_[index]);
+    }
+  };
+
+  // `index` is the last point added. Every iteration adds the next transition,
+  // or the extremes of the pixel column if it has more transitions.
+  size_t index = first;
+  add_point(index);
+  for (;;) {
+    size_t next_index =
+        pyramid_.FindFirstDifferent(points_, index + 1, last, points_[index]);
+    if (next_index == last) {
+      break;
+    }
+
+    size_t column_last = last;
+    if (resolution > 0) {
+      double column_end = from + (get_column(next_index) + 1) * resolution;
+      column_last = std::ranges::lower_bound(begin + next_index, begin + last,
+                                             column_end, {}, &GraphPoint::x) -
+                    begin;
+      column_last = std::max(column_last, next_index + 1);
+    }
+
+    if (resolution <= 0 ||
+        pyramid_.FindFirstDifferent(points_, next_index + 1, column_last,
+                                    points_[next_index]) == column_last) {
+      // A single transition in the column.
+      add_point(next_index);
+      index = next_index;
+      continue;
+    }
+
+    // Several transitions in one column are drawn as the column extremes
+    // followed by the value held at the end of the column.
+    auto extremes = pyramid_.Query(points_, next_index, column_last);
+    size_t indexes[] = {next_index, extremes.min_index, extremes.max_index,
+                        column_last - 1};
+    std::ranges::sort(indexes);
+    for (size_t i : indexes) {
+      add_point(i);
+    }
+    index = column_last - 1;
+  }
+
+  // Keep the last point, so the last step spans the whole range.
+  add_point(last - 1);
+
+  return std::make_unique<VectorPointEnumerator>(std::move(stepped_points));
+}
+
+GraphRange PyramidDataSource::GetHorizontalRange() const {
+  if (points_.empty()) {
+    return GraphRange{};
+  }
+  return GraphRange{points_.front().x, points_.back().x, horizontal_kind_};
+}
+
+GraphRange PyramidDataSource::GetVerticalRange() const {
+  if (points_.empty()) {
+    return GraphRange{};
+  }
+  const auto& total = pyramid_.GetTotal();
+  return GraphRange{total.min, total.max};
+}
+
+std::optional<GraphRange> PyramidDataSource::QueryVerticalRange(
+    double x1,
+    double x2) const {
+  size_t first = FindLowerBound(x1);
+  size_t last = FindLowerBound(x2);
+  if (first >= last) {
+    return GraphRange{};
+  }
+  auto extremes = pyramid_.Query(points_, first, last);
+  return GraphRange{extremes.min, extremes.max};
+}
+
+std::optional<GraphStatistics> PyramidDataSource::QueryStatistics(
+    double x1,
+    double x2) const {
+  size_t first = FindLowerBound(x1);
+  size_t last = FindUpperBound(x2);
+  if (first >= last) {
+    return GraphStatistics{};
+  }
+
+  auto statistics = aggregate_index_.Query(points_, first, last, x2);
+  auto extremes = pyramid_.Query(points_, first, last);
+  statistics.min = extremes.min;
+  statistics.max = extremes.max;
+  return statistics;
+}
+
+std::optional<std::vector<GraphBand>> PyramidDataSource::QueryQuantileBands(
+    double from,
+    double to,
+    double resolution,
+    double quantile) const {
+  assert(resolution > 0);
+
+  size_t first = FindLowerBound(from);
+  size_t last = FindUpperBound(to);
+
+  auto begin = points_.begin();
+  std::vector<GraphBand> bands;
+  while (first < last) {
+    double column = std::floor((points_[first].x - from) / resolution);
+    double column_from = from + column * resolution;
+    size_t column_last =
+        std::ranges::lower_bound(begin + first, begin + last,
+                                 column_from + resolution, {}, &GraphPoint::x) -
+        begin;
+    column_last = std::max(column_last, first + 1);
+
+    // Wide columns are extended to the next leaf bucket, so the sketches are
+    // merged without reading the points of partial buckets.
+    const size_t kLeafSize = QuantileSummary::kLeafSize;
+    if (column_last - first >= kLeafSize) {
+      column_last = std::min(
+          last, (column_last + kLeafSize - 1) / kLeafSize * kLeafSize);
+    }
+
+    auto sketch = quantile_summary_.Query(points_, first, column_last);
+    bands.push_back({column_from, sketch.Quantile(quantile),
+                     sketch.Quantile(0.5), sketch.Quantile(1 - quantile)});
+
+    first = column_last;
+  }
+
+  return bands;
+}
+
+std::optional<size_t> PyramidDataSource::LowerBound(double value) const {
+  return FindLowerBound(value);
+}
+
+std::optional<size_t> PyramidDataSource::UpperBound(double value) const {
+  return FindUpperBound(value);
+}
+
+std::optional<double> PyramidDataSource::GetPointX(size_t index) const {
+  return points_[index].x;
+}
+
+size_t PyramidDataSource::FindLowerBound(double value) const {
+  return std::ranges::lower_bound(points_, value, {}, &GraphPoint::x) -
+         points_.begin();
+}
+
+size_t PyramidDataSource::FindUpperBound(double value) const {
+  return std::ranges::upper_bound(points_, value, {}, &GraphPoint::x) -
+         points_.begin();
+}
+
+}  // namespace views
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "graph_qt/model/aggregate_index.h"
+#include "graph_qt/model/graph_data_source.h"
+#include "graph_qt/model/min_max_pyramid.h"
+#include "graph_qt/model/quantile_summary.h"
+
+#include <span>
+#include <vector>
+
+namespace views {
+
+// In-memory data source that keeps a min/max pyramid, an aggregate index and
+// quantile sketches over its points. All are updated incrementally on append,
+// so reduced enumeration serves a bounded number of points per pixel column at
+// any zoom level, auto-range and statistics queries take O(log n), stepped
+// enumeration skips runs of equal points in O(log n) per transition, and
+// quantile bands merge sketches instead of reading the points.
+class PyramidDataSource : public GraphDataSource {
+ public:
+  explicit PyramidDataSource(
+      GraphRange::Kind horizontal_kind = GraphRange::LINEAR);
+  ~PyramidDataSource() override;
+
+  size_t size() const { return points_.size(); }
+
+  // Appends points. The points must be sorted by x, and the first one must
+  // not precede the last existing point.
+  void AddPoint(const GraphPoint& point);
+  void AddPoints(std::span<const GraphPoint> points);
+
+  void Clear();
+
+  // GraphDataSource
+  double GetCurrentValue() const override;
+  std::unique_ptr<PointEnumerator> EnumPoints(
+      double from,
+      double to,
+      bool include_left_bound,
+      bool include_right_bound) override;
+  std::unique_ptr<PointEnumerator> EnumReducedPoints(
+      double from,
+      double to,
+      double resolution) override;
+  std::unique_ptr<PointEnumerator> EnumSteppedPoints(
+      double from,
+      double to,
+      double resolution) override;
+  GraphRange GetHorizontalRange() const override;
+  GraphRange GetVerticalRange() const override;
+  std::optional<GraphRange> QueryVerticalRange(double x1,
+                                               double x2) const override;
+  std::optional<GraphStatistics> QueryStatistics(double x1,
+                                                 double x2) const override;
+  std::optional<std::vector<GraphBand>> QueryQuantileBands(
+      double from,
+      double to,
+      double resolution,
+      double quantile) const override;
+  std::optional<size_t> LowerBound(double value) const override;
+  std::optional<size_t> UpperBound(double value) const override;
+  std::optional<double> GetPointX(size_t index) const override;
+
+ private:
+  size_t FindLowerBound(double value) const;
+  size_t FindUpperBound(double value) const;
+
+  void NotifyPointsAdded();
+
+  const GraphRange::Kind horizontal_kind_;
+
+  std::vector<GraphPoint> points_;
+  MinMaxPyramid pyramid_;
+  AggregateIndex aggregate_index_;
+  QuantileSummary quantile_summary_;
+};
+
+}  // namespace views
@@ -0,0 +1,221 @@
+#include "graph_qt/model/pyramid_data_source.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace views {
+
+namespace {
+
+class CountingObserver : public GraphDataSource::Observer {
+ public:
+  void OnDataSourceHistoryChanged() override { ++history_changed_count; }
+  void OnDataSourceCurrentValueChanged() override {
+    ++current_value_changed_count;
+  }
+
+  int history_changed_count = 0;
+  int current_value_changed_count = 0;
+};
+
+std::vector<GraphPoint> Enumerate(PointEnumerator* point_enum) {
+  std::vector<GraphPoint> points;
+  if (point_enum) {
+    ForEachPoint(*point_enum,
+                 [&](const GraphPoint& point) { points.push_back(point); });
+  }
+  return points;
+}
+
+}  // namespace
+
+class PyramidDataSourceTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    std::vector<GraphPoint> points;
+    for (int i = 0; i < kCount; ++i) {
+      points.emplace_back(i, std::sin(i / 100.0) * 100);
+    }
+    data_source_.AddPoints(points);
+  }
+
+  static const int kCount = 100000;
+
+  PyramidDataSource data_source_;
+};
+
+TEST_F(PyramidDataSourceTest, Ranges) {
+  EXPECT_EQ(data_source_.GetHorizontalRange(), GraphRange(0, kCount - 1));
+  EXPECT_EQ(data_source_.GetVerticalRange(),
+            data_source_.CalculateAutoRange(0, kCount));
+  EXPECT_EQ(data_source_.GetCurrentValue(),
+            std::sin((kCount - 1) / 100.0) * 100);
+}
+
+TEST_F(PyramidDataSourceTest, EnumPoints) {
+  auto points = Enumerate(data_source_.EnumPoints(10, 20, true, false).get());
+  ASSERT_EQ(points.size(), 10u);
+  EXPECT_EQ(points.front().x, 10);
+  EXPECT_EQ(points.back().x, 19);
+
+  points = Enumerate(data_source_.EnumPoints(10, 20, false, true).get());
+  ASSERT_EQ(points.size(), 10u);
+  EXPECT_EQ(points.front().x, 11);
+  EXPECT_EQ(points.back().x, 20);
+
+  EXPECT_EQ(data_source_.CountPoints(10, 20, true, true), 11u);
+}
+
+TEST_F(PyramidDataSourceTest, EnumReducedPointsKeepsColumnExtremes) {
+  const double from = 1234;
+  const double to = 87654;
+  const int column_count = 500;
+  const double resolution = (to - from) / column_count;
+
+  auto points =
+      Enumerate(data_source_.EnumReducedPoints(from, to, resolution).get());
+  EXPECT_LE(points.size(), column_count * 4u + 4);
+  EXPECT_TRUE(std::ranges::is_sorted(points, {}, &GraphPoint::x));
+
+  // Every column keeps its extremes.
+  for (int column = 0; column < column_count; column += 37) {
+    double column_from = from + column * resolution;
+    double column_to = column_from + resolution;
+    auto expected = data_source_.CalculateAutoRange(column_from, column_to);
+    double low = std::numeric_limits<double>::max();
+    double high = std::numeric_limits<double>::lowest();
+    for (const auto& point : points) {
+      if (point.x >= column_from && point.x < column_to) {
+        low = std::min(low, point.y);
+        high = std::max(high, point.y);
+      }
+    }
+    GraphRange actual{low, high};
+    EXPECT_EQ(actual, expected) << column;
+  }
+}
+
+TEST_F(PyramidDataSourceTest, QueryVerticalRangeMatchesEnumeration) {
+  for (auto [x1, x2] : {std::pair{0.0, 100.0}, std::pair{10.5, 20.5},
+                        std::pair{-50.0, 5000.0}, std::pair{12345.0, 98765.0},
+                        std::pair{99990.0, 200000.0}}) {
+    double low = std::numeric_limits<double>::max();
+    double high = std::numeric_limits<double>::lowest();
+    for (const auto& point :
+         Enumerate(data_source_.EnumPoints(x1, x2, true, false).get())) {
+      low = std::min(low, point.y);
+      high = std::max(high, point.y);
+    }
+    EXPECT_EQ(data_source_.QueryVerticalRange(x1, x2), GraphRange(low, high))
+        << x1 << " " << x2;
+  }
+
+  EXPECT_EQ(data_source_.QueryVerticalRange(20.5, 20.7), GraphRange());
+  EXPECT_EQ(data_source_.QueryVerticalRange(kCount, kCount + 10),
+            GraphRange());
+}
+
+TEST_F(PyramidDataSourceTest, QueryStatisticsMatchesEnumeration) {
+  for (auto [x1, x2] : {std::pair{0.0, 100.0}, std::pair{10.5, 20.5},
+                        std::pair{-50.0, 5000.0}, std::pair{12345.0, 98765.0},
+                        std::pair{99990.0, 200000.0}}) {
+    auto statistics = data_source_.QueryStatistics(x1, x2);
+    ASSERT_TRUE(statistics);
+
+    auto point_enum = data_source_.EnumPoints(x1, x2, true, true);
+    auto expected = CalculateStatistics(*point_enum, x2);
+    EXPECT_EQ(statistics->count, expected.count);
+    EXPECT_NEAR(statistics->mean, expected.mean, 1e-9);
+    EXPECT_NEAR(statistics->stddev, expected.stddev, 1e-6);
+    EXPECT_NEAR(statistics->integral, expected.integral, 1e-6);
+    EXPECT_EQ(statistics->min, expected.min);
+    EXPECT_EQ(statistics->max, expected.max);
+  }
+
+  EXPECT_EQ(data_source_.QueryStatistics(20.5, 20.7), GraphStatistics());
+}
+
+TEST_F(PyramidDataSourceTest, QueryQuantileBands) {
+  auto bands = data_source_.QueryQuantileBands(0, kCount, 1000, 0.05);
+  ASSERT_TRUE(bands);
+  ASSERT_EQ(bands->size(), 100u);
+
+  for (size_t i = 0; i < bands->size(); ++i) {
+    const auto& band = (*bands)[i];
+    EXPECT_EQ(band.x, i * 1000.0);
+    EXPECT_LE(band.low, band.median);
+    EXPECT_LE(band.median, band.high);
+
+    // Columns may be extended to the next leaf bucket.
+    auto range = *data_source_.QueryVerticalRange(
+        band.x, band.x + 1000 + QuantileSummary::kLeafSize);
+    EXPECT_GE(band.low, range.low());
+    EXPECT_LE(band.high, range.high());
+  }
+
+  EXPECT_EQ(data_source_.QueryQuantileBands(20.5, 20.7, 1, 0.05),
+            std::vector<GraphBand>());
+}
+
+TEST_F(PyramidDataSourceTest, EnumReducedPointsServesRawPointsWhenZoomedIn) {
+  auto points = Enumerate(data_source_.EnumReducedPoints(100, 200, 1).get());
+  EXPECT_EQ(points.size(), 101u);
+}
+
+TEST(PyramidDataSourceSteppedTest, EnumSteppedPoints) {
+  // Values change every 100 points.
+  PyramidDataSource data_source;
+  for (int i = 0; i < 10000; ++i) {
+    data_source.AddPoint(
+        {static_cast<double>(i), static_cast<double>(i / 100)});
+  }
+
+  // Fine resolution serves one point per transition and the last point.
+  auto points = Enumerate(data_source.EnumSteppedPoints(0, 9999, 0.5).get());
+  auto expected = Enumerate(
+      data_source.GraphDataSource::EnumSteppedPoints(0, 9999, 0.5).get());
+  EXPECT_EQ(points, expected);
+  ASSERT_EQ(points.size(), 101u);
+  EXPECT_EQ(points[1], GraphPoint(100, 1));
+  EXPECT_EQ(points.back(), GraphPoint(9999, 99));
+
+  // Coarse resolution keeps the column extremes and the value at the end of
+  // each column.
+  points = Enumerate(data_source.EnumSteppedPoints(0, 9999, 1000).get());
+  EXPECT_LE(points.size(), 4u * 10 + 1);
+  EXPECT_EQ(points.front(), GraphPoint(0, 0));
+  EXPECT_EQ(points.back(), GraphPoint(9999, 99));
+  for (int column = 0; column < 10; ++column) {
+    double low = std::numeric_limits<double>::max();
+    double high = std::numeric_limits<double>::lowest();
+    for (const auto& point : points) {
+      if (point.x >= column * 1000 && point.x < (column + 1) * 1000) {
+        low = std::min(low, point.y);
+        high = std::max(high, point.y);
+      }
+    }
+    EXPECT_EQ(low, column * 10) << column;
+    EXPECT_EQ(high, column * 10 + 9) << column;
+  }
+  EXPECT_TRUE(std::ranges::is_sorted(points, {}, &GraphPoint::x));
+}
+
+TEST_F(PyramidDataSourceTest, AddPointNotifies) {
+  CountingObserver observer;
+  data_source_.SetObserver(&observer);
+
+  data_source_.AddPoint({kCount, 1000});
+
+  EXPECT_EQ(observer.history_changed_count, 1);
+  EXPECT_EQ(observer.current_value_changed_count, 1);
+  EXPECT_EQ(data_source_.GetCurrentValue(), 1000);
+  EXPECT_EQ(data_source_.GetVerticalRange().high(), 1000);
+
+  data_source_.SetObserver(nullptr);
+}
+
+}  // namespace views
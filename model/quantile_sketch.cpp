@@ -0,0 +1,118 @@
+#include "graph_qt/model/quantile_sketch.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numbers>
+
+namespace views {
+
+namespace {
+
+// The buffer is compressed when the centroids exceed this multiple of the
+// compression.
+const double kBufferFactor = 8;
+
+}  // namespace
+
+void QuantileSketch::Add(double value) {
+  AddCentroid({value, 1});
+}
+
+void QuantileSketch::Merge(const QuantileSketch& other) {
+  for (const auto& centroid : other.centroids_) {
+    AddCentroid(centroid);
+  }
+  min_ = std::min(min_, other.min_);
+  max_ = std::max(max_, other.max_);
+}
+
+void QuantileSketch::AddCentroid(const Centroid& centroid) {
+  centroids_.push_back(centroid);
+  total_weight_ += centroid.weight;
+  min_ = std::min(min_, centroid.mean);
+  max_ = std::max(max_, centroid.mean);
+
+  if (centroids_.size() > kBufferFactor * compression_) {
+    Compress();
+  }
+}
+
+void QuantileSketch::Compress() {
+  if (compressed_count_ == centroids_.size()) {
+    return;
+  }
+
+  std::ranges::sort(centroids_, {}, &Centroid::mean);
+
+  // Scale function k1 of the t-digest paper: centroids may span one unit of
+  // `k(q) = compression / (2 * pi) * asin(2q - 1)`, which keeps them small
+  // near the tails.
+  const double normalizer = compression_ / (2 * std::numbers::pi);
+  auto k_to_q = [&](double k) {
+    double angle = std::min(k / normalizer, std::numbers::pi / 2);
+    return (std::sin(angle) + 1) / 2;
+  };
+  auto q_to_k = [&](double q) { return normalizer * std::asin(2 * q - 1); };
+
+  std::vector<Centroid> compressed;
+  double weight_before = 0;
+  Centroid current = centroids_.front();
+  double weight_limit = total_weight_ * k_to_q(q_to_k(0) + 1);
+
+  for (size_t i = 1; i < centroids_.size(); ++i) {
+    const auto& next = centroids_[i];
+    if (weight_before + current.weight + next.weight <= weight_limit) {
+      current.mean += (next.mean - current.mean) * next.weight /
+                      (current.weight + next.weight);
+      current.weight += next.weight;
+      continue;
+    }
+
+    weight_before += current.weight;
+    compressed.push_back(current);
+    current = next;
+    weight_limit =
+        total_weight_ * k_to_q(q_to_k(weight_before / total_weight_) + 1);
+  }
+  compressed.push_back(current);
+
+  centroids_ = std::move(compressed);
+  compressed_count_ = centroids_.size();
+}
+
+double QuantileSketch::Quantile(double q) const {
+  assert(!empty());
+  assert(compressed_count_ == centroids_.size());
+
+  if (centroids_.size() == 1) {
+    return centroids_.front().mean;
+  }
+
+  // Every centroid is centered on its cumulative weight, and the values in
+  // between are interpolated. The exact extremes bound the tails.
+  double target = std::clamp(q, 0.0, 1.0) * total_weight_;
+  const auto& first = centroids_.front();
+  if (target < first.weight / 2) {
+    return min_ + (first.mean - min_) * target / (first.weight / 2);
+  }
+
+  double center = first.weight / 2;
+  for (size_t i = 1; i < centroids_.size(); ++i) {
+    const auto& previous = centroids_[i - 1];
+    const auto& next = centroids_[i];
+    double next_center = center + (previous.weight + next.weight) / 2;
+    if (target < next_center) {
+      return previous.mean + (next.mean - previous.mean) *
+                                 (target - center) / (next_center - center);
+    }
+    center = next_center;
+  }
+
+  const auto& last = centroids_.back();
+  double tail = total_weight_ - center;
+  return tail > 0 ? last.mean + (max_ - last.mean) * (target - center) / tail
+                  : max_;
+}
+
+}  // namespace views
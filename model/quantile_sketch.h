@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace views {
+
+// Mergeable quantile sketch (t-digest). Values are summarized by weighted
+// centroids which are small near the tails, so extreme quantiles stay
+// accurate while the size is bounded by about `2 * compression` centroids.
+// Merging two sketches costs O(size) and doesn't need the raw values.
+class QuantileSketch {
+ public:
+  static constexpr double kDefaultCompression = 32;
+
+  explicit QuantileSketch(double compression = kDefaultCompression)
+      : compression_{compression} {}
+
+  bool empty() const { return total_weight_ == 0; }
+
+  // Number of values summarized.
+  double count() const { return total_weight_; }
+
+  void Add(double value);
+  void Merge(const QuantileSketch& other);
+
+  // Merges the centroids added since the last call. Must be called before
+  // `Quantile()`; adding and merging call it when the buffer grows too big.
+  void Compress();
+
+  // Returns the estimated value at quantile `q` in `[0, 1]`. The sketch must
+  // not be empty, and must be compressed.
+  double Quantile(double q) const;
+
+ private:
+  struct Centroid {
+    double mean;
+    double weight;
+  };
+
+  void AddCentroid(const Centroid& centroid);
+
+  const double compression_;
+
+  // Sorted and compressed centroids followed by the buffered ones.
+  std::vector<Centroid> centroids_;
+  size_t compressed_count_ = 0;
+
+  double total_weight_ = 0;
+  double min_ = std::numeric_limits<double>::max();
+  double max_ = std::numeric_limits<double>::lowest();
+};
+
+}  // namespace views
@@ -0,0 +1,68 @@
+#include "graph_qt/model/quantile_sketch.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+namespace views {
+
+TEST(QuantileSketchTest, SingleValue) {
+  QuantileSketch sketch;
+  sketch.Add(5);
+  sketch.Compress();
+
+  EXPECT_EQ(sketch.count(), 1);
+  EXPECT_EQ(sketch.Quantile(0), 5);
+  EXPECT_EQ(sketch.Quantile(0.5), 5);
+  EXPECT_EQ(sketch.Quantile(1), 5);
+}
+
+TEST(QuantileSketchTest, UniformValues) {
+  // Shuffled values 0..9999.
+  std::vector<double> values;
+  for (int i = 0; i < 10000; ++i) {
+    values.push_back(i);
+  }
+  std::shuffle(values.begin(), values.end(), std::mt19937{42});
+
+  QuantileSketch sketch;
+  for (double value : values) {
+    sketch.Add(value);
+  }
+  sketch.Compress();
+
+  EXPECT_EQ(sketch.count(), 10000);
+  EXPECT_EQ(sketch.Quantile(0), 0);
+  EXPECT_EQ(sketch.Quantile(1), 9999);
+  for (double q : {0.01, 0.05, 0.25, 0.5, 0.75, 0.95, 0.99}) {
+    EXPECT_NEAR(sketch.Quantile(q), q * 10000, 10000 * 0.01) << q;
+  }
+}
+
+TEST(QuantileSketchTest, MergeMatchesWhole) {
+  std::mt19937 generator{42};
+  std::normal_distribution<double> distribution{100, 10};
+
+  QuantileSketch whole;
+  std::vector<QuantileSketch> parts(16);
+  for (int i = 0; i < 16000; ++i) {
+    double value = distribution(generator);
+    whole.Add(value);
+    parts[i % parts.size()].Add(value);
+  }
+  whole.Compress();
+
+  QuantileSketch merged;
+  for (auto& part : parts) {
+    part.Compress();
+    merged.Merge(part);
+  }
+  merged.Compress();
+
+  EXPECT_EQ(merged.count(), whole.count());
+  for (double q : {0.05, 0.5, 0.95}) {
+    EXPECT_NEAR(merged.Quantile(q), whole.Quantile(q), 0.5) << q;
+  }
+}
+
+}  // namespace views
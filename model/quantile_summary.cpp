@@ -0,0 +1,97 @@
+#include "graph_qt/model/quantile_summary.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace views {
+
+void QuantileSummary::Update(std::span<const GraphPoint> points) {
+  assert(points.size() >= leaf_points());
+
+  for (size_t first = leaf_points(); first + kLeafSize <= points.size();
+       first += kLeafSize) {
+    QuantileSketch sketch;
+    for (const auto& point : points.subspan(first, kLeafSize)) {
+      sketch.Add(point.y);
+    }
+    sketch.Compress();
+
+    if (levels_.empty()) {
+      levels_.emplace_back();
+    }
+    levels_.front().push_back(std::move(sketch));
+
+    // Merge the complete buckets into the upper levels.
+    for (size_t level = 0; levels_[level].size() % kFanout == 0; ++level) {
+      if (level + 1 == levels_.size()) {
+        levels_.emplace_back();
+      }
+      QuantileSketch upper;
+      for (size_t i = levels_[level].size() - kFanout;
+           i < levels_[level].size(); ++i) {
+        upper.Merge(levels_[level][i]);
+      }
+      upper.Compress();
+      levels_[level + 1].push_back(std::move(upper));
+    }
+  }
+}
+
+void QuantileSummary::Clear() {
+  levels_.clear();
+}
+
+QuantileSketch QuantileSummary::Query(std::span<const GraphPoint> points,
+                                      size_t first,
+                                      size_t last) const {
+  assert(first <= last);
+  assert(last <= points.size());
+
+  QuantileSketch result;
+
+  auto add_points = [&](size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i) {
+      result.Add(points[i].y);
+    }
+  };
+
+  // Complete leaf buckets inside the range.
+  size_t leaf_first = (first + kLeafSize - 1) / kLeafSize;
+  size_t leaf_last = std::min(last, leaf_points()) / kLeafSize;
+  if (leaf_first >= leaf_last) {
+    add_points(first, last);
+    result.Compress();
+    return result;
+  }
+
+  add_points(first, leaf_first * kLeafSize);
+  add_points(leaf_last * kLeafSize, last);
+
+  auto merge_units = [&](size_t level, size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i) {
+      result.Merge(levels_[level][i]);
+    }
+  };
+
+  // `first` and `last` are in units of the current level.
+  first = leaf_first;
+  last = leaf_last;
+  for (size_t level = 0; first < last; ++level) {
+    size_t upper_first = (first + kFanout - 1) / kFanout;
+    size_t upper_last = last / kFanout;
+    if (level + 1 == levels_.size() || upper_first >= upper_last) {
+      merge_units(level, first, last);
+      break;
+    }
+
+    merge_units(level, first, upper_first * kFanout);
+    merge_units(level, upper_last * kFanout, last);
+    first = upper_first;
+    last = upper_last;
+  }
+
+  result.Compress();
+  return result;
+}
+
+}  // namespace views
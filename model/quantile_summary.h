@@ -0,0 +1,45 @@
+#pragma once
+
+#include "graph_qt/model/graph_types.h"
+#include "graph_qt/model/quantile_sketch.h"
+
+#include <span>
+#include <vector>
+
+namespace views {
+
+// Hierarchy of quantile sketches over an append-only sequence of points.
+// Level 0 keeps a sketch of every complete bucket of `kLeafSize` points, and
+// every upper level merges `kFanout` buckets of the level below. Quantiles of
+// any index range are estimated by merging O(log n) sketches, and only the
+// points of the partial buckets at the range ends are read.
+//
+// The summary doesn't own the points. The same sequence must be passed to all
+// calls.
+class QuantileSummary {
+ public:
+  static constexpr size_t kLeafSize = 256;
+  static constexpr size_t kFanout = 8;
+
+  // Summarizes the points appended since the last call.
+  void Update(std::span<const GraphPoint> points);
+
+  void Clear();
+
+  // Returns a compressed sketch of the values in `[first, last)`.
+  QuantileSketch Query(std::span<const GraphPoint> points,
+                       size_t first,
+                       size_t last) const;
+
+ private:
+  using Level = std::vector<QuantileSketch>;
+
+  // Number of points summarized by the complete leaf buckets.
+  size_t leaf_points() const {
+    return levels_.empty() ? 0 : levels_.front().size() * kLeafSize;
+  }
+
+  std::vector<Level> levels_;
+};
+
+}  // namespace views
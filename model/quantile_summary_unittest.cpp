@@ -0,0 +1,74 @@
+#include "graph_qt/model/quantile_summary.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace views {
+
+namespace {
+
+std::vector<GraphPoint> MakeNoisyPoints(size_t count) {
+  std::mt19937 generator{42};
+  std::normal_distribution<double> distribution{0, 10};
+
+  std::vector<GraphPoint> points;
+  for (size_t i = 0; i < count; ++i) {
+    // Rare spikes mustn't move the quantiles.
+    double spike = i % 1000 == 0 ? 1000 : 0;
+    points.emplace_back(i, distribution(generator) + spike);
+  }
+  return points;
+}
+
+// Returns the fraction of values in `[first, last)` below `value`.
+double GetRank(const std::vector<GraphPoint>& points,
+               size_t first,
+               size_t last,
+               double value) {
+  auto count = std::count_if(
+      points.begin() + first, points.begin() + last,
+      [value](const GraphPoint& point) { return point.y < value; });
+  return static_cast<double>(count) / (last - first);
+}
+
+}  // namespace
+
+TEST(QuantileSummaryTest, QueryEstimatesQuantiles) {
+  auto points = MakeNoisyPoints(100000);
+
+  QuantileSummary summary;
+  summary.Update(points);
+
+  for (auto [first, last] : {std::pair{0, 100000}, std::pair{100, 200},
+                             std::pair{1234, 56789}, std::pair{99000, 100000},
+                             std::pair{4096, 8192}}) {
+    auto sketch = summary.Query(points, first, last);
+    EXPECT_EQ(sketch.count(), last - first);
+    for (double q : {0.05, 0.5, 0.95}) {
+      EXPECT_NEAR(GetRank(points, first, last, sketch.Quantile(q)), q, 0.02)
+          << first << " " << last << " " << q;
+    }
+  }
+}
+
+TEST(QuantileSummaryTest, IncrementalUpdate) {
+  auto all_points = MakeNoisyPoints(20000);
+
+  std::vector<GraphPoint> points;
+  QuantileSummary summary;
+  for (size_t count = 1000; count <= all_points.size(); count += 1000) {
+    points.assign(all_points.begin(), all_points.begin() + count);
+    summary.Update(points);
+
+    auto sketch = summary.Query(points, 0, points.size());
+    EXPECT_EQ(sketch.count(), points.size());
+    EXPECT_NEAR(GetRank(points, 0, points.size(), sketch.Quantile(0.5)), 0.5,
+                0.01)
+        << count;
+  }
+}
+
+}  // namespace views
@@ -0,0 +1,152 @@
+#include "graph_qt/model/ring_buffer_data_source.h"
+
+#include "graph_qt/model/point_enumerators.h"
+
+#include <cassert>
+#include <ranges>
+
+namespace views {
+
+RingBufferDataSource::RingBufferDataSource(size_t capacity,
+                                           GraphRange::Kind horizontal_kind)
+    : horizontal_kind_{horizontal_kind},
+      points_(capacity),
+      min_queue_{capacity},
+      max_queue_{capacity} {
+  assert(capacity > 0);
+}
+
+RingBufferDataSource::~RingBufferDataSource() = default;
+
+void RingBufferDataSource::AddPoint(const GraphPoint& point) {
+  AddPoints(std::span{&point, 1});
+}
+
+void RingBufferDataSource::AddPoints(std::span<const GraphPoint> points) {
+  if (points.empty()) {
+    return;
+  }
+
+  for (const auto& point : points) {
+    Append(point);
+  }
+
+  // Evicting only drops points from the front, which incremental observers
+  // handle as they slide their windows.
+  if (observer_) {
+    observer_->OnDataSourceCurrentValueChanged();
+    observer_->OnDataSourcePointsAppended();
+  }
+}
+
+void RingBufferDataSource::Append(const GraphPoint& point) {
+  assert(size_ == 0 || point.x >= at(size_ - 1).x);
+
+  if (size_ == capacity()) {
+    // The oldest point is overwritten below.
+    uint64_t evicted_sequence = next_sequence_ - size_;
+    if (min_queue_.front() == evicted_sequence) {
+      min_queue_.pop_front();
+    }
+    if (max_queue_.front() == evicted_sequence) {
+      max_queue_.pop_front();
+    }
+    first_ = (first_ + 1) % capacity();
+    --size_;
+  }
+
+  uint64_t sequence = next_sequence_++;
+  points_[sequence % capacity()] = point;
+  ++size_;
+
+  while (!min_queue_.empty() &&
+         GetPointBySequence(min_queue_.back()).y >= point.y) {
+    min_queue_.pop_back();
+  }
+  min_queue_.push_back(sequence);
+
+  while (!max_queue_.empty() &&
+         GetPointBySequence(max_queue_.back()).y <= point.y) {
+    max_queue_.pop_back();
+  }
+  max_queue_.push_back(sequence);
+}
+
+void RingBufferDataSource::Clear() {
+  first_ = next_sequence_ % capacity();
+  size_ = 0;
+  min_queue_.clear();
+  max_queue_.clear();
+
+  if (observer_) {
+    observer_->OnDataSourceCurrentValueChanged();
+    observer_->OnDataSourceHistoryChanged();
+  }
+}
+
+double RingBufferDataSource::GetCurrentValue() const {
+  return size_ == 0 ? kGraphUnknownValue : at(size_ - 1).y;
+}
+
+std::unique_ptr<PointEnumerator> RingBufferDataSource::EnumPoints(
+    double from,
+    double to,
+    bool include_left_bound,
+    bool include_right_bound) {
+  size_t first =
+      include_left_bound ? FindLowerBound(from) : FindUpperBound(from);
+  size_t last = include_right_bound ? FindUpperBound(to) : FindLowerBound(to);
+  if (first >= last) {
+    return nullptr;
+  }
+
+  // Split the logical range at the wrap point.
+  size_t physical_first = (first_ + first) % capacity();
+  size_t count = last - first;
+  size_t head_count = std::min(count, capacity() - physical_first);
+  std::span<const GraphPoint> points{points_};
+  return std::make_unique<RingPointEnumerator>(
+      points.subspan(physical_first, head_count),
+      points.first(count - head_count));
+}
+
+GraphRange RingBufferDataSource::GetHorizontalRange() const {
+  if (size_ == 0) {
+    return GraphRange{};
+  }
+  return GraphRange{at(0).x, at(size_ - 1).x, horizontal_kind_};
+}
+
+GraphRange RingBufferDataSource::GetVerticalRange() const {
+  if (size_ == 0) {
+    return GraphRange{};
+  }
+  return GraphRange{GetPointBySequence(min_queue_.front()).y,
+                    GetPointBySequence(max_queue_.front()).y};
+}
+
+std::optional<size_t> RingBufferDataSource::LowerBound(double value) const {
+  return FindLowerBound(value);
+}
+
+std::optional<size_t> RingBufferDataSource::UpperBound(double value) const {
+  return FindUpperBound(value);
+}
+
+std::optional<double> RingBufferDataSource::GetPointX(size_t index) const {
+  return at(index).x;
+}
+
+size_t RingBufferDataSource::FindLowerBound(double value) const {
+  auto indexes = std::views::iota(size_t{0}, size_);
+  auto get_x = [this](size_t index) { return at(index).x; };
+  return std::ranges::lower_bound(indexes, value, {}, get_x) - indexes.begin();
+}
+
+size_t RingBufferDataSource::FindUpperBound(double value) const {
+  auto indexes = std::views::iota(size_t{0}, size_);
+  auto get_x = [this](size_t index) { return at(index).x; };
+  return std::ranges::upper_bound(indexes, value, {}, get_x) - indexes.begin();
+}
+
+}  // namespace views
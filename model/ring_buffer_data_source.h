@@ -0,0 +1,110 @@
+#pragma once
+
+#include "graph_qt/model/graph_data_source.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace views {
+
+// Data source keeping the last `capacity` points in a preallocated ring
+// buffer, for live values with a fixed memory footprint. Appending takes O(1)
+// and doesn't allocate. When the buffer is full every appended point evicts
+// the oldest one. Range lookups are binary searches over the logical order,
+// across the wrap point.
+//
+// The vertical range is kept by monotonic queues of candidate extremes, which
+// are preallocated ring buffers as well.
+class RingBufferDataSource : public GraphDataSource {
+ public:
+  explicit RingBufferDataSource(
+      size_t capacity,
+      GraphRange::Kind horizontal_kind = GraphRange::LINEAR);
+  ~RingBufferDataSource() override;
+
+  size_t capacity() const { return points_.size(); }
+  size_t size() const { return size_; }
+
+  // Appends points, evicting the oldest ones if the buffer is full. The
+  // points must be sorted by x, and the first one must not precede the last
+  // existing point. Sends a single `OnDataSourcePointsAppended()`, also when
+  // the oldest points were evicted.
+  void AddPoint(const GraphPoint& point);
+  void AddPoints(std::span<const GraphPoint> points);
+
+  void Clear();
+
+  // Returns the point at logical `index`, where zero is the oldest point.
+  const GraphPoint& at(size_t index) const {
+    return points_[(first_ + index) % points_.size()];
+  }
+
+  // GraphDataSource
+  double GetCurrentValue() const override;
+  std::unique_ptr<PointEnumerator> EnumPoints(
+      double from,
+      double to,
+      bool include_left_bound,
+      bool include_right_bound) override;
+  GraphRange GetHorizontalRange() const override;
+  GraphRange GetVerticalRange() const override;
+  std::optional<size_t> LowerBound(double value) const override;
+  std::optional<size_t> UpperBound(double value) const override;
+  std::optional<double> GetPointX(size_t index) const override;
+
+ private:
+  // Fixed-capacity deque of point sequence numbers whose values are monotonic
+  // from the front to the back.
+  class ExtremeQueue {
+   public:
+    explicit ExtremeQueue(size_t capacity) : items_(capacity) {}
+
+    bool empty() const { return size_ == 0; }
+    uint64_t front() const { return items_[head_]; }
+    uint64_t back() const {
+      return items_[(head_ + size_ - 1) % items_.size()];
+    }
+
+    void push_back(uint64_t sequence) {
+      items_[(head_ + size_++) % items_.size()] = sequence;
+    }
+    void pop_back() { --size_; }
+    void pop_front() {
+      head_ = (head_ + 1) % items_.size();
+      --size_;
+    }
+    void clear() { head_ = size_ = 0; }
+
+   private:
+    std::vector<uint64_t> items_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+  };
+
+  const GraphPoint& GetPointBySequence(uint64_t sequence) const {
+    return points_[sequence % points_.size()];
+  }
+
+  void Append(const GraphPoint& point);
+
+  size_t FindLowerBound(double value) const;
+  size_t FindUpperBound(double value) const;
+
+  const GraphRange::Kind horizontal_kind_;
+
+  std::vector<GraphPoint> points_;
+  // Physical index of the oldest point.
+  size_t first_ = 0;
+  size_t size_ = 0;
+  // Sequence number of the next appended point. The point with sequence `s`
+  // is stored at `s % capacity()`.
+  uint64_t next_sequence_ = 0;
+
+  // Candidate minimums with increasing values, and candidate maximums with
+  // decreasing values.
+  ExtremeQueue min_queue_;
+  ExtremeQueue max_queue_;
+};
+
+}  // namespace views
@@ -0,0 +1,107 @@
+#include "graph_qt/model/ring_buffer_data_source.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace views {
+
+namespace {
+
+class CountingObserver : public GraphDataSource::Observer {
+ public:
+  void OnDataSourceHistoryChanged() override { ++history_changed_count; }
+  void OnDataSourcePointsAppended() override { ++points_appended_count; }
+  void OnDataSourceCurrentValueChanged() override {
+    ++current_value_changed_count;
+  }
+
+  int history_changed_count = 0;
+  int points_appended_count = 0;
+  int current_value_changed_count = 0;
+};
+
+std::vector<GraphPoint> Enumerate(PointEnumerator* point_enum) {
+  std::vector<GraphPoint> points;
+  if (point_enum) {
+    ForEachPoint(*point_enum,
+                 [&](const GraphPoint& point) { points.push_back(point); });
+  }
+  return points;
+}
+
+GraphPoint MakePoint(int i) {
+  return {static_cast<double>(i), std::sin(i / 10.0) * 100};
+}
+
+}  // namespace
+
+TEST(RingBufferDataSourceTest, KeepsLastPoints) {
+  RingBufferDataSource data_source{100};
+
+  for (int i = 0; i < 1234; ++i) {
+    data_source.AddPoint(MakePoint(i));
+    ASSERT_EQ(data_source.size(), std::min(i + 1, 100));
+  }
+
+  EXPECT_EQ(data_source.GetHorizontalRange(), GraphRange(1134, 1233));
+  EXPECT_EQ(data_source.GetCurrentValue(), MakePoint(1233).y);
+
+  // Enumeration crosses the wrap point.
+  auto points =
+      Enumerate(data_source.EnumPoints(1100, 1200, true, false).get());
+  ASSERT_EQ(points.size(), 66u);
+  for (size_t i = 0; i < points.size(); ++i) {
+    EXPECT_EQ(points[i], MakePoint(1134 + i));
+  }
+
+  EXPECT_EQ(data_source.EnumPoints(0, 1000, true, true), nullptr);
+  EXPECT_EQ(data_source.CountPoints(1150, 1160, true, true), 11u);
+  EXPECT_EQ(data_source.LowerBound(1150.5), 17u);
+  EXPECT_EQ(data_source.GetPointX(17), 1151);
+}
+
+TEST(RingBufferDataSourceTest, VerticalRange) {
+  RingBufferDataSource data_source{50};
+
+  for (int i = 0; i < 500; ++i) {
+    data_source.AddPoint(MakePoint(i));
+
+    double low = MakePoint(i).y;
+    double high = low;
+    for (int j = std::max(0, i - 49); j <= i; ++j) {
+      low = std::min(low, MakePoint(j).y);
+      high = std::max(high, MakePoint(j).y);
+    }
+    ASSERT_EQ(data_source.GetVerticalRange(), GraphRange(low, high)) << i;
+  }
+}
+
+TEST(RingBufferDataSourceTest, Notifications) {
+  RingBufferDataSource data_source{3};
+  CountingObserver observer;
+  data_source.SetObserver(&observer);
+
+  for (int i = 0; i < 5; ++i) {
+    data_source.AddPoint(MakePoint(i));
+  }
+
+  // Evicting the oldest points is still an append.
+  EXPECT_EQ(observer.current_value_changed_count, 5);
+  EXPECT_EQ(observer.points_appended_count, 5);
+  EXPECT_EQ(observer.history_changed_count, 0);
+
+  data_source.Clear();
+  EXPECT_EQ(observer.history_changed_count, 1);
+  EXPECT_EQ(data_source.size(), 0u);
+  EXPECT_EQ(data_source.GetCurrentValue(), kGraphUnknownValue);
+
+  data_source.AddPoint(MakePoint(10));
+  EXPECT_EQ(data_source.GetHorizontalRange(), GraphRange(10, 10));
+
+  data_source.SetObserver(nullptr);
+}
+
+}  // namespace views
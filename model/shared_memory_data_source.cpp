@@ -0,0 +1,300 @@
+#include "graph_qt/model/shared_memory_data_source.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <utility>
+
+namespace views {
+
+namespace {
+
+GraphPoint ReadSlot(const SharedPointSlot& slot) {
+  GraphPoint point{slot.x.load(std::memory_order_relaxed),
+                   slot.y.load(std::memory_order_relaxed)};
+  point.good = slot.good.load(std::memory_order_relaxed) != 0;
+  return point;
+}
+
+}  // namespace
+
+// Enumerates the points of a sequence range straight from the ring.
+class SharedMemoryDataSource::SlotPointEnumerator : public PointEnumerator {
+ public:
+  SlotPointEnumerator(const SharedMemoryDataSource& data_source,
+                      uint64_t first,
+                      uint64_t last)
+      : data_source_{data_source}, sequence_{first}, last_{last} {}
+
+  size_t GetCount() const override { return last_ - sequence_; }
+
+  bool EnumNext(GraphPoint& value) override {
+    return EnumNextBatch(std::span{&value, 1}) == 1;
+  }
+
+  size_t EnumNextBatch(std::span<GraphPoint> points) override {
+    const uint64_t capacity = data_source_.capacity_;
+    while (true) {
+      sequence_ = std::clamp(data_source_.GetOldestSequence(), sequence_,
+                             last_);
+      const size_t count = std::min<uint64_t>(points.size(), last_ - sequence_);
+      if (count == 0) {
+        return 0;
+      }
+
+      for (size_t i = 0; i < count; ++i) {
+        points[i] = ReadSlot(data_source_.slots_[(sequence_ + i) % capacity]);
+      }
+
+      // Drop the points overwritten while they were read, and all of them if
+      // a restarted writer reused the ring.
+      const uint64_t first = sequence_;
+      sequence_ += count;
+      const uint64_t oldest = data_source_.GetOldestSequence();
+      if (!data_source_.IsCurrentGeneration()) {
+        sequence_ = last_;
+        return 0;
+      }
+      const size_t stale =
+          oldest > first ? std::min<uint64_t>(count, oldest - first) : 0;
+      if (stale < count) {
+        std::copy(points.begin() + stale, points.begin() + count,
+                  points.begin());
+        return count - stale;
+      }
+    }
+  }
+
+ private:
+  const SharedMemoryDataSource& data_source_;
+  uint64_t sequence_;
+  const uint64_t last_;
+};
+
+SharedMemoryDataSource::SharedMemoryDataSource(const QString& key,
+                                               GraphRange::Kind horizontal_kind)
+    : key_{key},
+      horizontal_kind_{horizontal_kind},
+      memory_{key},
+      vertical_range_{-std::numeric_limits<double>::infinity()} {}
+
+SharedMemoryDataSource::~SharedMemoryDataSource() = default;
+
+bool SharedMemoryDataSource::Attach() {
+  SharedMemorySegment memory{key_};
+  if (!memory.Open()) {
+    return false;
+  }
+
+  const auto* header = static_cast<const SharedPointRingHeader*>(memory.data());
+  if (memory.size() < sizeof(SharedPointRingHeader) ||
+      header->magic.load(std::memory_order_acquire) !=
+          SharedPointRingHeader::kMagic ||
+      header->version.load(std::memory_order_relaxed) !=
+          SharedPointRingHeader::kVersion) {
+    return false;
+  }
+
+  memory_ = std::move(memory);
+  header_ = header;
+  slots_ = reinterpret_cast<const SharedPointSlot*>(header_ + 1);
+  // Generations are never all ones, so the layout is read first.
+  generation_ = std::numeric_limits<uint64_t>::max();
+  ReadNewPoints();
+
+  if (observer_) {
+    observer_->OnDataSourceCurrentValueChanged();
+    observer_->OnDataSourceHistoryChanged();
+  }
+  return true;
+}
+
+void SharedMemoryDataSource::Detach() {
+  memory_.Close();
+  header_ = nullptr;
+  slots_ = nullptr;
+  capacity_ = 0;
+  Reset();
+
+  if (observer_) {
+    observer_->OnDataSourceCurrentValueChanged();
+    observer_->OnDataSourceHistoryChanged();
+  }
+}
+
+void SharedMemoryDataSource::Reset() {
+  first_ = end_ = 0;
+  vertical_range_ =
+      SlidingWindowRange{-std::numeric_limits<double>::infinity()};
+}
+
+bool SharedMemoryDataSource::Poll() {
+  if (!header_) {
+    return false;
+  }
+
+  if (header_->generation.load(std::memory_order_relaxed) == generation_ &&
+      (capacity_ == 0 ||
+       header_->end_count.load(std::memory_order_relaxed) == end_)) {
+    // Nothing new. The writer may have closed the ring and a new one created
+    // another, or a writer may have replaced the segment of a crashed one.
+    return memory_.IsReplaced() && Attach();
+  }
+
+  const bool appended = ReadNewPoints();
+  if (observer_) {
+    observer_->OnDataSourceCurrentValueChanged();
+    if (appended) {
+      observer_->OnDataSourcePointsAppended();
+    } else {
+      observer_->OnDataSourceHistoryChanged();
+    }
+  }
+  return true;
+}
+
+void SharedMemoryDataSource::ReadLayout() {
+  Reset();
+  capacity_ = 0;
+  if (generation_ % 2 != 0) {
+    return;
+  }
+
+  const uint64_t capacity = header_->capacity.load(std::memory_order_relaxed);
+  const uint64_t start = header_->start_count.load(std::memory_order_relaxed);
+  const uint64_t max_capacity =
+      (memory_.size() - sizeof(SharedPointRingHeader)) /
+      sizeof(SharedPointSlot);
+  if (!IsCurrentGeneration() || capacity == 0 || capacity > max_capacity) {
+    return;
+  }
+
+  capacity_ = capacity;
+  start_ = start;
+  first_ = end_ = start;
+}
+
+bool SharedMemoryDataSource::ReadNewPoints() {
+  // A restarted writer starts over.
+  bool appended = true;
+  const uint64_t generation =
+      header_->generation.load(std::memory_order_acquire);
+  if (generation != generation_) {
+    generation_ = generation;
+    ReadLayout();
+    appended = false;
+  }
+  if (capacity_ == 0) {
+    return appended;
+  }
+
+  // Push the new points to the vertical range.
+  const uint64_t end = header_->end_count.load(std::memory_order_acquire);
+  std::array<GraphPoint, 256> batch;
+  for (uint64_t sequence = std::max(end_, GetOldestSequence());
+       sequence < end;) {
+    const size_t count = std::min<uint64_t>(batch.size(), end - sequence);
+    for (size_t i = 0; i < count; ++i) {
+      batch[i] = ReadSlot(slots_[(sequence + i) % capacity_]);
+    }
+    const uint64_t oldest = GetOldestSequence();
+    if (!IsCurrentGeneration()) {
+      return appended;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      if (sequence + i >= oldest) {
+        vertical_range_.Push(batch[i]);
+        last_point_ = batch[i];
+      }
+    }
+    sequence += count;
+  }
+
+  // Evict the overwritten points. The x of the oldest point is read again
+  // until it wasn't overwritten while it was read.
+  uint64_t first = first_;
+  double first_x;
+  do {
+    first = std::min(std::max(first, GetOldestSequence()), end);
+    first_x = slots_[first % capacity_].x.load(std::memory_order_relaxed);
+  } while (first < end && GetOldestSequence() > first);
+  if (!IsCurrentGeneration()) {
+    return appended;
+  }
+
+  if (first > first_) {
+    appended = false;
+  }
+  first_ = first;
+  end_ = end;
+  first_x_ = first_x;
+  if (size() != 0) {
+    vertical_range_.Slide(first_x_, last_point_.x);
+  }
+  return appended;
+}
+
+bool SharedMemoryDataSource::IsCurrentGeneration() const {
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return header_->generation.load(std::memory_order_relaxed) == generation_;
+}
+
+uint64_t SharedMemoryDataSource::GetOldestSequence() const {
+  // Orders the preceding slot reads before the counter read.
+  std::atomic_thread_fence(std::memory_order_acquire);
+  const uint64_t begin = header_->begin_count.load(std::memory_order_relaxed);
+  return begin > start_ + capacity_ ? begin - capacity_ : start_;
+}
+
+double SharedMemoryDataSource::GetCurrentValue() const {
+  return size() == 0 ? kGraphUnknownValue : last_point_.y;
+}
+
+std::unique_ptr<PointEnumerator> SharedMemoryDataSource::EnumPoints(
+    double from,
+    double to,
+    bool include_left_bound,
+    bool include_right_bound) {
+  if (size() == 0) {
+    return nullptr;
+  }
+
+  uint64_t first = FindBound(from, !include_left_bound);
+  uint64_t last = FindBound(to, include_right_bound);
+  if (first >= last) {
+    return nullptr;
+  }
+  return std::make_unique<SlotPointEnumerator>(*this, first, last);
+}
+
+uint64_t SharedMemoryDataSource::FindBound(double value, bool upper) const {
+  // Slots overwritten during the search are newer points with larger x, so
+  // the search ends past them at worst, and the enumerator skips them.
+  uint64_t first = std::max(first_, GetOldestSequence());
+  uint64_t count = end_ - std::min(first, end_);
+  while (count > 0) {
+    uint64_t half = count / 2;
+    double x = slots_[(first + half) % capacity_].x.load(
+        std::memory_order_relaxed);
+    if (upper ? x <= value : x < value) {
+      first += half + 1;
+      count -= half + 1;
+    } else {
+      count = half;
+    }
+  }
+  return first;
+}
+
+GraphRange SharedMemoryDataSource::GetHorizontalRange() const {
+  if (size() == 0) {
+    return GraphRange{};
+  }
+  return GraphRange{first_x_, last_point_.x, horizontal_kind_};
+}
+
+GraphRange SharedMemoryDataSource::GetVerticalRange() const {
+  return vertical_range_.GetRange();
+}
+
+}  // namespace views
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "graph_qt/model/graph_data_source.h"
+#include "graph_qt/model/shared_point_ring.h"
+#include "graph_qt/model/sliding_window_range.h"
+
+#include <QString>
+#include <cstdint>
+
+namespace views {
+
+// Data source over a shared point ring (see `SharedPointRingHeader`) written
+// by a `SharedPointWriter` in another process. Any number of sources can read
+// the same ring.
+//
+// Enumerators read the points straight from the shared memory. The source
+// sees new points only on `Poll()`, usually called once per frame, which
+// sends the observer notifications if there are new points. Points
+// overwritten by the writer while an enumerator is reading them are skipped,
+// so `GetCount()` of the enumerators is an upper bound.
+//
+// When the writer closes the ring, or the name refers to the segment of
+// another writer, the source attaches to the new ring on the next poll. The
+// check opens the segment by name, so it is done only when the ring has
+// nothing new.
+class SharedMemoryDataSource : public GraphDataSource {
+ public:
+  explicit SharedMemoryDataSource(
+      const QString& key,
+      GraphRange::Kind horizontal_kind = GraphRange::LINEAR);
+  ~SharedMemoryDataSource() override;
+
+  bool is_attached() const { return header_ != nullptr; }
+
+  // Number of points in the ring as of the last poll.
+  size_t size() const { return end_ - first_; }
+
+  // Maps the ring created by the writer read-only. Returns false, keeping the
+  // current ring, if the ring doesn't exist or isn't initialized yet.
+  bool Attach();
+
+  void Detach();
+
+  // Picks up the points written since the last poll. Returns true and sends
+  // `OnDataSourcePointsAppended()`, or `OnDataSourceHistoryChanged()` if
+  // points were overwritten or the source attached to a new ring, if there
+  // are new points.
+  bool Poll();
+
+  // GraphDataSource
+  double GetCurrentValue() const override;
+  std::unique_ptr<PointEnumerator> EnumPoints(
+      double from,
+      double to,
+      bool include_left_bound,
+      bool include_right_bound) override;
+  GraphRange GetHorizontalRange() const override;
+  GraphRange GetVerticalRange() const override;
+
+ private:
+  class SlotPointEnumerator;
+
+  void Reset();
+
+  // Reads the layout of the current generation of the ring. Leaves the
+  // capacity zero if the writer is changing it.
+  void ReadLayout();
+
+  // Reads the points written since the last poll. Returns false if points
+  // were overwritten or the writer restarted.
+  bool ReadNewPoints();
+
+  // Returns true if the ring is still of the generation of the polled points.
+  // Orders the preceding slot reads before the check.
+  bool IsCurrentGeneration() const;
+
+  // Returns the sequence number of the oldest point not overwritten yet.
+  uint64_t GetOldestSequence() const;
+
+  // Returns the first sequence of the polled points with `x >= value`, or
+  // with `x > value` if `upper`.
+  uint64_t FindBound(double value, bool upper) const;
+
+  const QString key_;
+  const GraphRange::Kind horizontal_kind_;
+
+  SharedMemorySegment memory_;
+  const SharedPointRingHeader* header_ = nullptr;
+  const SharedPointSlot* slots_ = nullptr;
+
+  // Generation of the ring the polled points come from, and its layout.
+  uint64_t generation_ = 0;
+  uint64_t capacity_ = 0;
+  uint64_t start_ = 0;
+
+  // Sequence numbers of the polled points.
+  uint64_t first_ = 0;
+  uint64_t end_ = 0;
+
+  double first_x_ = 0;
+  GraphPoint last_point_;
+  SlidingWindowRange vertical_range_;
+};
+
+}  // namespace views
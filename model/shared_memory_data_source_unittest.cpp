@@ -0,0 +1,272 @@
+#include "graph_qt/model/shared_memory_data_source.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace views {
+
+namespace {
+
+class CountingObserver : public GraphDataSource::Observer {
+ public:
+  void OnDataSourceHistoryChanged() override { ++history_changed_count; }
+  void OnDataSourcePointsAppended() override { ++points_appended_count; }
+
+  int history_changed_count = 0;
+  int points_appended_count = 0;
+};
+
+std::vector<GraphPoint> EnumAllPoints(
+    std::unique_ptr<PointEnumerator> point_enum) {
+  std::vector<GraphPoint> points;
+  if (point_enum) {
+    ForEachPoint(*point_enum,
+                 [&](const GraphPoint& point) { points.push_back(point); });
+  }
+  return points;
+}
+
+std::vector<GraphPoint> MakePoints(int first, int last) {
+  std::vector<GraphPoint> points;
+  for (int i = first; i < last; ++i) {
+    auto& point =
+        points.emplace_back(static_cast<double>(i), static_cast<double>(i % 7));
+    point.good = i % 3 != 0;
+  }
+  return points;
+}
+
+// A key no other test run uses.
+QString MakeKey() {
+  return "graph_qt_test_" +
+         QString::number(static_cast<unsigned long long>(
+             std::chrono::steady_clock::now().time_since_epoch().count()));
+}
+
+}  // namespace
+
+TEST(SharedMemoryDataSourceTest, PollsNewPoints) {
+  const QString key = MakeKey();
+  SharedPointWriter writer{key};
+  ASSERT_TRUE(writer.Create(100));
+
+  SharedMemoryDataSource data_source{key};
+  ASSERT_TRUE(data_source.Attach());
+  CountingObserver observer;
+  data_source.SetObserver(&observer);
+  EXPECT_EQ(data_source.size(), 0u);
+  EXPECT_FALSE(data_source.Poll());
+
+  const auto points = MakePoints(0, 50);
+  writer.AddPoints(points);
+  // The source sees the points only on polling.
+  EXPECT_EQ(data_source.size(), 0u);
+  EXPECT_TRUE(data_source.Poll());
+  EXPECT_FALSE(data_source.Poll());
+  EXPECT_EQ(observer.points_appended_count, 1);
+
+  EXPECT_EQ(data_source.size(), 50u);
+  EXPECT_EQ(data_source.GetHorizontalRange(), GraphRange(0, 49));
+  EXPECT_EQ(data_source.GetVerticalRange(), GraphRange(0, 6));
+  EXPECT_EQ(data_source.GetCurrentValue(), 49 % 7);
+  EXPECT_EQ(EnumAllPoints(data_source.EnumPoints(0, 49, true, true)), points);
+  EXPECT_EQ(EnumAllPoints(data_source.EnumPoints(10, 20, false, false)),
+            MakePoints(11, 20));
+  EXPECT_FALSE(data_source.EnumPoints(60, 70, true, true));
+
+  data_source.SetObserver(nullptr);
+}
+
+TEST(SharedMemoryDataSourceTest, OverwritesOldestPoints) {
+  const QString key = MakeKey();
+  SharedPointWriter writer{key};
+  ASSERT_TRUE(writer.Create(100));
+  SharedMemoryDataSource data_source{key};
+  ASSERT_TRUE(data_source.Attach());
+  CountingObserver observer;
+  data_source.SetObserver(&observer);
+
+  writer.AddPoints(MakePoints(0, 90));
+  data_source.Poll();
+  writer.AddPoints(MakePoints(90, 250));
+  data_source.Poll();
+
+  EXPECT_EQ(observer.points_appended_count, 1);
+  EXPECT_EQ(observer.history_changed_count, 1);
+  EXPECT_EQ(data_source.size(), 100u);
+  EXPECT_EQ(data_source.GetHorizontalRange(), GraphRange(150, 249));
+  EXPECT_EQ(EnumAllPoints(data_source.EnumPoints(0, 300, true, true)),
+            MakePoints(150, 250));
+
+  // Points overwritten after the poll are skipped.
+  writer.AddPoints(MakePoints(250, 270));
+  EXPECT_EQ(EnumAllPoints(data_source.EnumPoints(0, 249, true, true)),
+            MakePoints(170, 250));
+
+  data_source.SetObserver(nullptr);
+}
+
+TEST(SharedMemoryDataSourceTest, LiveRingIsNotTakenOver) {
+  const QString key = MakeKey();
+  SharedPointWriter writer{key};
+  ASSERT_TRUE(writer.Create(100));
+  writer.AddPoints(MakePoints(0, 10));
+
+  SharedPointWriter second_writer{key};
+  EXPECT_FALSE(second_writer.Create(100));
+
+  SharedMemoryDataSource data_source{key};
+  ASSERT_TRUE(data_source.Attach());
+  EXPECT_FALSE(data_source.Poll());
+  EXPECT_EQ(EnumAllPoints(data_source.EnumPoints(0, 100, true, true)),
+            MakePoints(0, 10));
+}
+
+TEST(SharedMemoryDataSourceTest, ClosedWriter) {
+  const QString key = MakeKey();
+  auto writer = std::make_unique<SharedPointWriter>(key);
+  ASSERT_TRUE(writer->Create(100));
+  writer->AddPoints(MakePoints(0, 50));
+
+  SharedMemoryDataSource data_source{key};
+  ASSERT_TRUE(data_source.Attach());
+  CountingObserver observer;
+  data_source.SetObserver(&observer);
+
+  // The source keeps the points of a closed ring until a new writer starts.
+  writer.reset();
+  EXPECT_FALSE(data_source.Poll());
+  EXPECT_EQ(data_source.size(), 50u);
+
+  SharedPointWriter new_writer{key};
+  ASSERT_TRUE(new_writer.Create(100));
+  new_writer.AddPoints(MakePoints(100, 110));
+  EXPECT_TRUE(data_source.Poll());
+
+  EXPECT_EQ(observer.history_changed_count, 1);
+  EXPECT_EQ(data_source.size(), 10u);
+  EXPECT_EQ(EnumAllPoints(data_source.EnumPoints(0, 200, true, true)),
+            MakePoints(100, 110));
+
+  new_writer.AddPoints(MakePoints(110, 120));
+  EXPECT_TRUE(data_source.Poll());
+  EXPECT_EQ(observer.points_appended_count, 1);
+  EXPECT_EQ(data_source.size(), 20u);
+
+  data_source.SetObserver(nullptr);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST(SharedMemoryDataSourceTest, RestartedWriter) {
+  const QString key = MakeKey();
+
+  // A writer process crashes, leaving its ring behind.
+  pid_t pid = fork();
+  ASSERT_NE(pid, -1);
+  if (pid == 0) {
+    SharedPointWriter writer{key};
+    bool created = writer.Create(100);
+    writer.AddPoints(MakePoints(0, 10));
+    _exit(created ? 0 : 1);
+  }
+  int status = 0;
+  ASSERT_EQ(waitpid(pid, &status, 0), pid);
+  ASSERT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+  SharedMemoryDataSource data_source{key};
+  ASSERT_TRUE(data_source.Attach());
+  CountingObserver observer;
+  data_source.SetObserver(&observer);
+  EXPECT_EQ(data_source.size(), 10u);
+
+  // The restarted writer reuses the ring, and writes more points than the
+  // source has seen before the next poll.
+  SharedPointWriter restarted_writer{key};
+  ASSERT_TRUE(restarted_writer.Create(50));
+  restarted_writer.AddPoints(MakePoints(100, 120));
+  EXPECT_TRUE(data_source.Poll());
+
+  EXPECT_EQ(observer.history_changed_count, 1);
+  EXPECT_EQ(data_source.size(), 20u);
+  EXPECT_EQ(data_source.GetHorizontalRange(), GraphRange(100, 119));
+  EXPECT_EQ(EnumAllPoints(data_source.EnumPoints(0, 200, true, true)),
+            MakePoints(100, 120));
+
+  // The smaller capacity applies to the reused ring.
+  restarted_writer.AddPoints(MakePoints(120, 200));
+  EXPECT_TRUE(data_source.Poll());
+  EXPECT_EQ(EnumAllPoints(data_source.EnumPoints(0, 200, true, true)),
+            MakePoints(150, 200));
+
+  data_source.SetObserver(nullptr);
+}
+#endif
+
+TEST(SharedMemoryDataSourceTest, SeveralReaders) {
+  const QString key = MakeKey();
+  SharedMemoryDataSource data_source1{key};
+  EXPECT_FALSE(data_source1.Attach());
+
+  SharedPointWriter writer{key};
+  ASSERT_TRUE(writer.Create(100));
+  writer.AddPoints(MakePoints(0, 10));
+
+  SharedMemoryDataSource data_source2{key};
+  ASSERT_TRUE(data_source1.Attach());
+  ASSERT_TRUE(data_source2.Attach());
+  EXPECT_EQ(data_source1.size(), 10u);
+  EXPECT_EQ(data_source2.size(), 10u);
+
+  writer.AddPoints(MakePoints(10, 20));
+  EXPECT_TRUE(data_source1.Poll());
+  EXPECT_TRUE(data_source2.Poll());
+  EXPECT_EQ(EnumAllPoints(data_source1.EnumPoints(0, 19, true, true)),
+            MakePoints(0, 20));
+  EXPECT_EQ(EnumAllPoints(data_source2.EnumPoints(0, 19, true, true)),
+            MakePoints(0, 20));
+}
+
+TEST(SharedMemoryDataSourceTest, ConcurrentWriter) {
+  const QString key = MakeKey();
+  SharedPointWriter writer{key};
+  ASSERT_TRUE(writer.Create(64));
+  SharedMemoryDataSource data_source{key};
+  ASSERT_TRUE(data_source.Attach());
+
+  std::atomic<bool> done = false;
+  std::thread writer_thread{[&] {
+    for (int i = 0; i < 200000; i += 10) {
+      writer.AddPoints(MakePoints(i, i + 10));
+    }
+    done = true;
+  }};
+
+  // Every enumerated point must be intact and in order.
+  while (!done) {
+    data_source.Poll();
+    auto points = EnumAllPoints(data_source.EnumPoints(0, 1e9, true, true));
+    EXPECT_TRUE(std::ranges::is_sorted(points, {}, &GraphPoint::x));
+    for (const auto& point : points) {
+      int i = static_cast<int>(point.x);
+      ASSERT_EQ(point.y, i % 7);
+      ASSERT_EQ(point.good, i % 3 != 0);
+    }
+  }
+  writer_thread.join();
+
+  data_source.Poll();
+  EXPECT_EQ(data_source.GetHorizontalRange(), GraphRange(199936, 199999));
+}
+
+}  // namespace views
@@ -0,0 +1,264 @@
+#include "graph_qt/model/shared_point_ring.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <limits>
+#endif
+
+namespace views {
+
+namespace {
+
+#if defined(__unix__) || defined(__APPLE__)
+bool IsProcessAlive(uint64_t pid) {
+  if (pid == 0 || pid > std::numeric_limits<pid_t>::max()) {
+    return false;
+  }
+  return kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+}
+#endif
+
+// Makes the calling process the owner of the ring, unless a writer that is
+// still running owns it.
+bool ClaimRing(SharedPointRingHeader& header) {
+#if defined(__unix__) || defined(__APPLE__)
+  uint64_t owner = header.owner.load(std::memory_order_acquire);
+  if (IsProcessAlive(owner)) {
+    return false;
+  }
+  return header.owner.compare_exchange_strong(
+      owner, static_cast<uint64_t>(getpid()), std::memory_order_acq_rel);
+#else
+  return false;
+#endif
+}
+
+}  // namespace
+
+SharedMemorySegment::SharedMemorySegment(const QString& key)
+    : name_{"/" + key.toStdString()} {}
+
+SharedMemorySegment::~SharedMemorySegment() {
+  Close();
+}
+
+SharedMemorySegment::SharedMemorySegment(SharedMemorySegment&& other) noexcept
+    : name_{std::move(other.name_)},
+      data_{std::exchange(other.data_, nullptr)},
+      size_{std::exchange(other.size_, 0)},
+      device_{other.device_},
+      inode_{other.inode_} {}
+
+SharedMemorySegment& SharedMemorySegment::operator=(
+    SharedMemorySegment&& other) noexcept {
+  if (this != &other) {
+    Close();
+    name_ = std::move(other.name_);
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    device_ = other.device_;
+    inode_ = other.inode_;
+  }
+  return *this;
+}
+
+bool SharedMemorySegment::Create(size_t size) {
+  Close();
+#if defined(__unix__) || defined(__APPLE__)
+  int fd = shm_open(name_.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd == -1) {
+    return false;
+  }
+  // A segment left behind by a crashed writer is reused. It's never resized,
+  // as readers may still map it.
+  struct stat status;
+  bool result = fstat(fd, &status) == 0 &&
+                (status.st_size == 0
+                     ? ftruncate(fd, static_cast<off_t>(size)) == 0
+                     : static_cast<size_t>(status.st_size) >= size) &&
+                Map(fd, true);
+  close(fd);
+  return result;
+#else
+  return false;
+#endif
+}
+
+bool SharedMemorySegment::Open() {
+  Close();
+#if defined(__unix__) || defined(__APPLE__)
+  int fd = shm_open(name_.c_str(), O_RDONLY, 0);
+  if (fd == -1) {
+    return false;
+  }
+  bool result = Map(fd, false);
+  close(fd);
+  return result;
+#else
+  return false;
+#endif
+}
+
+bool SharedMemorySegment::Map(int fd, bool writable) {
+#if defined(__unix__) || defined(__APPLE__)
+  struct stat status;
+  if (fstat(fd, &status) != 0 || status.st_size <= 0) {
+    return false;
+  }
+  const auto size = static_cast<size_t>(status.st_size);
+  const int protection = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+  void* data = mmap(nullptr, size, protection, MAP_SHARED, fd, 0);
+  if (data == MAP_FAILED) {
+    return false;
+  }
+  data_ = data;
+  size_ = size;
+  device_ = static_cast<uint64_t>(status.st_dev);
+  inode_ = static_cast<uint64_t>(status.st_ino);
+  return true;
+#else
+  return false;
+#endif
+}
+
+void SharedMemorySegment::Close() {
+#if defined(__unix__) || defined(__APPLE__)
+  if (data_) {
+    munmap(data_, size_);
+  }
+#endif
+  data_ = nullptr;
+  size_ = 0;
+}
+
+void SharedMemorySegment::Unlink() {
+#if defined(__unix__) || defined(__APPLE__)
+  shm_unlink(name_.c_str());
+#endif
+}
+
+bool SharedMemorySegment::IsReplaced() const {
+#if defined(__unix__) || defined(__APPLE__)
+  int fd = shm_open(name_.c_str(), O_RDONLY, 0);
+  if (fd == -1) {
+    return false;
+  }
+  struct stat status;
+  bool result = fstat(fd, &status) == 0 &&
+                (static_cast<uint64_t>(status.st_dev) != device_ ||
+                 static_cast<uint64_t>(status.st_ino) != inode_);
+  close(fd);
+  return result;
+#else
+  return false;
+#endif
+}
+
+SharedPointWriter::SharedPointWriter(const QString& key) : memory_{key} {}
+
+SharedPointWriter::~SharedPointWriter() {
+  if (header_) {
+    // Attached readers see the ring closed and look for the next one.
+    header_->owner.store(0, std::memory_order_release);
+    memory_.Unlink();
+  }
+}
+
+bool SharedPointWriter::Create(size_t capacity) {
+  assert(!header_);
+  assert(capacity > 0);
+
+  const size_t size =
+      sizeof(SharedPointRingHeader) + capacity * sizeof(SharedPointSlot);
+  if (!memory_.Create(size)) {
+    return false;
+  }
+
+  auto* header = static_cast<SharedPointRingHeader*>(memory_.data());
+  if (!ClaimRing(*header)) {
+    memory_.Close();
+    return false;
+  }
+
+  header_ = header;
+  slots_ = reinterpret_cast<SharedPointSlot*>(header_ + 1);
+  capacity_ = capacity;
+
+  // Readers ignore a ring of another layout until the magic is set.
+  if (header_->magic.load(std::memory_order_relaxed) !=
+          SharedPointRingHeader::kMagic ||
+      header_->version.load(std::memory_order_relaxed) !=
+          SharedPointRingHeader::kVersion) {
+    header_->magic.store(0, std::memory_order_relaxed);
+    header_->version.store(SharedPointRingHeader::kVersion,
+                           std::memory_order_relaxed);
+    header_->generation.store(0, std::memory_order_relaxed);
+    header_->begin_count.store(0, std::memory_order_relaxed);
+    header_->end_count.store(0, std::memory_order_relaxed);
+  }
+
+  // Readers still attached to a reused ring see an odd generation while the
+  // layout changes, and start over from the new generation. A crashed writer
+  // may have stopped in the middle of `AddPoints()`, so the new points start
+  // after all the sequence numbers it took.
+  const uint64_t generation =
+      header_->generation.load(std::memory_order_relaxed) | 1;
+  header_->generation.store(generation, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  const uint64_t start =
+      std::max(header_->begin_count.load(std::memory_order_relaxed),
+               header_->end_count.load(std::memory_order_relaxed));
+  header_->capacity.store(capacity, std::memory_order_relaxed);
+  header_->start_count.store(start, std::memory_order_relaxed);
+  header_->begin_count.store(start, std::memory_order_relaxed);
+  header_->end_count.store(start, std::memory_order_relaxed);
+  header_->generation.store(generation + 1, std::memory_order_release);
+  header_->magic.store(SharedPointRingHeader::kMagic,
+                       std::memory_order_release);
+  return true;
+}
+
+void SharedPointWriter::AddPoint(const GraphPoint& point) {
+  AddPoints(std::span{&point, 1});
+}
+
+void SharedPointWriter::AddPoints(std::span<const GraphPoint> points) {
+  assert(header_);
+  if (points.empty()) {
+    return;
+  }
+
+  // Only the last `capacity` points would survive.
+  const uint64_t capacity = capacity_;
+  uint64_t sequence = header_->end_count.load(std::memory_order_relaxed);
+  const uint64_t end = sequence + points.size();
+  if (points.size() > capacity) {
+    sequence += points.size() - capacity;
+    points = points.last(capacity);
+  }
+
+  // Readers seeing an overwritten slot see the new `begin_count` too.
+  header_->begin_count.store(end, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  for (const auto& point : points) {
+    auto& slot = slots_[sequence++ % capacity];
+    slot.x.store(point.x, std::memory_order_relaxed);
+    slot.y.store(point.y, std::memory_order_relaxed);
+    slot.good.store(point.good, std::memory_order_relaxed);
+  }
+
+  header_->end_count.store(end, std::memory_order_release);
+}
+
+}  // namespace views
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "graph_qt/model/graph_types.h"
+
+#include <QString>
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace views {
+
+// Layout of a ring of points in shared memory, written by a single
+// `SharedPointWriter` and read by any number of `SharedMemoryDataSource`s in
+// other processes: a `SharedPointRingHeader` followed by `capacity` slots.
+//
+// The point with sequence number `s` is stored in slot `s % capacity`. The
+// counters work as a seqlock: the writer advances `begin_count` before it
+// overwrites slots, and `end_count` after. A reader reads slots below
+// `end_count`, and then drops the ones below `begin_count - capacity`, which
+// may have been overwritten while it was reading. Neither side takes locks or
+// makes system calls.
+//
+// `generation` is a seqlock over the layout: it is odd while a writer
+// (re)initializes the ring, and advances every time one does. Readers check it
+// around every batch of slots they read, so they drop the points of a ring
+// reused by a restarted writer. The counters go on from the previous writer's
+// and never go back; the points of a generation start at `start_count`.
+//
+// `owner` is the process ID of the writer, so that a second writer can't take
+// over a live ring. The writer clears it when it closes the ring.
+struct SharedPointRingHeader {
+  static constexpr uint32_t kMagic = 0x52515147;  // "GQQR"
+  static constexpr uint32_t kVersion = 3;
+
+  // Set last when the ring is initialized.
+  std::atomic<uint32_t> magic;
+  std::atomic<uint32_t> version;
+  std::atomic<uint64_t> owner;
+  std::atomic<uint64_t> generation;
+  std::atomic<uint64_t> capacity;
+  std::atomic<uint64_t> start_count;
+
+  // Counters of written points, on their own cache lines.
+  alignas(64) std::atomic<uint64_t> begin_count;
+  alignas(64) std::atomic<uint64_t> end_count;
+};
+
+struct SharedPointSlot {
+  std::atomic<double> x;
+  std::atomic<double> y;
+  std::atomic<uint64_t> good;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free &&
+                  std::atomic<double>::is_always_lock_free,
+              "Atomics in shared memory must be lock-free");
+
+// POSIX shared memory object mapped with `shm_open()` and `mmap()`. The object
+// for `key` is named "/<key>", so producers not using this library can open
+// it too. Fails to create or open objects on platforms without POSIX shared
+// memory.
+class SharedMemorySegment {
+ public:
+  explicit SharedMemorySegment(const QString& key);
+  ~SharedMemorySegment();
+
+  SharedMemorySegment(SharedMemorySegment&& other) noexcept;
+  SharedMemorySegment& operator=(SharedMemorySegment&& other) noexcept;
+
+  void* data() const { return data_; }
+  size_t size() const { return size_; }
+
+  // Creates the object with `size` bytes, or reuses an existing one at least
+  // that large, and maps it for reading and writing.
+  bool Create(size_t size);
+
+  // Maps the existing object read-only.
+  bool Open();
+
+  // Unmaps the object. Doesn't remove it.
+  void Close();
+
+  // Removes the object name. Existing mappings stay valid.
+  void Unlink();
+
+  // Returns true if the name now refers to another object than the mapped
+  // one, e.g. one created after the mapped one was unlinked. Makes system
+  // calls.
+  bool IsReplaced() const;
+
+ private:
+  bool Map(int fd, bool writable);
+
+  std::string name_;
+  void* data_ = nullptr;
+  size_t size_ = 0;
+  uint64_t device_ = 0;
+  uint64_t inode_ = 0;
+};
+
+// Producer side of a shared point ring. Creates the shared memory segment
+// for `key` and appends points to it. When the writer is destroyed, it closes
+// the ring and unlinks the segment; readers attached to it keep their mapping
+// and switch to the segment of the next writer.
+class SharedPointWriter {
+ public:
+  explicit SharedPointWriter(const QString& key);
+  ~SharedPointWriter();
+
+  SharedPointWriter(const SharedPointWriter&) = delete;
+  SharedPointWriter& operator=(const SharedPointWriter&) = delete;
+
+  size_t capacity() const { return capacity_; }
+
+  // Creates the ring with room for `capacity` points. A segment left behind
+  // by a crashed writer is reused. Returns false if the segment can't be
+  // created, or if it is owned by a writer that is still running.
+  bool Create(size_t capacity);
+
+  // Appends points, overwriting the oldest ones. The points must be sorted by
+  // x, and the first one must not precede the last written point. Doesn't
+  // allocate or make system calls.
+  void AddPoint(const GraphPoint& point);
+  void AddPoints(std::span<const GraphPoint> points);
+
+ private:
+  SharedMemorySegment memory_;
+  SharedPointRingHeader* header_ = nullptr;
+  SharedPointSlot* slots_ = nullptr;
+  uint64_t capacity_ = 0;
+};
+
+}  // namespace views
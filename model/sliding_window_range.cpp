@@ -0,0 +1,46 @@
+#include "graph_qt/model/sliding_window_range.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace views {
+
+void SlidingWindowRange::Push(const GraphPoint& point) {
+  assert(point.x >= last_x_.value_or(from_));
+  last_x_count_ = last_x_ == point.x ? last_x_count_ + 1 : 1;
+  last_x_ = point.x;
+
+  while (!min_points_.empty() && min_points_.back().y >= point.y) {
+    min_points_.pop_back();
+  }
+  min_points_.push_back(point);
+
+  while (!max_points_.empty() && max_points_.back().y <= point.y) {
+    max_points_.pop_back();
+  }
+  max_points_.push_back(point);
+}
+
+void SlidingWindowRange::Slide(double from, double to) {
+  assert(from >= from_);
+  assert(to >= to_);
+
+  from_ = from;
+  to_ = to;
+
+  while (!min_points_.empty() && min_points_.front().x < from) {
+    min_points_.pop_front();
+  }
+  while (!max_points_.empty() && max_points_.front().x < from) {
+    max_points_.pop_front();
+  }
+}
+
+GraphRange SlidingWindowRange::GetRange() const {
+  if (min_points_.empty()) {
+    return GraphRange{};
+  }
+  return GraphRange{min_points_.front().y, max_points_.front().y};
+}
+
+}  // namespace views
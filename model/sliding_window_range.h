@@ -0,0 +1,51 @@
+#pragma once
+
+#include "graph_qt/model/graph_range.h"
+#include "graph_qt/model/graph_types.h"
+
+#include <deque>
+#include <optional>
+
+namespace views {
+
+// Value range of the points in a window `[from, to)` that only moves forward.
+// Keeps monotonic deques of the candidate extremes, so pushing a point and
+// evicting the points falling out of the window take amortized O(1).
+class SlidingWindowRange {
+ public:
+  // Creates an empty window `[x, x)`.
+  explicit SlidingWindowRange(double x) : from_{x}, to_{x} {}
+
+  double from() const { return from_; }
+  double to() const { return to_; }
+
+  // X of the last pushed point, or nothing if no points were pushed, and the
+  // number of pushed points with that x. Lets callers resume pushing right
+  // after them, as points may be pushed before they enter the window.
+  std::optional<double> last_x() const { return last_x_; }
+  size_t last_x_count() const { return last_x_count_; }
+
+  // Adds a point to the window. Points must be pushed in x order, starting at
+  // `from()`.
+  void Push(const GraphPoint& point);
+
+  // Moves the bounds forward to `[from, to)`, evicting the points before
+  // `from`.
+  void Slide(double from, double to);
+
+  // Returns an empty range if the window has no points.
+  GraphRange GetRange() const;
+
+ private:
+  double from_;
+  double to_;
+  std::optional<double> last_x_;
+  size_t last_x_count_ = 0;
+
+  // Points with increasing values, the minimum at the front.
+  std::deque<GraphPoint> min_points_;
+  // Points with decreasing values, the maximum at the front.
+  std::deque<GraphPoint> max_points_;
+};
+
+}  // namespace views
@@ -0,0 +1,68 @@
+#include "graph_qt/model/sliding_window_range.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace views {
+
+TEST(SlidingWindowRangeTest, Empty) {
+  SlidingWindowRange window{10};
+  EXPECT_EQ(window.GetRange(), GraphRange());
+
+  window.Push({10, 5});
+  window.Slide(11, 20);
+  EXPECT_EQ(window.GetRange(), GraphRange());
+}
+
+TEST(SlidingWindowRangeTest, LastX) {
+  SlidingWindowRange window{0};
+  EXPECT_FALSE(window.last_x());
+
+  window.Push({1, 1});
+  window.Push({2, 2});
+  window.Push({2, 3});
+  EXPECT_EQ(window.last_x(), 2);
+  EXPECT_EQ(window.last_x_count(), 2u);
+
+  window.Push({3, 3});
+  EXPECT_EQ(window.last_x(), 3);
+  EXPECT_EQ(window.last_x_count(), 1u);
+}
+
+TEST(SlidingWindowRangeTest, MatchesBruteForce) {
+  std::mt19937 generator{42};
+  std::uniform_int_distribution<int> value_distribution{-100, 100};
+  std::uniform_int_distribution<int> step_distribution{0, 20};
+
+  std::vector<GraphPoint> points;
+  for (int i = 0; i < 5000; ++i) {
+    points.emplace_back(i, value_distribution(generator));
+  }
+
+  const double kWidth = 200;
+  SlidingWindowRange window{0};
+  size_t next_index = 0;
+  for (double to = 1; to < points.size(); to += step_distribution(generator)) {
+    double from = std::max(0.0, to - kWidth);
+    for (; next_index < to; ++next_index) {
+      window.Push(points[next_index]);
+    }
+    window.Slide(from, to);
+
+    double low = std::numeric_limits<double>::max();
+    double high = std::numeric_limits<double>::lowest();
+    for (const auto& point : points) {
+      if (point.x >= from && point.x < to) {
+        low = std::min(low, point.y);
+        high = std::max(high, point.y);
+      }
+    }
+    EXPECT_EQ(window.GetRange(), GraphRange(low, high)) << to;
+  }
+}
+
+}  // namespace views
@@ -0,0 +1,187 @@
+#include "graph_qt/model/snapshot_data_source.h"
+
+#include <algorithm>
+#include <cassert>
+#include <ranges>
+
+namespace views {
+
+namespace {
+
+// Chunk capacity of the first chunk table.
+constexpr size_t kInitialTableCapacity = 16;
+
+// Enumerates a range of a generation, keeping the generation alive.
+class SnapshotPointEnumerator : public PointEnumerator {
+ public:
+  using Snapshot = SnapshotDataSource::Snapshot;
+
+  SnapshotPointEnumerator(std::shared_ptr<const Snapshot> snapshot,
+                          size_t first,
+                          size_t last)
+      : snapshot_{std::move(snapshot)}, index_{first}, last_{last} {}
+
+  size_t GetCount() const override { return last_ - index_; }
+
+  bool EnumNext(GraphPoint& value) override {
+    if (index_ >= last_) {
+      return false;
+    }
+    value = snapshot_->at(index_++);
+    return true;
+  }
+
+  size_t EnumNextBatch(std::span<GraphPoint> points) override {
+    // Copies at most up to the end of the current chunk.
+    auto chunk_points = snapshot_->GetChunkPoints(index_);
+    size_t count =
+        std::min({points.size(), chunk_points.size(), last_ - index_});
+    std::copy_n(chunk_points.begin(), count, points.begin());
+    index_ += count;
+    return count;
+  }
+
+ private:
+  const std::shared_ptr<const Snapshot> snapshot_;
+  size_t index_;
+  const size_t last_;
+};
+
+size_t FindLowerBound(const SnapshotDataSource::Snapshot& snapshot,
+                      double value) {
+  auto indexes = std::views::iota(size_t{0}, snapshot.size);
+  auto get_x = [&snapshot](size_t index) { return snapshot.at(index).x; };
+  return std::ranges::lower_bound(indexes, value, {}, get_x) - indexes.begin();
+}
+
+size_t FindUpperBound(const SnapshotDataSource::Snapshot& snapshot,
+                      double value) {
+  auto indexes = std::views::iota(size_t{0}, snapshot.size);
+  auto get_x = [&snapshot](size_t index) { return snapshot.at(index).x; };
+  return std::ranges::upper_bound(indexes, value, {}, get_x) - indexes.begin();
+}
+
+}  // namespace
+
+std::span<const GraphPoint> SnapshotDataSource::Snapshot::GetChunkPoints(
+    size_t index) const {
+  if (index >= size) {
+    return {};
+  }
+  size_t chunk_first = index / kChunkSize * kChunkSize;
+  size_t chunk_last = std::min(chunk_first + kChunkSize, size);
+  return std::span{table->chunks[index / kChunkSize]->points}.subspan(
+      index - chunk_first, chunk_last - index);
+}
+
+SnapshotDataSource::SnapshotDataSource(GraphRange::Kind horizontal_kind)
+    : horizontal_kind_{horizontal_kind},
+      snapshot_{std::make_shared<const Snapshot>()} {}
+
+SnapshotDataSource::~SnapshotDataSource() = default;
+
+void SnapshotDataSource::AddPoints(std::span<const GraphPoint> points) {
+  if (points.empty()) {
+    return;
+  }
+
+  auto current = GetSnapshot();
+  assert(current->size == 0 ||
+         points.front().x >= current->at(current->size - 1).x);
+
+  // Readers of the current generation never look past its size, so the tail
+  // of its last chunk and the free slots of the table are written in place.
+  auto next = std::make_shared<Snapshot>(*current);
+  for (const auto& point : points) {
+    const size_t chunk_index = next->size / kChunkSize;
+    if (next->size % kChunkSize == 0) {
+      if (!table_ || chunk_index == table_->capacity) {
+        auto table = std::make_shared<ChunkTable>(
+            table_ ? table_->capacity * 2 : kInitialTableCapacity);
+        if (table_) {
+          std::copy_n(table_->chunks.get(), table_->capacity,
+                      table->chunks.get());
+        }
+        table_ = std::move(table);
+      }
+      table_->chunks[chunk_index] = std::make_shared<Chunk>();
+    }
+    table_->chunks[chunk_index]->points[next->size % kChunkSize] = point;
+
+    next->vertical_range =
+        next->size == 0
+            ? GraphRange{point.y, point.y}
+            : GraphRange{std::min(next->vertical_range.low(), point.y),
+                         std::max(next->vertical_range.high(), point.y)};
+    ++next->size;
+  }
+  next->table = table_;
+  ++next->generation;
+
+  // The previous generation is released after the exchange.
+  auto previous =
+      snapshot_.exchange(std::move(next), std::memory_order_acq_rel);
+}
+
+void SnapshotDataSource::NotifyObserver() {
+  auto snapshot = GetSnapshot();
+  if (snapshot->generation == notified_generation_) {
+    return;
+  }
+  notified_generation_ = snapshot->generation;
+
+  if (observer_) {
+    observer_->OnDataSourceCurrentValueChanged();
+    observer_->OnDataSourcePointsAppended();
+  }
+}
+
+double SnapshotDataSource::GetCurrentValue() const {
+  auto snapshot = GetSnapshot();
+  return snapshot->size == 0 ? kGraphUnknownValue
+                             : snapshot->at(snapshot->size - 1).y;
+}
+
+std::unique_ptr<PointEnumerator> SnapshotDataSource::EnumPoints(
+    double from,
+    double to,
+    bool include_left_bound,
+    bool include_right_bound) {
+  auto snapshot = GetSnapshot();
+  size_t first = include_left_bound ? FindLowerBound(*snapshot, from)
+                                    : FindUpperBound(*snapshot, from);
+  size_t last = include_right_bound ? FindUpperBound(*snapshot, to)
+                                    : FindLowerBound(*snapshot, to);
+  if (first >= last) {
+    return nullptr;
+  }
+  return std::make_unique<SnapshotPointEnumerator>(std::move(snapshot), first,
+                                                   last);
+}
+
+GraphRange SnapshotDataSource::GetHorizontalRange() const {
+  auto snapshot = GetSnapshot();
+  if (snapshot->size == 0) {
+    return GraphRange{};
+  }
+  return GraphRange{snapshot->at(0).x, snapshot->at(snapshot->size - 1).x,
+                    horizontal_kind_};
+}
+
+GraphRange SnapshotDataSource::GetVerticalRange() const {
+  return GetSnapshot()->vertical_range;
+}
+
+std::optional<size_t> SnapshotDataSource::LowerBound(double value) const {
+  return FindLowerBound(*GetSnapshot(), value);
+}
+
+std::optional<size_t> SnapshotDataSource::UpperBound(double value) const {
+  return FindUpperBound(*GetSnapshot(), value);
+}
+
+std::optional<double> SnapshotDataSource::GetPointX(size_t index) const {
+  return GetSnapshot()->at(index).x;
+}
+
+}  // namespace views
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "graph_qt/model/graph_data_source.h"
+
+#include <array>
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace views {
+
+// Data source that serves reads from immutable generations of its points, so
+// a writer thread can append while the GUI thread paints.
+//
+// Points are stored in fixed-size chunks listed in a chunk table shared by
+// all generations. Appending writes past the end of the current generation,
+// then publishes a new generation referencing the same table, so publishing
+// takes O(1) however long the history is. Enumerators keep the generation
+// they started with alive, so they see a consistent view however long they
+// run, and the writer never waits for them. The current generation is an
+// atomic pointer, so neither readers nor the writer take a lock.
+//
+// Every query reads a single generation. As generations only append points,
+// an index returned by `LowerBound()` refers to the same point in any later
+// generation, so index queries can be combined across calls.
+//
+// Appending may run on any single writer thread and doesn't notify, as the
+// observer lives on the GUI thread. Call `NotifyObserver()` there instead,
+// e.g. once per frame.
+class SnapshotDataSource : public GraphDataSource {
+ public:
+  static constexpr size_t kChunkSize = 4096;
+
+  struct Chunk {
+    std::array<GraphPoint, kChunkSize> points;
+  };
+
+  // Append-only list of chunks. Generations only read the chunks holding
+  // their points, so the writer fills the slots past them in place. When the
+  // table is full, the writer moves on to a copy with double the capacity,
+  // and the older generations keep the old table.
+  struct ChunkTable {
+    explicit ChunkTable(size_t capacity)
+        : chunks{std::make_unique<std::shared_ptr<Chunk>[]>(capacity)},
+          capacity{capacity} {}
+
+    const std::unique_ptr<std::shared_ptr<Chunk>[]> chunks;
+    const size_t capacity;
+  };
+
+  // An immutable generation of the points.
+  struct Snapshot {
+    const GraphPoint& at(size_t index) const {
+      return table->chunks[index / kChunkSize]->points[index % kChunkSize];
+    }
+
+    // Returns the contiguous points starting at `index` within its chunk.
+    std::span<const GraphPoint> GetChunkPoints(size_t index) const;
+
+    // Chunks are full except the last one, which holds `size % kChunkSize`
+    // points of this generation.
+    std::shared_ptr<const ChunkTable> table;
+    size_t size = 0;
+    GraphRange vertical_range;
+    // Number of the generation, increasing with every publication.
+    uint64_t generation = 0;
+  };
+
+  explicit SnapshotDataSource(
+      GraphRange::Kind horizontal_kind = GraphRange::LINEAR);
+  ~SnapshotDataSource() override;
+
+  // Returns the current generation. Thread-safe.
+  std::shared_ptr<const Snapshot> GetSnapshot() const {
+    return snapshot_.load(std::memory_order_acquire);
+  }
+
+  // Appends points and publishes them as a new generation. The points must be
+  // sorted by x, and the first one must not precede the last existing point.
+  // Must be called from one writer thread at a time.
+  void AddPoints(std::span<const GraphPoint> points);
+
+  // Notifies the observer if a generation was published since the last call.
+  // Must be called on the observer thread.
+  void NotifyObserver();
+
+  // GraphDataSource
+  double GetCurrentValue() const override;
+  std::unique_ptr<PointEnumerator> EnumPoints(
+      double from,
+      double to,
+      bool include_left_bound,
+      bool include_right_bound) override;
+  GraphRange GetHorizontalRange() const override;
+  GraphRange GetVerticalRange() const override;
+  std::optional<size_t> LowerBound(double value) const override;
+  std::optional<size_t> UpperBound(double value) const override;
+  std::optional<double> GetPointX(size_t index) const override;
+
+ private:
+  const GraphRange::Kind horizontal_kind_;
+
+  // Table the writer appends chunks to. Writer thread only.
+  std::shared_ptr<ChunkTable> table_;
+
+  std::atomic<std::shared_ptr<const Snapshot>> snapshot_;
+
+  // Generation the observer was last notified of. Observer thread only.
+  uint64_t notified_generation_ = 0;
+};
+
+}  // namespace views
@@ -0,0 +1,129 @@
+#include "graph_qt/model/snapshot_data_source.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace views {
+
+namespace {
+
+class CountingObserver : public GraphDataSource::Observer {
+ public:
+  void OnDataSourcePointsAppended() override { ++points_appended_count; }
+
+  int points_appended_count = 0;
+};
+
+std::vector<GraphPoint> MakePoints(size_t first, size_t count) {
+  std::vector<GraphPoint> points;
+  for (size_t i = first; i < first + count; ++i) {
+    points.emplace_back(static_cast<double>(i), static_cast<double>(i % 100));
+  }
+  return points;
+}
+
+}  // namespace
+
+TEST(SnapshotDataSourceTest, EnumPoints) {
+  SnapshotDataSource data_source;
+  data_source.AddPoints(MakePoints(0, 10000));
+
+  EXPECT_EQ(data_source.GetHorizontalRange(), GraphRange(0, 9999));
+  EXPECT_EQ(data_source.GetVerticalRange(), GraphRange(0, 99));
+  EXPECT_EQ(data_source.GetCurrentValue(), 99);
+  EXPECT_EQ(data_source.CountPoints(4000, 5000, true, false), 1000u);
+
+  // The enumeration spans chunks.
+  auto point_enum = data_source.EnumPoints(4000, 5000, true, false);
+  ASSERT_TRUE(point_enum);
+  std::vector<GraphPoint> points;
+  ForEachPoint(*point_enum,
+               [&](const GraphPoint& point) { points.push_back(point); });
+  EXPECT_EQ(points, MakePoints(4000, 1000));
+}
+
+TEST(SnapshotDataSourceTest, EnumeratorKeepsGeneration) {
+  SnapshotDataSource data_source;
+  data_source.AddPoints(MakePoints(0, 100));
+
+  auto point_enum = data_source.EnumPoints(0, 1000000, true, true);
+  data_source.AddPoints(MakePoints(100, 10000));
+
+  EXPECT_EQ(point_enum->GetCount(), 100u);
+  size_t count = 0;
+  ForEachPoint(*point_enum, [&](const GraphPoint&) { ++count; });
+  EXPECT_EQ(count, 100u);
+}
+
+TEST(SnapshotDataSourceTest, GenerationsShareChunkTable) {
+  SnapshotDataSource data_source;
+  data_source.AddPoints(MakePoints(0, 10000));
+  auto snapshot = data_source.GetSnapshot();
+
+  // Publishing doesn't copy the chunk list.
+  data_source.AddPoints(MakePoints(10000, 1));
+  EXPECT_EQ(data_source.GetSnapshot()->table, snapshot->table);
+
+  // Outgrowing the table leaves the older generations intact.
+  data_source.AddPoints(
+      MakePoints(10001, SnapshotDataSource::kChunkSize * 100));
+  EXPECT_NE(data_source.GetSnapshot()->table, snapshot->table);
+  EXPECT_EQ(snapshot->size, 10000u);
+  EXPECT_EQ(snapshot->at(9999).x, 9999);
+}
+
+TEST(SnapshotDataSourceTest, NotifyObserver) {
+  SnapshotDataSource data_source;
+  CountingObserver observer;
+  data_source.SetObserver(&observer);
+
+  data_source.NotifyObserver();
+  EXPECT_EQ(observer.points_appended_count, 0);
+
+  data_source.AddPoints(MakePoints(0, 10));
+  data_source.AddPoints(MakePoints(10, 10));
+  data_source.NotifyObserver();
+  data_source.NotifyObserver();
+  EXPECT_EQ(observer.points_appended_count, 1);
+
+  data_source.SetObserver(nullptr);
+}
+
+TEST(SnapshotDataSourceTest, ConcurrentReads) {
+  const size_t kBatchSize = 100;
+  const size_t kBatchCount = 1000;
+
+  SnapshotDataSource data_source;
+  std::atomic<bool> done = false;
+
+  std::thread writer{[&] {
+    for (size_t i = 0; i < kBatchCount; ++i) {
+      data_source.AddPoints(MakePoints(i * kBatchSize, kBatchSize));
+    }
+    done = true;
+  }};
+
+  // Every enumeration sees a consistent prefix of the points.
+  while (!done) {
+    auto point_enum = data_source.EnumPoints(0, 1e9, true, true);
+    if (!point_enum) {
+      continue;
+    }
+    size_t count = point_enum->GetCount();
+    size_t index = 0;
+    ForEachPoint(*point_enum, [&](const GraphPoint& point) {
+      ASSERT_EQ(point.x, index);
+      ++index;
+    });
+    ASSERT_EQ(index, count);
+    ASSERT_EQ(count % kBatchSize, 0u);
+  }
+
+  writer.join();
+  EXPECT_EQ(data_source.GetSnapshot()->size, kBatchSize * kBatchCount);
+}
+
+}  // namespace views
@@ -0,0 +1,463 @@
+#include "graph_qt/model/sqlite_data_source.h"
+
+#include "graph_qt/model/point_enumerators.h"
+
+#include <QVariant>
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+namespace views {
+
+namespace {
+
+QString QuoteIdentifier(QString name) {
+  return '"' + name.replace('"', "\"\"") + '"';
+}
+
+// Reads the (x, y) rows of an executed query.
+std::vector<GraphPoint> ReadPoints(QSqlQuery& query) {
+  std::vector<GraphPoint> points;
+  while (query.next()) {
+    auto& point = points.emplace_back(query.value(0).toDouble(),
+                                      query.value(1).toDouble());
+    point.good = true;
+  }
+  // Release the read transaction of the statement.
+  query.finish();
+  return points;
+}
+
+// Returns true if the x column is the integer primary key of the table, or
+// the first column of an index of all its rows.
+bool HasIndexOnX(const QSqlDatabase& database, const SqliteTable& table) {
+  auto is_x = [&](const QVariant& column) {
+    return QString::compare(column.toString(), table.x_column,
+                            Qt::CaseInsensitive) == 0;
+  };
+
+  // Rows are stored by the integer primary key.
+  QSqlQuery table_info{database};
+  if (!table_info.exec(
+          QString{"PRAGMA table_info(%1)"}.arg(QuoteIdentifier(table.name)))) {
+    return false;
+  }
+  size_t key_count = 0;
+  bool x_is_integer_key = false;
+  while (table_info.next()) {
+    if (table_info.value(5).toInt() != 0) {
+      ++key_count;
+      x_is_integer_key =
+          is_x(table_info.value(1)) &&
+          QString::compare(table_info.value(2).toString(), "INTEGER",
+                           Qt::CaseInsensitive) == 0;
+    }
+  }
+  if (key_count == 1 && x_is_integer_key) {
+    return true;
+  }
+
+  // Partial indexes leave rows out.
+  QSqlQuery index_list{database};
+  if (!index_list.exec(
+          QString{"PRAGMA index_list(%1)"}.arg(QuoteIdentifier(table.name)))) {
+    return false;
+  }
+  std::vector<QString> indexes;
+  while (index_list.next()) {
+    if (index_list.value(4).toInt() == 0) {
+      indexes.push_back(index_list.value(1).toString());
+    }
+  }
+
+  // The columns of an index are listed in order.
+  for (const auto& index : indexes) {
+    QSqlQuery index_info{database};
+    if (index_info.exec(
+            QString{"PRAGMA index_info(%1)"}.arg(QuoteIdentifier(index))) &&
+        index_info.next() && is_x(index_info.value(2))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+SqliteDataSource::SqliteDataSource(GraphRange::Kind horizontal_kind)
+    : horizontal_kind_{horizontal_kind} {}
+
+SqliteDataSource::~SqliteDataSource() {
+  Close();
+}
+
+bool SqliteDataSource::Open(const QString& path, const SqliteTable& table) {
+  Close();
+
+  connection_name_ = "graph_qt_sqlite_" +
+                     QString::number(reinterpret_cast<quintptr>(this), 16);
+  database_ = QSqlDatabase::addDatabase("QSQLITE", connection_name_);
+  database_.setDatabaseName(path);
+
+  bool result = database_.open() && Prepare(table) && ReadExtents() &&
+                ReadBuckets();
+  if (!result) {
+    Close();
+  }
+
+  if (observer_) {
+    observer_->OnDataSourceCurrentValueChanged();
+    observer_->OnDataSourceHistoryChanged();
+  }
+  return result;
+}
+
+bool SqliteDataSource::Prepare(const SqliteTable& table) {
+  const QString name = QuoteIdentifier(table.name);
+  const QString x = QuoteIdentifier(table.x_column);
+  const QString y = QuoteIdentifier(table.y_column);
+
+  // A covering index lets range queries read the index only. Tables already
+  // indexed by x are left as they are, as creating an index writes to the
+  // file. Creating it fails on read-only files, which then fall back to
+  // scanning the table.
+  if (!HasIndexOnX(database_, table)) {
+    QSqlQuery{database_}.exec(
+        QString{"CREATE INDEX IF NOT EXISTS %1 ON %2 (%3, %4)"}.arg(
+            QuoteIdentifier(table.name + "_" + table.x_column + "_" +
+                            table.y_column + "_index"),
+            name, x, y));
+  }
+
+  auto prepare = [&](QSqlQuery& query, const QString& text) {
+    query = QSqlQuery{database_};
+    query.setForwardOnly(true);
+    return query.prepare(text.arg(name, x, y));
+  };
+
+  return prepare(extents_query_,
+                 "SELECT MIN(%2), MAX(%2), MIN(%3), MAX(%3), COUNT(*), "
+                 "(SELECT %3 FROM %1 ORDER BY %2 DESC LIMIT 1) FROM %1") &&
+         prepare(points_query_,
+                 "SELECT %2, %3 FROM %1 WHERE %2 >= ? AND %2 <= ? "
+                 "ORDER BY %2") &&
+         // SQLite takes bare columns from the row holding the single MIN() or
+         // MAX() of a group, so every part of the union gives one point per
+         // bucket. Buckets start at or after the origin, so the integer cast
+         // rounds down.
+         prepare(reduced_points_query_,
+                 "WITH selected AS ("
+                 "SELECT %2 AS x, %3 AS y, CAST((%2 - ?) / ? AS INTEGER) AS b "
+                 "FROM %1 WHERE %2 >= ? AND %2 <= ?) "
+                 "SELECT MIN(x), y FROM selected GROUP BY b "
+                 "UNION ALL SELECT MAX(x), y FROM selected GROUP BY b "
+                 "UNION ALL SELECT x, MIN(y) FROM selected GROUP BY b "
+                 "UNION ALL SELECT x, MAX(y) FROM selected GROUP BY b "
+                 "ORDER BY 1, 2") &&
+         prepare(vertical_range_query_,
+                 "SELECT MIN(%3), MAX(%3) FROM %1 WHERE %2 >= ? AND %2 < ?");
+}
+
+bool SqliteDataSource::ReadExtents() {
+  if (!extents_query_.exec() || !extents_query_.next()) {
+    return false;
+  }
+
+  count_ = extents_query_.value(4).toULongLong();
+  if (count_ == 0) {
+    horizontal_range_ = GraphRange{};
+    vertical_range_ = GraphRange{};
+    current_value_ = kGraphUnknownValue;
+  } else {
+    horizontal_range_ = GraphRange{extents_query_.value(0).toDouble(),
+                                   extents_query_.value(1).toDouble(),
+                                   horizontal_kind_};
+    vertical_range_ = GraphRange{extents_query_.value(2).toDouble(),
+                                 extents_query_.value(3).toDouble()};
+    current_value_ = extents_query_.value(5).toDouble();
+  }
+  extents_query_.finish();
+  return true;
+}
+
+bool SqliteDataSource::ReadBuckets() {
+  buckets_.clear();
+  bucket_row_count_ = 0;
+  tail_x_count_ = 0;
+  return UpdateBuckets();
+}
+
+bool SqliteDataSource::UpdateBuckets() {
+  // Rows are read one by one, without holding them all in memory.
+  points_query_.bindValue(0, bucket_row_count_ == 0
+                                 ? std::numeric_limits<double>::lowest()
+                                 : tail_x_);
+  points_query_.bindValue(1, std::numeric_limits<double>::max());
+  if (!points_query_.exec()) {
+    return false;
+  }
+
+  // Rows at `tail_x_` up to `tail_x_count_` were summarized before.
+  size_t skip_count = bucket_row_count_ == 0 ? 0 : tail_x_count_;
+  while (points_query_.next()) {
+    GraphPoint point{points_query_.value(0).toDouble(),
+                     points_query_.value(1).toDouble()};
+    point.good = true;
+    if (skip_count != 0 && point.x == tail_x_) {
+      --skip_count;
+      continue;
+    }
+    skip_count = 0;
+
+    if (buckets_.empty() || buckets_.back().count == kBucketRows) {
+      buckets_.push_back(SummaryBucket{});
+    }
+    buckets_.back().Add(point);
+
+    tail_x_count_ =
+        bucket_row_count_ != 0 && point.x == tail_x_ ? tail_x_count_ + 1 : 1;
+    tail_x_ = point.x;
+    ++bucket_row_count_;
+  }
+  points_query_.finish();
+
+  // Rows were inserted before the last summarized one, or deleted.
+  if (bucket_row_count_ != count_ && !buckets_.empty()) {
+    buckets_.clear();
+    bucket_row_count_ = 0;
+    tail_x_count_ = 0;
+    return UpdateBuckets();
+  }
+  return true;
+}
+
+std::span<const SummaryBucket> SqliteDataSource::FindBuckets(
+    double from,
+    double to,
+    bool include_right_bound) const {
+  auto first_bucket = std::ranges::partition_point(
+      buckets_, [&](const SummaryBucket& b) { return b.first_x < from; });
+  auto last_bucket =
+      std::ranges::partition_point(buckets_, [&](const SummaryBucket& b) {
+        return include_right_bound ? b.last_x <= to : b.last_x < to;
+      });
+  size_t first = first_bucket - buckets_.begin();
+  size_t last = last_bucket - buckets_.begin();
+  while (first < last && first > 0 &&
+         buckets_[first - 1].last_x == buckets_[first].first_x) {
+    ++first;
+  }
+  while (last > first && last < buckets_.size() &&
+         buckets_[last].first_x == buckets_[last - 1].last_x) {
+    --last;
+  }
+  return first < last ? std::span{buckets_}.subspan(first, last - first)
+                      : std::span<const SummaryBucket>{};
+}
+
+void SqliteDataSource::Close() {
+  // The queries must be gone before the connection is removed.
+  extents_query_ = QSqlQuery{};
+  points_query_ = QSqlQuery{};
+  reduced_points_query_ = QSqlQuery{};
+  vertical_range_query_ = QSqlQuery{};
+
+  if (database_.isValid()) {
+    database_.close();
+    database_ = QSqlDatabase{};
+    QSqlDatabase::removeDatabase(connection_name_);
+  }
+
+  count_ = 0;
+  horizontal_range_ = GraphRange{};
+  vertical_range_ = GraphRange{};
+  current_value_ = kGraphUnknownValue;
+  buckets_.clear();
+  bucket_row_count_ = 0;
+}
+
+void SqliteDataSource::Refresh() {
+  if (is_open() && ReadExtents()) {
+    UpdateBuckets();
+  }
+
+  if (observer_) {
+    observer_->OnDataSourceCurrentValueChanged();
+    observer_->OnDataSourceHistoryChanged();
+  }
+}
+
+double SqliteDataSource::GetCurrentValue() const {
+  return current_value_;
+}
+
+std::unique_ptr<PointEnumerator> SqliteDataSource::EnumPoints(
+    double from,
+    double to,
+    bool include_left_bound,
+    bool include_right_bound) {
+  if (!is_open()) {
+    return nullptr;
+  }
+
+  auto points = QueryPoints(from, to, include_left_bound, include_right_bound);
+  if (points.empty()) {
+    return nullptr;
+  }
+  return std::make_unique<VectorPointEnumerator>(std::move(points));
+}
+
+std::unique_ptr<PointEnumerator> SqliteDataSource::EnumReducedPoints(
+    double from,
+    double to,
+    double resolution) {
+  // Reduction pays off only if there are several rows per pixel column on
+  // average.
+  const double width = horizontal_range_.delta();
+  const double estimated_count =
+      width > 0 ? count_ * std::min((to - from) / width, 1.0) : count_;
+  const double column_count = (to - from) / resolution;
+  if (!is_open() || resolution <= 0 || estimated_count <= 4 * column_count) {
+    return EnumPoints(from, to, true, true);
+  }
+
+  // With a bucket or more per pixel column, the buckets make the columns.
+  auto buckets = FindBuckets(from, to, true);
+  auto points =
+      estimated_count >= kBucketRows * column_count && !buckets.empty()
+          ? ReduceBuckets(buckets, from, to, resolution)
+          : QueryReducedPoints(from, to, resolution);
+  if (points.empty()) {
+    return nullptr;
+  }
+  return std::make_unique<VectorPointEnumerator>(std::move(points));
+}
+
+std::vector<GraphPoint> SqliteDataSource::QueryPoints(
+    double from,
+    double to,
+    bool include_left_bound,
+    bool include_right_bound) {
+  points_query_.bindValue(0, from);
+  points_query_.bindValue(1, to);
+  if (!points_query_.exec()) {
+    return {};
+  }
+  auto points = ReadPoints(points_query_);
+
+  // The query includes both bounds.
+  std::erase_if(points, [&](const GraphPoint& point) {
+    return (!include_left_bound && point.x == from) ||
+           (!include_right_bound && point.x == to);
+  });
+  return points;
+}
+
+std::vector<GraphPoint> SqliteDataSource::QueryReducedPoints(
+    double from,
+    double to,
+    double resolution) {
+  const double origin = std::floor(from / resolution) * resolution;
+  reduced_points_query_.bindValue(0, origin);
+  reduced_points_query_.bindValue(1, resolution);
+  reduced_points_query_.bindValue(2, from);
+  reduced_points_query_.bindValue(3, to);
+  if (!reduced_points_query_.exec()) {
+    return {};
+  }
+  auto points = ReadPoints(reduced_points_query_);
+
+  // The first point of a bucket is often its minimum or maximum too.
+  auto duplicates = std::ranges::unique(points, [](const auto& a,
+                                                   const auto& b) {
+    return a.x == b.x && a.y == b.y;
+  });
+  points.erase(duplicates.begin(), duplicates.end());
+  return points;
+}
+
+std::vector<GraphPoint> SqliteDataSource::ReduceBuckets(
+    std::span<const SummaryBucket> buckets,
+    double from,
+    double to,
+    double resolution) {
+  // The rows at the ends are fewer than two buckets, and are given as is.
+  auto points = QueryPoints(from, buckets.front().first_x, true, false);
+
+  // Buckets are merged into the pixel column they start in.
+  SummaryBucket column{};
+  double column_index = 0;
+  for (const auto& bucket : buckets) {
+    const double index = std::floor(bucket.first_x / resolution);
+    if (column.count != 0 && index != column_index) {
+      std::ranges::copy(column.GetPoints(), std::back_inserter(points));
+      column = SummaryBucket{};
+    }
+    column.Merge(bucket);
+    column_index = index;
+  }
+  std::ranges::copy(column.GetPoints(), std::back_inserter(points));
+
+  std::ranges::copy(QueryPoints(buckets.back().last_x, to, false, true),
+                    std::back_inserter(points));
+  return points;
+}
+
+GraphRange SqliteDataSource::GetHorizontalRange() const {
+  return horizontal_range_;
+}
+
+GraphRange SqliteDataSource::GetVerticalRange() const {
+  return vertical_range_;
+}
+
+std::optional<GraphRange> SqliteDataSource::QueryVerticalRange(
+    double x1,
+    double x2) const {
+  if (!is_open()) {
+    return GraphRange{};
+  }
+
+  // Rows at the boundaries of the buckets may be read twice, which doesn't
+  // change the range.
+  double low = std::numeric_limits<double>::max();
+  double high = std::numeric_limits<double>::lowest();
+  auto buckets = FindBuckets(x1, x2, false);
+  if (!QueryRowRange(x1, buckets.empty() ? x2 : buckets.front().first_x, low,
+                     high) ||
+      (!buckets.empty() &&
+       !QueryRowRange(buckets.back().last_x, x2, low, high))) {
+    return std::nullopt;
+  }
+  for (const auto& bucket : buckets) {
+    low = std::min(low, bucket.min_y);
+    high = std::max(high, bucket.max_y);
+  }
+
+  if (low > high) {
+    return GraphRange{};
+  }
+  return GraphRange{low, high};
+}
+
+bool SqliteDataSource::QueryRowRange(double x1,
+                                     double x2,
+                                     double& low,
+                                     double& high) const {
+  vertical_range_query_.bindValue(0, x1);
+  vertical_range_query_.bindValue(1, x2);
+  if (!vertical_range_query_.exec() || !vertical_range_query_.next()) {
+    return false;
+  }
+
+  if (!vertical_range_query_.value(0).isNull()) {
+    low = std::min(low, vertical_range_query_.value(0).toDouble());
+    high = std::max(high, vertical_range_query_.value(1).toDouble());
+  }
+  vertical_range_query_.finish();
+  return true;
+}
+
+}  // namespace views
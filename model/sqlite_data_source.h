@@ -0,0 +1,134 @@
+#pragma once
+
+#include "graph_qt/model/graph_data_source.h"
+#include "graph_qt/model/summary_sidecar.h"
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QString>
+#include <span>
+#include <vector>
+
+namespace views {
+
+// Table of (x, y) rows read by `SqliteDataSource`.
+struct SqliteTable {
+  QString name = "samples";
+  QString x_column = "timestamp";
+  QString y_column = "value";
+};
+
+// Read-only data source over a table of (x, y) rows in an SQLite file, read
+// through Qt's QSQLITE driver. All points are good.
+//
+// Unless the x column is the integer primary key or leads an index already,
+// opening creates an index on (x, y), so range queries read the index only.
+// This writes to the file. Statements are prepared once on opening and reused.
+//
+// Opening also reads the table once into a bucket table: the first, last,
+// minimum and maximum rows of every `kBucketRows` consecutive rows, kept in
+// memory and extended by `Refresh()` with the rows appended since. Zoomed-out
+// views and `QueryVerticalRange()` read the buckets, and SQL only for the rows
+// at the ends of the range that no bucket covers. At zoom levels with fewer
+// rows per pixel column than a bucket, `EnumReducedPoints()` pushes the
+// reduction into SQL, which returns the first, last, minimum and maximum
+// points of every pixel column. Pixel columns are aligned to multiples of the
+// resolution, so panning doesn't change the reduced points.
+class SqliteDataSource : public GraphDataSource {
+ public:
+  static constexpr size_t kBucketRows = 64;
+
+  explicit SqliteDataSource(
+      GraphRange::Kind horizontal_kind = GraphRange::LINEAR);
+  ~SqliteDataSource() override;
+
+  SqliteDataSource(const SqliteDataSource&) = delete;
+  SqliteDataSource& operator=(const SqliteDataSource&) = delete;
+
+  bool is_open() const { return database_.isOpen(); }
+  size_t size() const { return count_; }
+
+  // Opens `table` in the SQLite file at `path`, and may add an index to it.
+  // Returns false if the file or the table can't be read. Sends
+  // `OnDataSourceHistoryChanged()`.
+  bool Open(const QString& path, const SqliteTable& table = {});
+
+  void Close();
+
+  // Reads the extents of the table again after rows were written by someone
+  // else, and summarizes the appended rows. Rows written before the last
+  // summarized one make the bucket table be read again. Sends
+  // `OnDataSourceHistoryChanged()`.
+  void Refresh();
+
+  // GraphDataSource
+  double GetCurrentValue() const override;
+  std::unique_ptr<PointEnumerator> EnumPoints(
+      double from,
+      double to,
+      bool include_left_bound,
+      bool include_right_bound) override;
+  std::unique_ptr<PointEnumerator> EnumReducedPoints(
+      double from,
+      double to,
+      double resolution) override;
+  GraphRange GetHorizontalRange() const override;
+  GraphRange GetVerticalRange() const override;
+  std::optional<GraphRange> QueryVerticalRange(double x1,
+                                               double x2) const override;
+
+ private:
+  bool Prepare(const SqliteTable& table);
+  bool ReadExtents();
+
+  // Summarizes the rows added since the last update, or all rows if the
+  // table changed otherwise.
+  bool UpdateBuckets();
+  bool ReadBuckets();
+
+  // Returns the run of buckets whose rows are all in the range, excluding
+  // buckets that share the x of a boundary row with a bucket outside.
+  std::span<const SummaryBucket> FindBuckets(double from,
+                                             double to,
+                                             bool include_right_bound) const;
+
+  std::vector<GraphPoint> QueryPoints(double from,
+                                      double to,
+                                      bool include_left_bound,
+                                      bool include_right_bound);
+  std::vector<GraphPoint> QueryReducedPoints(double from,
+                                             double to,
+                                             double resolution);
+  std::vector<GraphPoint> ReduceBuckets(std::span<const SummaryBucket> buckets,
+                                        double from,
+                                        double to,
+                                        double resolution);
+
+  // Widens `low` and `high` to the y range of the rows in [x1, x2). Returns
+  // false if the query fails.
+  bool QueryRowRange(double x1, double x2, double& low, double& high) const;
+
+  const GraphRange::Kind horizontal_kind_;
+
+  QString connection_name_;
+  QSqlDatabase database_;
+
+  QSqlQuery extents_query_;
+  QSqlQuery points_query_;
+  QSqlQuery reduced_points_query_;
+  mutable QSqlQuery vertical_range_query_;
+
+  size_t count_ = 0;
+  GraphRange horizontal_range_;
+  GraphRange vertical_range_;
+  double current_value_ = kGraphUnknownValue;
+
+  std::vector<SummaryBucket> buckets_;
+  size_t bucket_row_count_ = 0;
+  // The x of the last summarized row, and the number of summarized rows with
+  // that x, to resume after them.
+  double tail_x_ = 0;
+  size_t tail_x_count_ = 0;
+};
+
+}  // namespace views
@@ -0,0 +1,207 @@
+#include "graph_qt/model/sqlite_data_source.h"
+
+#include <QCoreApplication>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace views {
+
+namespace {
+
+std::vector<GraphPoint> EnumAllPoints(
+    std::unique_ptr<PointEnumerator> point_enum) {
+  std::vector<GraphPoint> points;
+  if (point_enum) {
+    size_t count = point_enum->GetCount();
+    ForEachPoint(*point_enum,
+                 [&](const GraphPoint& point) { points.push_back(point); });
+    EXPECT_EQ(points.size(), count);
+  }
+  return points;
+}
+
+class SqliteDataSourceTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.isValid());
+    path_ = temp_dir_.filePath("archive.db");
+
+    // Rows (i, i % 100) for i in [0, 10000).
+    {
+      auto database = QSqlDatabase::addDatabase("QSQLITE", "writer");
+      database.setDatabaseName(path_);
+      ASSERT_TRUE(database.open());
+      QSqlQuery query{database};
+      ASSERT_TRUE(
+          query.exec("CREATE TABLE samples (timestamp REAL, value REAL)"));
+      ASSERT_TRUE(query.exec(
+          "INSERT INTO samples WITH RECURSIVE s(i) AS "
+          "(SELECT 0 UNION ALL SELECT i + 1 FROM s WHERE i < 9999) "
+          "SELECT i, i % 100 FROM s"));
+    }
+    QSqlDatabase::removeDatabase("writer");
+  }
+
+  // The SQL drivers are plugins, which need an application instance.
+  int argc_ = 1;
+  char arg0_[5] = "test";
+  char* argv_[1] = {arg0_};
+  QCoreApplication application_{argc_, argv_};
+
+  QTemporaryDir temp_dir_;
+  QString path_;
+};
+
+}  // namespace
+
+TEST_F(SqliteDataSourceTest, EnumPoints) {
+  SqliteDataSource data_source;
+  ASSERT_TRUE(data_source.Open(path_));
+
+  EXPECT_EQ(data_source.size(), 10000u);
+  EXPECT_EQ(data_source.GetHorizontalRange(), GraphRange(0, 9999));
+  EXPECT_EQ(data_source.GetVerticalRange(), GraphRange(0, 99));
+  EXPECT_EQ(data_source.GetCurrentValue(), 99);
+  EXPECT_EQ(data_source.QueryVerticalRange(120, 150), GraphRange(20, 49));
+  EXPECT_EQ(data_source.QueryVerticalRange(20000, 30000), GraphRange());
+
+  const auto points =
+      EnumAllPoints(data_source.EnumPoints(10, 20, false, true));
+  ASSERT_EQ(points.size(), 10u);
+  EXPECT_EQ(points.front().x, 11);
+  EXPECT_EQ(points.back().x, 20);
+  EXPECT_EQ(points.back().y, 20);
+  EXPECT_TRUE(points.back().good);
+  EXPECT_FALSE(data_source.EnumPoints(20000, 30000, true, true));
+}
+
+TEST_F(SqliteDataSourceTest, EnumReducedPoints) {
+  SqliteDataSource data_source;
+  ASSERT_TRUE(data_source.Open(path_));
+
+  // Every pixel column of 10 rows starts at its minimum and ends at its
+  // maximum.
+  const auto points = EnumAllPoints(data_source.EnumReducedPoints(0, 9999, 10));
+  ASSERT_EQ(points.size(), 2000u);
+  EXPECT_TRUE(std::ranges::is_sorted(points, {}, &GraphPoint::x));
+  for (size_t i = 0; i < points.size(); i += 2) {
+    EXPECT_EQ(points[i].x, i * 5.0);
+    EXPECT_EQ(points[i].y, i * 5 % 100);
+    EXPECT_EQ(points[i + 1].x, i * 5.0 + 9);
+    EXPECT_EQ(points[i + 1].y, i * 5 % 100 + 9);
+  }
+
+  // Sparse rows aren't reduced.
+  EXPECT_EQ(EnumAllPoints(data_source.EnumReducedPoints(0, 100, 1)).size(),
+            101u);
+}
+
+TEST_F(SqliteDataSourceTest, EnumReducedPointsReadsBuckets) {
+  SqliteDataSource data_source;
+  ASSERT_TRUE(data_source.Open(path_));
+
+  // Pixel columns of 1000 rows merge the buckets starting in them, and the
+  // rows at the ends are given as is.
+  const auto points =
+      EnumAllPoints(data_source.EnumReducedPoints(10, 9990, 1000));
+  EXPECT_LE(points.size(), 4 * 11 + 2 * SqliteDataSource::kBucketRows);
+  EXPECT_TRUE(std::ranges::is_sorted(points, {}, &GraphPoint::x));
+  EXPECT_EQ(points.front().x, 10);
+  EXPECT_EQ(points.back().x, 9990);
+  for (const auto& point : points) {
+    EXPECT_EQ(point.y, static_cast<int>(point.x) % 100);
+  }
+  for (int column = 0; column < 10; ++column) {
+    const double max_x = column * 1000.0 + 99;
+    EXPECT_NE(std::ranges::find(points, max_x, &GraphPoint::x), points.end());
+  }
+}
+
+TEST_F(SqliteDataSourceTest, QueryVerticalRangeReadsBuckets) {
+  SqliteDataSource data_source;
+  ASSERT_TRUE(data_source.Open(path_));
+
+  EXPECT_EQ(data_source.QueryVerticalRange(0, 10000), GraphRange(0, 99));
+  EXPECT_EQ(data_source.QueryVerticalRange(150, 1130), GraphRange(0, 99));
+  EXPECT_EQ(data_source.QueryVerticalRange(130, 150), GraphRange(30, 49));
+
+  // Appended rows are summarized on refreshing.
+  {
+    auto database = QSqlDatabase::addDatabase("QSQLITE", "writer");
+    database.setDatabaseName(path_);
+    ASSERT_TRUE(database.open());
+    QSqlQuery query{database};
+    ASSERT_TRUE(query.exec(
+        "INSERT INTO samples WITH RECURSIVE s(i) AS "
+        "(SELECT 10000 UNION ALL SELECT i + 1 FROM s WHERE i < 10999) "
+        "SELECT i, 1000 - i % 100 FROM s"));
+  }
+  QSqlDatabase::removeDatabase("writer");
+  data_source.Refresh();
+
+  EXPECT_EQ(data_source.size(), 11000u);
+  EXPECT_EQ(data_source.QueryVerticalRange(0, 20000), GraphRange(0, 1000));
+  EXPECT_EQ(data_source.QueryVerticalRange(10100, 10900),
+            GraphRange(901, 1000));
+}
+
+TEST_F(SqliteDataSourceTest, KeepsExistingIndex) {
+  auto count_indexes = [&] {
+    auto database = QSqlDatabase::addDatabase("QSQLITE", "reader");
+    database.setDatabaseName(path_);
+    int count = -1;
+    if (database.open()) {
+      QSqlQuery query{database};
+      if (query.exec(
+              "SELECT COUNT(*) FROM sqlite_master WHERE type = 'index'") &&
+          query.next()) {
+        count = query.value(0).toInt();
+      }
+    }
+    database = QSqlDatabase{};
+    QSqlDatabase::removeDatabase("reader");
+    return count;
+  };
+
+  {
+    auto database = QSqlDatabase::addDatabase("QSQLITE", "writer");
+    database.setDatabaseName(path_);
+    ASSERT_TRUE(database.open());
+    ASSERT_TRUE(QSqlQuery{database}.exec(
+        "CREATE INDEX samples_timestamp ON samples (timestamp)"));
+  }
+  QSqlDatabase::removeDatabase("writer");
+
+  SqliteDataSource data_source;
+  ASSERT_TRUE(data_source.Open(path_));
+  EXPECT_EQ(count_indexes(), 1);
+  data_source.Close();
+
+  // A table without an index on x gets one.
+  {
+    auto database = QSqlDatabase::addDatabase("QSQLITE", "writer");
+    database.setDatabaseName(path_);
+    ASSERT_TRUE(database.open());
+    ASSERT_TRUE(QSqlQuery{database}.exec("DROP INDEX samples_timestamp"));
+    ASSERT_TRUE(QSqlQuery{database}.exec(
+        "CREATE INDEX samples_value ON samples (value)"));
+  }
+  QSqlDatabase::removeDatabase("writer");
+
+  ASSERT_TRUE(data_source.Open(path_));
+  EXPECT_EQ(count_indexes(), 2);
+}
+
+TEST_F(SqliteDataSourceTest, MissingTable) {
+  SqliteDataSource data_source;
+  EXPECT_FALSE(data_source.Open(path_, {.name = "missing"}));
+  EXPECT_FALSE(data_source.is_open());
+  EXPECT_FALSE(data_source.EnumPoints(0, 100, true, true));
+}
+
+}  // namespace views
@@ -0,0 +1,219 @@
+#include "graph_qt/model/summarized_data_source.h"
+
+#include "graph_qt/model/point_enumerators.h"
+#include "graph_qt/model/summary_sidecar.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <optional>
+
+namespace views {
+
+SummarizedDataSource::SummarizedDataSource(GraphDataSource& source,
+                                           SummarySidecar& sidecar)
+    : source_{source}, sidecar_{sidecar} {
+  source_.SetObserver(this);
+}
+
+SummarizedDataSource::~SummarizedDataSource() {
+  source_.SetObserver(nullptr);
+}
+
+double SummarizedDataSource::GetCurrentValue() const {
+  return source_.GetCurrentValue();
+}
+
+std::unique_ptr<PointEnumerator> SummarizedDataSource::EnumPoints(
+    double from,
+    double to,
+    bool include_left_bound,
+    bool include_right_bound) {
+  return source_.EnumPoints(from, to, include_left_bound, include_right_bound);
+}
+
+std::unique_ptr<PointEnumerator> SummarizedDataSource::EnumReducedPoints(
+    double from,
+    double to,
+    double resolution) {
+  // Use the coarsest level whose buckets are narrower than a pixel column on
+  // average.
+  auto range = source_.GetHorizontalRange();
+  std::optional<size_t> level;
+  if (sidecar_.point_count() != 0) {
+    double bucket_width =
+        range.delta() / sidecar_.point_count() * sidecar_.bucket_size();
+    for (size_t i = 0; i < sidecar_.level_count() && bucket_width <= resolution;
+         ++i) {
+      level = i;
+      bucket_width *= SummarySidecar::kFanout;
+    }
+  }
+
+  if (!level) {
+    return source_.EnumReducedPoints(from, to, resolution);
+  }
+  return EnumSummaryPoints(*level, from, to, true, true);
+}
+
+std::unique_ptr<PointEnumerator> SummarizedDataSource::EnumSummaryPoints(
+    size_t level,
+    double from,
+    double to,
+    bool include_left_bound,
+    bool include_right_bound) const {
+  auto is_after_from = [&](double x) {
+    return include_left_bound ? x >= from : x > from;
+  };
+  auto is_before_to = [&](double x) {
+    return include_right_bound ? x <= to : x < to;
+  };
+
+  // The run of buckets inside the range.
+  auto buckets = sidecar_.level(level);
+  auto first_bucket = std::ranges::partition_point(
+      buckets, [&](const auto& b) { return !is_after_from(b.first_x); });
+  auto last_bucket = std::ranges::partition_point(
+      buckets, [&](const auto& b) { return is_before_to(b.last_x); });
+  size_t first = first_bucket - buckets.begin();
+  size_t last = last_bucket - buckets.begin();
+  // Points sharing the x of a boundary may be in both neighbour buckets, so
+  // such buckets are left to the ends.
+  while (first < last && first > 0 &&
+         buckets[first - 1].last_x == buckets[first].first_x) {
+    ++first;
+  }
+  while (last > first && last < buckets.size() &&
+         buckets[last].first_x == buckets[last - 1].last_x) {
+    --last;
+  }
+
+  auto enum_ends = [&](double from, double to, bool include_left_bound,
+                       bool include_right_bound) {
+    return level == 0
+               ? source_.EnumPoints(from, to, include_left_bound,
+                                    include_right_bound)
+               : EnumSummaryPoints(level - 1, from, to, include_left_bound,
+                                   include_right_bound);
+  };
+
+  if (first >= last) {
+    return enum_ends(from, to, include_left_bound, include_right_bound);
+  }
+
+  std::vector<GraphPoint> points;
+  for (const auto& bucket : buckets.subspan(first, last - first)) {
+    auto bucket_points = bucket.GetPoints();
+    points.insert(points.end(), bucket_points.begin(), bucket_points.end());
+  }
+
+  std::vector<std::unique_ptr<PointEnumerator>> parts;
+  if (auto head = enum_ends(from, buckets[first].first_x, include_left_bound,
+                            false)) {
+    parts.push_back(std::move(head));
+  }
+  parts.push_back(std::make_unique<VectorPointEnumerator>(std::move(points)));
+  if (auto tail = enum_ends(buckets[last - 1].last_x, to, false,
+                            include_right_bound)) {
+    parts.push_back(std::move(tail));
+  }
+  return std::make_unique<ConcatPointEnumerator>(std::move(parts));
+}
+
+QString SummarizedDataSource::GetYAxisLabel(double value) const {
+  return source_.GetYAxisLabel(value);
+}
+
+GraphRange SummarizedDataSource::GetHorizontalRange() const {
+  return source_.GetHorizontalRange();
+}
+
+GraphRange SummarizedDataSource::GetVerticalRange() const {
+  return source_.GetVerticalRange();
+}
+
+std::optional<GraphRange> SummarizedDataSource::QueryVerticalRange(
+    double x1,
+    double x2) const {
+  if (sidecar_.level_count() == 0) {
+    return source_.QueryVerticalRange(x1, x2);
+  }
+
+  // The bucket points include the extremes.
+  auto point_enum =
+      EnumSummaryPoints(sidecar_.level_count() - 1, x1, x2, true, false);
+  if (!point_enum) {
+    return GraphRange{};
+  }
+
+  double low = std::numeric_limits<double>::max();
+  double high = std::numeric_limits<double>::lowest();
+  ForEachColumns(*point_enum, [&](const PointColumnSpans& columns) {
+    for (GraphValue y : columns.y) {
+      low = std::min(low, y);
+      high = std::max(high, y);
+    }
+  });
+  if (low > high) {
+    return GraphRange{};
+  }
+  return GraphRange{low, high};
+}
+
+std::optional<GraphStatistics> SummarizedDataSource::QueryStatistics(
+    double x1,
+    double x2) const {
+  return source_.QueryStatistics(x1, x2);
+}
+
+std::optional<size_t> SummarizedDataSource::LowerBound(double value) const {
+  return source_.LowerBound(value);
+}
+
+std::optional<size_t> SummarizedDataSource::UpperBound(double value) const {
+  return source_.UpperBound(value);
+}
+
+std::optional<double> SummarizedDataSource::GetPointX(size_t index) const {
+  return source_.GetPointX(index);
+}
+
+void SummarizedDataSource::OnDataSourceHistoryChanged() {
+  sidecar_.Rebuild(source_);
+  if (observer_) {
+    observer_->OnDataSourceHistoryChanged();
+  }
+}
+
+void SummarizedDataSource::OnDataSourcePointsAppended() {
+  // A source of fixed capacity may have evicted its oldest points.
+  if (sidecar_.point_count() != 0) {
+    sidecar_.Trim(source_.GetHorizontalRange().low());
+  }
+  sidecar_.Update(source_);
+  if (observer_) {
+    observer_->OnDataSourcePointsAppended();
+  }
+}
+
+void SummarizedDataSource::OnDataSourceCurrentValueChanged() {
+  if (observer_) {
+    observer_->OnDataSourceCurrentValueChanged();
+  }
+}
+
+void SummarizedDataSource::OnDataSourceItemChanged() {
+  // The source may now give other points.
+  sidecar_.Rebuild(source_);
+  if (observer_) {
+    observer_->OnDataSourceItemChanged();
+  }
+}
+
+void SummarizedDataSource::OnDataSourceDeleted() {
+  if (observer_) {
+    observer_->OnDataSourceDeleted();
+  }
+}
+
+}  // namespace views
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "graph_qt/model/graph_data_source.h"
+
+namespace views {
+
+class SummarySidecar;
+
+// Data source attaching a `SummarySidecar` to any other source. Zoomed-out
+// enumeration and vertical range queries read the summary level matching the
+// resolution, and the wrapped source only for the few points at the ends of
+// the range that no bucket covers. Everything else is forwarded.
+//
+// Appended points are summarized as they arrive, the buckets of points
+// evicted by a source of fixed capacity are dropped, and the summary is
+// rebuilt when the history or the item of the source changes. The wrapped
+// source and the sidecar must outlive this source.
+class SummarizedDataSource : public GraphDataSource,
+                             private GraphDataSource::Observer {
+ public:
+  SummarizedDataSource(GraphDataSource& source, SummarySidecar& sidecar);
+  ~SummarizedDataSource() override;
+
+  // GraphDataSource
+  double GetCurrentValue() const override;
+  std::unique_ptr<PointEnumerator> EnumPoints(
+      double from,
+      double to,
+      bool include_left_bound,
+      bool include_right_bound) override;
+  std::unique_ptr<PointEnumerator> EnumReducedPoints(
+      double from,
+      double to,
+      double resolution) override;
+  QString GetYAxisLabel(double value) const override;
+  GraphRange GetHorizontalRange() const override;
+  GraphRange GetVerticalRange() const override;
+  std::optional<GraphRange> QueryVerticalRange(double x1,
+                                               double x2) const override;
+  std::optional<GraphStatistics> QueryStatistics(double x1,
+                                                 double x2) const override;
+  std::optional<size_t> LowerBound(double value) const override;
+  std::optional<size_t> UpperBound(double value) const override;
+  std::optional<double> GetPointX(size_t index) const override;
+
+ private:
+  // Enumerates the points of the range, with the buckets of summary `level`
+  // and finer levels inside the range replaced by their points.
+  std::unique_ptr<PointEnumerator> EnumSummaryPoints(
+      size_t level,
+      double from,
+      double to,
+      bool include_left_bound,
+      bool include_right_bound) const;
+
+  // GraphDataSource::Observer
+  void OnDataSourceHistoryChanged() override;
+  void OnDataSourcePointsAppended() override;
+  void OnDataSourceCurrentValueChanged() override;
+  void OnDataSourceItemChanged() override;
+  void OnDataSourceDeleted() override;
+
+  GraphDataSource& source_;
+  SummarySidecar& sidecar_;
+};
+
+}  // namespace views
@@ -0,0 +1,161 @@
+#include "graph_qt/model/summarized_data_source.h"
+
+#include "graph_qt/model/pyramid_data_source.h"
+#include "graph_qt/model/ring_buffer_data_source.h"
+#include "graph_qt/model/summary_sidecar.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace views {
+
+namespace {
+
+std::vector<GraphPoint> MakePoints(size_t count) {
+  std::vector<GraphPoint> points;
+  for (size_t i = 0; i < count; ++i) {
+    points.emplace_back(static_cast<double>(i),
+                        std::sin(i / 50.0) * 100 + (i % 13));
+  }
+  return points;
+}
+
+std::vector<GraphPoint> EnumAllPoints(
+    std::unique_ptr<PointEnumerator> point_enum) {
+  std::vector<GraphPoint> points;
+  if (point_enum) {
+    ForEachPoint(*point_enum,
+                 [&](const GraphPoint& point) { points.push_back(point); });
+  }
+  return points;
+}
+
+// Source switching to the points of another item.
+class ItemDataSource : public PyramidDataSource {
+ public:
+  void ChangeItem(std::span<const GraphPoint> points) {
+    auto* observer = std::exchange(observer_, nullptr);
+    Clear();
+    AddPoints(points);
+    observer_ = observer;
+    observer_->OnDataSourceItemChanged();
+  }
+};
+
+}  // namespace
+
+TEST(SummarizedDataSourceTest, ReducedPointsReadSummary) {
+  PyramidDataSource source;
+  source.AddPoints(MakePoints(100000));
+  SummarySidecar sidecar{/*bucket_size=*/64};
+  sidecar.Rebuild(source);
+  SummarizedDataSource data_source{source, sidecar};
+
+  // Zoomed out, about 4 points per bucket.
+  auto points = EnumAllPoints(data_source.EnumReducedPoints(0, 99999, 1000));
+  EXPECT_LT(points.size(), 100000u / 64 * 4 + 1000);
+  EXPECT_TRUE(std::ranges::is_sorted(points, {}, &GraphPoint::x));
+
+  // Zoomed in, the source's points.
+  EXPECT_EQ(EnumAllPoints(data_source.EnumReducedPoints(100, 110, 0.01)),
+            EnumAllPoints(source.EnumReducedPoints(100, 110, 0.01)));
+}
+
+TEST(SummarizedDataSourceTest, QueryVerticalRange) {
+  PyramidDataSource source;
+  source.AddPoints(MakePoints(100000));
+  SummarySidecar sidecar{64};
+  sidecar.Rebuild(source);
+  SummarizedDataSource data_source{source, sidecar};
+
+  for (auto [x1, x2] : {std::pair{0.0, 100000.0},
+                        {123.0, 45678.0},
+                        {1000.5, 1010.5},
+                        {5.0, 5.0}}) {
+    EXPECT_EQ(data_source.QueryVerticalRange(x1, x2),
+              source.QueryVerticalRange(x1, x2));
+  }
+}
+
+TEST(SummarizedDataSourceTest, SummarizesAppendedPoints) {
+  PyramidDataSource source;
+  SummarySidecar sidecar{64};
+  sidecar.Rebuild(source);
+  SummarizedDataSource data_source{source, sidecar};
+
+  const auto points = MakePoints(1000);
+  for (size_t i = 0; i < points.size(); i += 100) {
+    source.AddPoints(std::span{points}.subspan(i, 100));
+  }
+  EXPECT_EQ(sidecar.point_count(), 1000u);
+  EXPECT_EQ(sidecar.level(0).size(), 16u);
+
+  source.Clear();
+  EXPECT_EQ(sidecar.point_count(), 0u);
+}
+
+TEST(SummarizedDataSourceTest, DropsEvictedBuckets) {
+  RingBufferDataSource source{1000};
+  SummarySidecar sidecar{16};
+  sidecar.Rebuild(source);
+  SummarizedDataSource data_source{source, sidecar};
+
+  const auto points = MakePoints(20000);
+  for (size_t i = 0; i < points.size(); i += 100) {
+    source.AddPoints(std::span{points}.subspan(i, 100));
+
+    // The buckets of evicted points are dropped, not rebuilt.
+    EXPECT_LE(sidecar.point_count(), 1000u);
+    EXPECT_GE(sidecar.point_count() + 16, source.size());
+    for (size_t level = 0; level < sidecar.level_count(); ++level) {
+      uint64_t count = 0;
+      for (const auto& bucket : sidecar.level(level)) {
+        count += bucket.count;
+      }
+      EXPECT_LE(count, sidecar.point_count());
+      EXPECT_GE(count + (16 << (3 * level)), sidecar.point_count());
+    }
+
+    const double low = source.GetHorizontalRange().low();
+    const double high = source.GetHorizontalRange().high();
+    for (auto [x1, x2] : {std::pair{low - 100, high + 1},
+                          {low + 7, high - 300},
+                          {low + 500, low + 530}}) {
+      double y_low = std::numeric_limits<double>::max();
+      double y_high = std::numeric_limits<double>::lowest();
+      for (const auto& point :
+           EnumAllPoints(source.EnumPoints(x1, x2, true, false))) {
+        y_low = std::min(y_low, point.y);
+        y_high = std::max(y_high, point.y);
+      }
+      ASSERT_EQ(data_source.QueryVerticalRange(x1, x2),
+                y_low <= y_high ? GraphRange(y_low, y_high) : GraphRange{})
+          << i << " " << x1 << " " << x2;
+    }
+  }
+  EXPECT_GE(sidecar.level_count(), 3u);
+}
+
+TEST(SummarizedDataSourceTest, RebuildsOnItemChange) {
+  ItemDataSource source;
+  source.AddPoints(MakePoints(1000));
+  SummarySidecar sidecar{64};
+  sidecar.Rebuild(source);
+  SummarizedDataSource data_source{source, sidecar};
+
+  auto points = MakePoints(500);
+  for (auto& point : points) {
+    point.y += 1000;
+  }
+  source.ChangeItem(points);
+  EXPECT_EQ(sidecar.point_count(), 500u);
+  EXPECT_EQ(data_source.QueryVerticalRange(0, 500),
+            source.QueryVerticalRange(0, 500));
+}
+
+}  // namespace views
@@ -0,0 +1,358 @@
+#include "graph_qt/model/summary_sidecar.h"
+
+#include "graph_qt/model/graph_data_source.h"
+
+#include <QFileInfo>
+#include <QSaveFile>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace views {
+
+namespace {
+
+using FileHeader = SummarySidecar::FileHeader;
+
+bool WriteBytes(QFileDevice& file, std::span<const std::byte> bytes) {
+  const auto size = static_cast<qint64>(bytes.size());
+  return file.write(reinterpret_cast<const char*>(bytes.data()), size) == size;
+}
+
+}  // namespace
+
+// SummaryBucket
+
+void SummaryBucket::Add(const GraphPoint& point) {
+  if (count == 0) {
+    first_x = min_x = max_x = point.x;
+    first_y = min_y = max_y = point.y;
+  } else {
+    if (point.y < min_y) {
+      min_x = point.x;
+      min_y = point.y;
+    }
+    if (point.y > max_y) {
+      max_x = point.x;
+      max_y = point.y;
+    }
+  }
+  last_x = point.x;
+  last_y = point.y;
+  ++count;
+  good_count += point.good ? 1 : 0;
+}
+
+void SummaryBucket::Merge(const SummaryBucket& other) {
+  if (other.count == 0) {
+    return;
+  }
+  if (count == 0) {
+    *this = other;
+    return;
+  }
+  if (other.min_y < min_y) {
+    min_x = other.min_x;
+    min_y = other.min_y;
+  }
+  if (other.max_y > max_y) {
+    max_x = other.max_x;
+    max_y = other.max_y;
+  }
+  last_x = other.last_x;
+  last_y = other.last_y;
+  count += other.count;
+  good_count += other.good_count;
+}
+
+std::vector<GraphPoint> SummaryBucket::GetPoints() const {
+  std::vector<GraphPoint> points{{first_x, first_y},
+                                 {min_x, min_y},
+                                 {max_x, max_y},
+                                 {last_x, last_y}};
+  for (auto& point : points) {
+    point.good = good_count == count;
+  }
+  std::ranges::stable_sort(points, {}, &GraphPoint::x);
+  auto [first, last] = std::ranges::unique(points);
+  points.erase(first, last);
+  return points;
+}
+
+// SummarySidecar
+
+SummarySidecar::SummarySidecar(uint32_t bucket_size)
+    : bucket_size_{bucket_size} {}
+
+SummarySidecar::~SummarySidecar() {
+  levels_.clear();
+  Unmap();
+}
+
+bool SummarySidecar::Open(const QString& path,
+                          const QString& data_path,
+                          GraphDataSource& source) {
+  levels_.clear();
+  owned_levels_.clear();
+  Unmap();
+  path_ = path;
+  data_path_ = data_path;
+
+  if (!Map()) {
+    Rebuild(source);
+    return Save();
+  }
+
+  const auto* header = reinterpret_cast<const FileHeader*>(data_);
+  const QFileInfo data_info{data_path_};
+  const auto data_size = static_cast<uint64_t>(data_info.size());
+  if (data_size == header->data_size &&
+      data_info.lastModified().toMSecsSinceEpoch() == header->data_modified) {
+    return true;
+  }
+
+  // A grown file keeps its points, so only the new ones are summarized.
+  if (data_size > header->data_size) {
+    Update(source);
+  } else {
+    Rebuild(source);
+  }
+  return Save();
+}
+
+bool SummarySidecar::Map() {
+  file_.setFileName(path_);
+  if (!file_.open(QIODevice::ReadOnly)) {
+    return false;
+  }
+
+  const auto file_size = static_cast<uint64_t>(file_.size());
+  if (file_size < sizeof(FileHeader) ||
+      !(data_ = file_.map(0, file_.size()))) {
+    Unmap();
+    return false;
+  }
+
+  const auto* header = reinterpret_cast<const FileHeader*>(data_);
+  bool valid = std::memcmp(header->magic, FileHeader::kMagic,
+                           sizeof(header->magic)) == 0 &&
+               header->version == FileHeader::kVersion &&
+               header->bucket_size == bucket_size_ &&
+               header->fanout == kFanout &&
+               header->level_count <= kMaxLevels;
+  for (uint32_t i = 0; valid && i < header->level_count; ++i) {
+    const uint64_t offset = header->level_offsets[i];
+    valid = offset % alignof(SummaryBucket) == 0 && offset <= file_size &&
+            header->level_sizes[i] <=
+                (file_size - offset) / sizeof(SummaryBucket);
+  }
+  if (!valid) {
+    Unmap();
+    return false;
+  }
+
+  point_count_ = header->point_count;
+  tail_x_ = header->tail_x;
+  tail_x_count_ = header->tail_x_count;
+  first_bucket_ = header->first_bucket;
+  levels_.clear();
+  owned_levels_.clear();
+  for (uint32_t i = 0; i < header->level_count; ++i) {
+    levels_.emplace_back(
+        reinterpret_cast<const SummaryBucket*>(data_ +
+                                               header->level_offsets[i]),
+        header->level_sizes[i]);
+  }
+  return true;
+}
+
+void SummarySidecar::Unmap() {
+  if (data_) {
+    file_.unmap(data_);
+    data_ = nullptr;
+  }
+  file_.close();
+}
+
+void SummarySidecar::DetachLevels() {
+  if (owned_levels_.size() == levels_.size()) {
+    return;
+  }
+  owned_levels_.clear();
+  for (const auto& level : levels_) {
+    owned_levels_.emplace_back(level.begin(), level.end());
+  }
+  levels_.assign(owned_levels_.begin(), owned_levels_.end());
+}
+
+void SummarySidecar::Rebuild(GraphDataSource& source) {
+  levels_.clear();
+  owned_levels_.clear();
+  point_count_ = 0;
+  tail_x_count_ = 0;
+  first_bucket_ = 0;
+  Update(source);
+}
+
+void SummarySidecar::Trim(double x) {
+  if (levels_.empty() || levels_[0].empty() ||
+      levels_[0].front().first_x >= x) {
+    return;
+  }
+
+  DetachLevels();
+  auto& buckets = owned_levels_[0];
+  auto first = std::ranges::partition_point(
+      buckets, [&](const SummaryBucket& b) { return b.first_x < x; });
+  // Points of the next buckets with the x of the last dropped point would be
+  // skipped at the ends of ranges.
+  while (first != buckets.end() && first->first_x == std::prev(first)->last_x) {
+    ++first;
+  }
+
+  if (first == buckets.end()) {
+    levels_.clear();
+    owned_levels_.clear();
+    point_count_ = 0;
+    tail_x_count_ = 0;
+    first_bucket_ = 0;
+    return;
+  }
+
+  for (auto i = buckets.begin(); i != first; ++i) {
+    point_count_ -= i->count;
+  }
+  uint64_t old_first = first_bucket_;
+  uint64_t new_first = first_bucket_ + (first - buckets.begin());
+  buckets.erase(buckets.begin(), first);
+  first_bucket_ = new_first;
+
+  // Upper buckets are kept while all their level 0 buckets are.
+  for (size_t level = 1; level < owned_levels_.size(); ++level) {
+    old_first = (old_first + kFanout - 1) / kFanout;
+    new_first = (new_first + kFanout - 1) / kFanout;
+    auto& upper = owned_levels_[level];
+    upper.erase(upper.begin(),
+                upper.begin() + std::min<uint64_t>(new_first - old_first,
+                                                   upper.size()));
+  }
+
+  levels_.assign(owned_levels_.begin(), owned_levels_.end());
+}
+
+void SummarySidecar::Update(GraphDataSource& source) {
+  auto point_enum =
+      point_count_ == 0
+          ? source.EnumPoints(std::numeric_limits<double>::lowest(),
+                              std::numeric_limits<double>::max(), true, true)
+          : source.EnumPoints(tail_x_, std::numeric_limits<double>::max(),
+                              true, true);
+  if (!point_enum) {
+    return;
+  }
+
+  DetachLevels();
+  if (owned_levels_.empty()) {
+    owned_levels_.emplace_back();
+  }
+  auto& buckets = owned_levels_[0];
+  const size_t first_changed_bucket =
+      buckets.empty() ? 0 : buckets.size() - 1;
+
+  // Points at `tail_x_` up to `tail_x_count_` were summarized before.
+  uint64_t skip_count = point_count_ == 0 ? 0 : tail_x_count_;
+  ForEachPoint(*point_enum, [&](const GraphPoint& point) {
+    if (skip_count != 0 && point.x == tail_x_) {
+      --skip_count;
+      return;
+    }
+    skip_count = 0;
+
+    if (buckets.empty() || buckets.back().count == bucket_size_) {
+      buckets.push_back(SummaryBucket{});
+    }
+    buckets.back().Add(point);
+
+    tail_x_count_ = point_count_ != 0 && point.x == tail_x_ ? tail_x_count_ + 1
+                                                           : 1;
+    tail_x_ = point.x;
+    ++point_count_;
+  });
+
+  RebuildUpperLevels(first_changed_bucket);
+}
+
+void SummarySidecar::RebuildUpperLevels(size_t first_changed_bucket) {
+  // Bucket numbers of the first bucket and the first changed one.
+  uint64_t first = first_bucket_;
+  uint64_t first_changed = first_bucket_ + first_changed_bucket;
+  size_t level = 1;
+  for (; level < kMaxLevels && owned_levels_[level - 1].size() > 1; ++level) {
+    if (owned_levels_.size() == level) {
+      owned_levels_.emplace_back();
+    }
+    const auto& lower = owned_levels_[level - 1];
+    auto& upper = owned_levels_[level];
+
+    const uint64_t lower_first = first;
+    first = (first + kFanout - 1) / kFanout;
+    first_changed = std::max(first_changed / kFanout, first);
+    upper.resize(first_changed - first);
+    for (size_t i = first_changed * kFanout - lower_first; i < lower.size();
+         ++i) {
+      if ((lower_first + i) % kFanout == 0) {
+        upper.push_back(SummaryBucket{});
+      }
+      upper.back().Merge(lower[i]);
+    }
+  }
+
+  // Levels above a single bucket are left over from before a trim.
+  owned_levels_.resize(std::min(owned_levels_.size(), level));
+  levels_.assign(owned_levels_.begin(), owned_levels_.end());
+}
+
+bool SummarySidecar::Save() {
+  DetachLevels();
+  Unmap();
+
+  FileHeader header = {};
+  std::memcpy(header.magic, FileHeader::kMagic, sizeof(header.magic));
+  header.version = FileHeader::kVersion;
+  header.bucket_size = bucket_size_;
+  header.fanout = kFanout;
+  header.level_count = static_cast<uint32_t>(owned_levels_.size());
+  const QFileInfo data_info{data_path_};
+  header.data_size = static_cast<uint64_t>(data_info.size());
+  header.data_modified = data_info.lastModified().toMSecsSinceEpoch();
+  header.point_count = point_count_;
+  header.tail_x = tail_x_;
+  header.tail_x_count = tail_x_count_;
+  header.first_bucket = first_bucket_;
+  uint64_t offset = sizeof(header);
+  for (size_t i = 0; i < owned_levels_.size(); ++i) {
+    header.level_offsets[i] = offset;
+    header.level_sizes[i] = owned_levels_[i].size();
+    offset += owned_levels_[i].size() * sizeof(SummaryBucket);
+  }
+
+  // The sidecar is replaced only once it's fully written, so that a crash or
+  // a full disk leaves the previous one intact.
+  QSaveFile file{path_};
+  if (!file.open(QIODevice::WriteOnly) ||
+      !WriteBytes(file, std::as_bytes(std::span{&header, 1}))) {
+    return false;
+  }
+  for (const auto& level : owned_levels_) {
+    if (!WriteBytes(file, std::as_bytes(std::span{level}))) {
+      return false;
+    }
+  }
+  if (!file.commit()) {
+    return false;
+  }
+
+  return Map();
+}
+
+}  // namespace views
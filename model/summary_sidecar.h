@@ -0,0 +1,155 @@
+#pragma once
+
+#include "graph_qt/model/graph_types.h"
+
+#include <QFile>
+#include <QString>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace views {
+
+class GraphDataSource;
+
+// Min/max summary of `count` consecutive points.
+struct SummaryBucket {
+  bool operator==(const SummaryBucket& other) const = default;
+
+  void Add(const GraphPoint& point);
+  void Merge(const SummaryBucket& other);
+
+  // Returns the distinct points among the first, the last and the extremes,
+  // sorted by x. All are good if all summarized points are.
+  std::vector<GraphPoint> GetPoints() const;
+
+  double first_x;
+  double first_y;
+  double last_x;
+  double last_y;
+  // On equal values keeps the first point.
+  double min_x;
+  double min_y;
+  double max_x;
+  double max_y;
+  uint64_t count;
+  uint64_t good_count;
+};
+
+// Multi-resolution summary of the points of a data file, persisted in a
+// sidecar file so that it's built once rather than on every launch. Level 0
+// keeps a bucket per `bucket_size` points, and every next level a bucket per
+// `kFanout` buckets of the previous one.
+//
+// Buckets are numbered from the first point ever summarized, so that the
+// buckets of the oldest points can be dropped when a source of fixed capacity
+// evicts them. A bucket of level `n` with number `i` merges the level 0
+// buckets numbered from `i * kFanout^n`, and is kept only while all of them
+// are.
+//
+// The sidecar is memory-mapped when opened. It records the size and the
+// modification time of the data file: a sidecar of a file that has since
+// grown is updated by summarizing the new points only, and one of a file that
+// has changed otherwise is rebuilt.
+//
+// File layout, little-endian:
+//
+//   SummaryFileHeader
+//   level 0 buckets  level_sizes[0] SummaryBuckets at level_offsets[0]
+//   ...
+class SummarySidecar {
+ public:
+  static constexpr uint32_t kDefaultBucketSize = 1024;
+  static constexpr uint32_t kFanout = 8;
+  static constexpr size_t kMaxLevels = 16;
+
+  struct FileHeader {
+    static constexpr char kMagic[8] = {'G', 'Q', 'T', 'S', 'U', 'M', 0, 0};
+    static constexpr uint32_t kVersion = 2;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t bucket_size;
+    uint32_t fanout;
+    uint32_t level_count;
+    uint64_t data_size;
+    // Milliseconds since the epoch.
+    int64_t data_modified;
+    uint64_t point_count;
+    // The x of the last summarized point, and the number of summarized points
+    // with that x, to resume after them.
+    double tail_x;
+    uint64_t tail_x_count;
+    // Number of the first level 0 bucket.
+    uint64_t first_bucket;
+    uint64_t level_offsets[kMaxLevels];
+    uint64_t level_sizes[kMaxLevels];
+  };
+
+  explicit SummarySidecar(uint32_t bucket_size = kDefaultBucketSize);
+  ~SummarySidecar();
+
+  SummarySidecar(const SummarySidecar&) = delete;
+  SummarySidecar& operator=(const SummarySidecar&) = delete;
+
+  uint32_t bucket_size() const { return bucket_size_; }
+  uint64_t point_count() const { return point_count_; }
+  size_t level_count() const { return levels_.size(); }
+  std::span<const SummaryBucket> level(size_t index) const {
+    return levels_[index];
+  }
+
+  // Opens the sidecar at `path` summarizing the data file at `data_path`,
+  // whose points are enumerated from `source`. Maps the sidecar if it's up to
+  // date, and otherwise updates or rebuilds and saves it. Returns false if the
+  // sidecar can't be saved.
+  bool Open(const QString& path,
+            const QString& data_path,
+            GraphDataSource& source);
+
+  // Summarizes the points appended to `source` since the last update. The
+  // changes stay in memory until `Save()`.
+  void Update(GraphDataSource& source);
+
+  // Summarizes all points of `source` from scratch.
+  void Rebuild(GraphDataSource& source);
+
+  // Drops the buckets holding points before `x`, which a source of fixed
+  // capacity evicted, and the ones sharing the x of their last point. The
+  // points of the source before the first bucket are left unsummarized.
+  // Evicted points with the x of the oldest point left can't be told apart,
+  // and stay summarized.
+  void Trim(double x);
+
+  // Writes the summary to a temporary file, replaces the sidecar with it and
+  // maps it again.
+  bool Save();
+
+ private:
+  bool Map();
+  void Unmap();
+
+  // Copies the mapped levels to memory before they are modified.
+  void DetachLevels();
+
+  void RebuildUpperLevels(size_t first_changed_bucket);
+
+  const uint32_t bucket_size_;
+
+  QString path_;
+  QString data_path_;
+
+  QFile file_;
+  uchar* data_ = nullptr;
+
+  uint64_t point_count_ = 0;
+  double tail_x_ = 0;
+  uint64_t tail_x_count_ = 0;
+  uint64_t first_bucket_ = 0;
+
+  // Views of the mapped levels, or of `owned_levels_` once modified.
+  std::vector<std::span<const SummaryBucket>> levels_;
+  std::vector<std::vector<SummaryBucket>> owned_levels_;
+};
+
+}  // namespace views
@@ -0,0 +1,112 @@
+#include "graph_qt/model/summary_sidecar.h"
+
+#include "graph_qt/model/column_file.h"
+#include "graph_qt/model/column_file_data_source.h"
+
+#include <QTemporaryDir>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+namespace views {
+
+namespace {
+
+PointColumns MakeColumns(size_t count) {
+  PointColumns columns;
+  for (size_t i = 0; i < count; ++i) {
+    columns.push_back(static_cast<double>(i / 3),
+                      static_cast<double>((i * 7919) % 1000), true);
+  }
+  return columns;
+}
+
+class SummarySidecarTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.isValid());
+    data_path_ = temp_dir_.filePath("points.gqc");
+    sidecar_path_ = temp_dir_.filePath("points.gqc.summary");
+  }
+
+  // Writes the data file and opens the sidecar for it.
+  void OpenSidecar(SummarySidecar& sidecar, const PointColumns& columns) {
+    data_source_.Close();
+    ASSERT_TRUE(WriteColumnFile(data_path_, columns.GetSpans()));
+    ASSERT_TRUE(data_source_.Open(data_path_));
+    ASSERT_TRUE(sidecar.Open(sidecar_path_, data_path_, data_source_));
+  }
+
+  QTemporaryDir temp_dir_;
+  QString data_path_;
+  QString sidecar_path_;
+  ColumnFileDataSource data_source_;
+};
+
+}  // namespace
+
+TEST_F(SummarySidecarTest, BuildsLevels) {
+  const auto columns = MakeColumns(10000);
+  SummarySidecar sidecar{/*bucket_size=*/16};
+  OpenSidecar(sidecar, columns);
+
+  EXPECT_EQ(sidecar.point_count(), 10000u);
+  ASSERT_GE(sidecar.level_count(), 4u);
+  EXPECT_EQ(sidecar.level(0).size(), 625u);
+  EXPECT_EQ(sidecar.level(1).size(), 79u);
+  EXPECT_EQ(sidecar.level(sidecar.level_count() - 1).size(), 1u);
+
+  const auto& top = sidecar.level(sidecar.level_count() - 1)[0];
+  EXPECT_EQ(top.count, 10000u);
+  EXPECT_EQ(top.min_y, 0);
+  EXPECT_EQ(top.max_y, 999);
+  EXPECT_EQ(top.first_x, 0);
+  EXPECT_EQ(top.last_x, 3333);
+
+  const auto& bucket = sidecar.level(0)[1];
+  EXPECT_EQ(bucket.count, 16u);
+  EXPECT_EQ(bucket.first_x, columns.x()[16]);
+  EXPECT_EQ(bucket.last_x, columns.x()[31]);
+}
+
+TEST_F(SummarySidecarTest, ReopensAndUpdates) {
+  {
+    SummarySidecar sidecar{16};
+    OpenSidecar(sidecar, MakeColumns(5000));
+  }
+
+  // An unchanged data file maps the saved sidecar.
+  {
+    SummarySidecar sidecar{16};
+    ASSERT_TRUE(sidecar.Open(sidecar_path_, data_path_, data_source_));
+    EXPECT_EQ(sidecar.point_count(), 5000u);
+  }
+
+  // A grown data file summarizes the new points only, with the same result
+  // as a rebuild.
+  const auto columns = MakeColumns(12345);
+  SummarySidecar updated{16};
+  OpenSidecar(updated, columns);
+  SummarySidecar rebuilt{16};
+  rebuilt.Rebuild(data_source_);
+
+  ASSERT_EQ(updated.point_count(), 12345u);
+  ASSERT_EQ(updated.level_count(), rebuilt.level_count());
+  for (size_t i = 0; i < updated.level_count(); ++i) {
+    EXPECT_TRUE(std::ranges::equal(updated.level(i), rebuilt.level(i)));
+  }
+}
+
+TEST_F(SummarySidecarTest, RebuildsChangedFile) {
+  {
+    SummarySidecar sidecar{16};
+    OpenSidecar(sidecar, MakeColumns(5000));
+  }
+
+  SummarySidecar sidecar{16};
+  OpenSidecar(sidecar, MakeColumns(100));
+  EXPECT_EQ(sidecar.point_count(), 100u);
+  EXPECT_EQ(sidecar.level(0).size(), 7u);
+}
+
+}  // namespace views
@@ -3,8 +3,12 @@
 #include "graph_qt/model/graph_data_source.h"
 #include "graph_qt/model/graph_types.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstdlib>
+#include <optional>
 #include <span>
+#include <vector>
 
 namespace views {
 
@@ -25,6 +29,13 @@ class TestPointEnumerator : public PointEnumerator {
     return true;
   }
 
+  size_t EnumNextBatch(std::span<GraphPoint> points) override {
+    size_t count = std::min(points.size(), points_.size());
+    std::copy_n(points_.begin(), count, points.begin());
+    points_ = points_.subspan(count);
+    return count;
+  }
+
  private:
   std::span<const GraphPoint> points_;
 };
@@ -43,7 +54,7 @@ class TestDataSource : public GraphDataSource {
 
     if (observer_) {
       observer_->OnDataSourceCurrentValueChanged();
-      observer_->OnDataSourceHistoryChanged();
+      observer_->OnDataSourcePointsAppended();
     }
   }
 
@@ -54,13 +65,33 @@ class TestDataSource : public GraphDataSource {
       double to,
       bool include_left_bound,
       bool include_right_bound) override {
-    return std::make_unique<TestPointEnumerator>(points_);
+    size_t first = *(include_left_bound ? LowerBound(from) : UpperBound(from));
+    size_t last = *(include_right_bound ? UpperBound(to) : LowerBound(to));
+    if (first >= last) {
+      return nullptr;
+    }
+    return std::make_unique<TestPointEnumerator>(
+        std::span{points_}.subspan(first, last - first));
   }
 
   GraphRange GetHorizontalRange() const override {
     return {points_.front().x, points_.back().x};
   }
 
+  std::optional<size_t> LowerBound(double value) const override {
+    return std::ranges::lower_bound(points_, value, {}, &GraphPoint::x) -
+           points_.begin();
+  }
+
+  std::optional<size_t> UpperBound(double value) const override {
+    return std::ranges::upper_bound(points_, value, {}, &GraphPoint::x) -
+           points_.begin();
+  }
+
+  std::optional<double> GetPointX(size_t index) const override {
+    return points_[index].x;
+  }
+
   static const int kInitialCount = 100;
   static const int kXOffset = 1000;
 
@@ -94,6 +125,32 @@ struct VirtualDataset {
     return std::pair{from_index, to_index};
   }
 
+  // Returns the index of the first point with `x >= value`.
+  size_t lower_bound(double value) const {
+    double position = std::ceil((value - horizontal_min_) / step_);
+    if (position <= 0) {
+      return 0;
+    }
+    size_t index = std::min(static_cast<size_t>(position), count_);
+    // Compensate rounding errors.
+    while (index > 0 && at(index - 1).x >= value) {
+      --index;
+    }
+    while (index < count_ && at(index).x < value) {
+      ++index;
+    }
+    return index;
+  }
+
+  // Returns the index of the first point with `x > value`.
+  size_t upper_bound(double value) const {
+    size_t index = lower_bound(value);
+    while (index < count_ && at(index).x <= value) {
+      ++index;
+    }
+    return index;
+  }
+
   double current() const { return value_at(count_ - 1); }
 
   GraphRange horizontal_range() const {
@@ -126,6 +183,15 @@ class VirtualPointEnumerator : public PointEnumerator {
     return true;
   }
 
+  size_t EnumNextBatch(std::span<GraphPoint> points) override {
+    size_t count = std::min(points.size(), last_index_ + 1 - index_);
+    for (size_t i = 0; i < count; ++i) {
+      points[i] = dataset_.at(index_ + i);
+    }
+    index_ += count;
+    return count;
+  }
+
  private:
   const VirtualDataset& dataset_;
   const size_t last_index_;
@@ -141,7 +207,7 @@ class VirtualDataSource : public GraphDataSource {
 
     if (observer_) {
       observer_->OnDataSourceCurrentValueChanged();
-      observer_->OnDataSourceHistoryChanged();
+      observer_->OnDataSourcePointsAppended();
     }
   }
 
@@ -166,6 +232,18 @@ class VirtualDataSource : public GraphDataSource {
     return range;
   }
 
+  std::optional<size_t> LowerBound(double value) const override {
+    return dataset_.lower_bound(value);
+  }
+
+  std::optional<size_t> UpperBound(double value) const override {
+    return dataset_.upper_bound(value);
+  }
+
+  std::optional<double> GetPointX(size_t index) const override {
+    return dataset_.at(index).x;
+  }
+
  protected:
   VirtualDataset& dataset_;
 };